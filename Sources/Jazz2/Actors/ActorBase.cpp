@@ -634,15 +634,11 @@ namespace Jazz2::Actors
 				return true;
 			}
 
-			//PixelData p;
-			uint8_t* p;
 			GraphicResource* res;
 			bool isFacingLeftCurrent;
-			std::int32_t x1, y1, x2, y2, xs, dx, dy, stride;
+			std::int32_t x1, y1, x2, y2, xs, ys, frame;
 			if (perPixel1) {
 				res = res1;
-				p = res->Base->Mask.get();
-
 				isFacingLeftCurrent = GetState(ActorState::IsFacingLeft);
 
 				x1 = (std::int32_t)std::max(inter.L, other->AABBInner.L);
@@ -651,15 +647,10 @@ namespace Jazz2::Actors
 				y2 = (std::int32_t)std::min(inter.B, other->AABBInner.B);
 
 				xs = (std::int32_t)aabb1.L;
-
-				std::int32_t frame1 = std::min(_renderer.CurrentFrame, res->FrameCount - 1);
-				dx = (frame1 % res->Base->FrameConfiguration.X) * res->Base->FrameDimensions.X;
-				dy = (frame1 / res->Base->FrameConfiguration.X) * res->Base->FrameDimensions.Y - (std::int32_t)aabb1.T;
-
+				ys = (std::int32_t)aabb1.T;
+				frame = std::min(_renderer.CurrentFrame, res->FrameCount - 1);
 			} else {
 				res = res2;
-				p = res->Base->Mask.get();
-
 				isFacingLeftCurrent = other->GetState(ActorState::IsFacingLeft);
 
 				x1 = (std::int32_t)std::max(inter.L, AABBInner.L);
@@ -668,23 +659,15 @@ namespace Jazz2::Actors
 				y2 = (std::int32_t)std::min(inter.B, AABBInner.B);
 
 				xs = (std::int32_t)aabb2.L;
-
-				std::int32_t frame2 = std::min(other->_renderer.CurrentFrame, res->FrameCount - 1);
-				dx = (frame2 % res->Base->FrameConfiguration.X) * res->Base->FrameDimensions.X;
-				dy = (frame2 / res->Base->FrameConfiguration.X) * res->Base->FrameDimensions.Y - (std::int32_t)aabb2.T;
+				ys = (std::int32_t)aabb2.T;
+				frame = std::min(other->_renderer.CurrentFrame, res->FrameCount - 1);
 			}
 
-			stride = res->Base->FrameConfiguration.X * res->Base->FrameDimensions.X;
-
-			// Per-pixel collision check
-			for (std::int32_t i = x1; i < x2; i += PerPixelCollisionStep) {
-				for (std::int32_t j = y1; j < y2; j += PerPixelCollisionStep) {
-					std::int32_t i1 = i - xs;
-					if (isFacingLeftCurrent) {
-						i1 = res->Base->FrameDimensions.X - i1 - 1;
-					}
-
-					if (p[((j + dy) * stride) + i1 + dx] > AlphaThreshold) {
+			// Per-pixel collision check, 64 pixels of a row are tested at once
+			for (std::int32_t j = y1; j < y2; j += PerPixelCollisionStep) {
+				for (std::int32_t i = x1; i < x2; i += 64) {
+					std::uint64_t bits = res->Base->GetMaskBits(frame, i - xs, j - ys, isFacingLeftCurrent);
+					if ((bits & GetPerPixelSampleBits(i - x1, x2 - i)) != 0) {
 						return true;
 					}
 				}
@@ -696,34 +679,24 @@ namespace Jazz2::Actors
 			std::int32_t y2 = (std::int32_t)inter.B;
 
 			std::int32_t x1s = (std::int32_t)aabb1.L;
+			std::int32_t y1s = (std::int32_t)aabb1.T;
 			std::int32_t x2s = (std::int32_t)aabb2.L;
+			std::int32_t y2s = (std::int32_t)aabb2.T;
 
 			std::int32_t frame1 = std::min(_renderer.CurrentFrame, res1->FrameCount - 1);
-			std::int32_t dx1 = (frame1 % res1->Base->FrameConfiguration.X) * res1->Base->FrameDimensions.X;
-			std::int32_t dy1 = (frame1 / res1->Base->FrameConfiguration.X) * res1->Base->FrameDimensions.Y - (std::int32_t)aabb1.T;
-			std::int32_t stride1 = res1->Base->FrameConfiguration.X * res1->Base->FrameDimensions.X;
-
 			std::int32_t frame2 = std::min(other->_renderer.CurrentFrame, res2->FrameCount - 1);
-			std::int32_t dx2 = (frame2 % res2->Base->FrameConfiguration.X) * res2->Base->FrameDimensions.X;
-			std::int32_t dy2 = (frame2 / res2->Base->FrameConfiguration.X) * res2->Base->FrameDimensions.Y - (std::int32_t)aabb2.T;
-			std::int32_t stride2 = res2->Base->FrameConfiguration.X * res2->Base->FrameDimensions.X;
-
-			// Per-pixel collision check
-			auto p1 = res1->Base->Mask.get();
-			auto p2 = res2->Base->Mask.get();
-
-			for (std::int32_t i = x1; i < x2; i += PerPixelCollisionStep) {
-				for (std::int32_t j = y1; j < y2; j += PerPixelCollisionStep) {
-					std::int32_t i1 = i - x1s;
-					if (GetState(ActorState::IsFacingLeft)) {
-						i1 = res1->Base->FrameDimensions.X - i1 - 1;
-					}
-					std::int32_t i2 = i - x2s;
-					if (other->GetState(ActorState::IsFacingLeft)) {
-						i2 = res2->Base->FrameDimensions.X - i2 - 1;
-					}
+			bool isFacingLeft1 = GetState(ActorState::IsFacingLeft);
+			bool isFacingLeft2 = other->GetState(ActorState::IsFacingLeft);
 
-					if (p1[((j + dy1) * stride1) + i1 + dx1] > AlphaThreshold && p2[((j + dy2) * stride2) + i2 + dx2] > AlphaThreshold) {
+			// Per-pixel collision check, 64 pixels of a row are tested at once
+			for (std::int32_t j = y1; j < y2; j += PerPixelCollisionStep) {
+				for (std::int32_t i = x1; i < x2; i += 64) {
+					std::uint64_t bits1 = res1->Base->GetMaskBits(frame1, i - x1s, j - y1s, isFacingLeft1);
+					if (bits1 == 0) {
+						continue;
+					}
+					std::uint64_t bits2 = res2->Base->GetMaskBits(frame2, i - x2s, j - y2s, isFacingLeft2);
+					if ((bits1 & bits2 & GetPerPixelSampleBits(i - x1, x2 - i)) != 0) {
 						return true;
 					}
 				}
@@ -773,23 +746,16 @@ namespace Jazz2::Actors
 		std::int32_t y2 = (std::int32_t)std::min(inter.B, aabb.B);
 
 		std::int32_t xs = (std::int32_t)aabbSelf.L;
+		std::int32_t ys = (std::int32_t)aabbSelf.T;
 
-		std::int32_t frame1 = std::min(_renderer.CurrentFrame, res->FrameCount - 1);
-		std::int32_t dx = (frame1 % res->Base->FrameConfiguration.X) * res->Base->FrameDimensions.X;
-		std::int32_t dy = (frame1 / res->Base->FrameConfiguration.X) * res->Base->FrameDimensions.Y - (int)aabbSelf.T;
-		std::int32_t stride = res->Base->FrameConfiguration.X * res->Base->FrameDimensions.X;
-
-		// Per-pixel collision check
-		auto p = res->Base->Mask.get();
-
-		for (std::int32_t i = x1; i < x2; i += PerPixelCollisionStep) {
-			for (std::int32_t j = y1; j < y2; j += PerPixelCollisionStep) {
-				std::int32_t i1 = i - xs;
-				if (GetState(ActorState::IsFacingLeft)) {
-					i1 = res->Base->FrameDimensions.X - i1 - 1;
-				}
+		std::int32_t frame = std::min(_renderer.CurrentFrame, res->FrameCount - 1);
+		bool isFacingLeft = GetState(ActorState::IsFacingLeft);
 
-				if (p[((j + dy) * stride) + i1 + dx] > AlphaThreshold) {
+		// Per-pixel collision check, 64 pixels of a row are tested at once
+		for (std::int32_t j = y1; j < y2; j += PerPixelCollisionStep) {
+			for (std::int32_t i = x1; i < x2; i += 64) {
+				std::uint64_t bits = res->Base->GetMaskBits(frame, i - xs, j - ys, isFacingLeft);
+				if ((bits & GetPerPixelSampleBits(i - x1, x2 - i)) != 0) {
 					return true;
 				}
 			}
@@ -866,17 +832,7 @@ namespace Jazz2::Actors
 		Vector3f yPosIn2 = Vector3f::Zero * transformAToB;
 
 		std::int32_t frame1 = std::min(_renderer.CurrentFrame, res1->FrameCount - 1);
-		std::int32_t dx1 = (frame1 % res1->Base->FrameConfiguration.X) * res1->Base->FrameDimensions.X;
-		std::int32_t dy1 = (frame1 / res1->Base->FrameConfiguration.X) * res1->Base->FrameDimensions.Y;
-		std::int32_t stride1 = res1->Base->FrameConfiguration.X * res1->Base->FrameDimensions.X;
-
 		std::int32_t frame2 = std::min(other->_renderer.CurrentFrame, res2->FrameCount - 1);
-		std::int32_t dx2 = (frame2 % res2->Base->FrameConfiguration.X) * res2->Base->FrameDimensions.X;
-		std::int32_t dy2 = (frame2 / res2->Base->FrameConfiguration.X) * res2->Base->FrameDimensions.Y;
-		std::int32_t stride2 = res2->Base->FrameConfiguration.X * res2->Base->FrameDimensions.X;
-
-		auto p1 = res1->Base->Mask.get();
-		auto p2 = res2->Base->Mask.get();
 
 		for (std::int32_t y1 = 0; y1 < height1; y1 += PerPixelCollisionStep) {
 			Vector3f posIn2 = yPosIn2;
@@ -886,7 +842,7 @@ namespace Jazz2::Actors
 				std::int32_t y2 = (std::int32_t)std::round(posIn2.Y);
 
 				if (x2 >= 0 && x2 < width2 && y2 >= 0 && y2 < height2) {
-					if (p1[((y1 + dy1) * stride1) + x1 + dx1] > AlphaThreshold && p2[((y2 + dy2) * stride2) + x2 + dx2] > AlphaThreshold) {
+					if (res1->Base->IsMaskPixelSet(frame1, x1, y1) && res2->Base->IsMaskPixelSet(frame2, x2, y2)) {
 						return true;
 					}
 				}
@@ -941,11 +897,6 @@ namespace Jazz2::Actors
 		Vector3f yPosInAABB = Vector3f::Zero * transform;
 
 		std::int32_t frame = std::min(_renderer.CurrentFrame, res->FrameCount - 1);
-		std::int32_t dx = (frame % res->Base->FrameConfiguration.X) * res->Base->FrameDimensions.X;
-		std::int32_t dy = (frame / res->Base->FrameConfiguration.X) * res->Base->FrameDimensions.Y;
-		std::int32_t stride = res->Base->FrameConfiguration.X * res->Base->FrameDimensions.X;
-
-		auto p = res->Base->Mask.get();
 
 		for (std::int32_t y1 = 0; y1 < height; y1 += PerPixelCollisionStep) {
 			Vector3f posInAABB = yPosInAABB;
@@ -954,7 +905,7 @@ namespace Jazz2::Actors
 				std::int32_t x2 = (std::int32_t)std::round(posInAABB.X);
 				std::int32_t y2 = (std::int32_t)std::round(posInAABB.Y);
 
-				if (p[((y1 + dy) * stride) + x1 + dx] > AlphaThreshold &&
+				if (res->Base->IsMaskPixelSet(frame, x1, y1) &&
 					x2 >= aabb.L && x2 < aabb.R && y2 >= aabb.T && y2 < aabb.B) {
 					return true;
 				}
@@ -967,6 +918,24 @@ namespace Jazz2::Actors
 		return false;
 	}
 
+	std::uint64_t ActorBase::GetPerPixelSampleBits(std::int32_t offset, std::int32_t length)
+	{
+		// Only every n-th pixel is tested, offset is distance from the first tested pixel in the row
+		constexpr std::uint64_t SampleBits = []() {
+			std::uint64_t bits = 0;
+			for (std::int32_t i = 0; i < 64; i += PerPixelCollisionStep) {
+				bits |= (std::uint64_t(1) << i);
+			}
+			return bits;
+		}();
+
+		std::uint64_t bits = (SampleBits << ((PerPixelCollisionStep - offset % PerPixelCollisionStep) % PerPixelCollisionStep));
+		if (length < 64) {
+			bits &= (std::uint64_t(1) << length) - 1;
+		}
+		return bits;
+	}
+
 	void ActorBase::UpdateAABB()
 	{
 		if ((_state & (ActorState::CollideWithOtherActors | ActorState::CollideWithSolidObjects | ActorState::IsSolidObject)) == ActorState::None) {
@@ -1064,13 +1033,6 @@ namespace Jazz2::Actors
 	{
 		_metadata = ContentResolver::Get().RequestMetadata(path);
 	}
-	
-#if !defined(WITH_COROUTINES)
-	void ActorBase::RequestMetadataAsync(const StringView path)
-	{
-		_metadata = ContentResolver::Get().RequestMetadata(path);
-	}
-#endif
 
 	void ActorBase::UpdateFrozenState(float timeMult)
 	{
@@ -105,6 +105,9 @@ namespace Jazz2::Actors
 		CollideWithSolidObjectsBelow = 0x4000000,
 		/** @brief Ignore solid collisions agains similar objects that have this flag */
 		ExcludeSimilar = 0x8000000,
+
+		/** @brief Emitted lights never change, so they are emitted only once when the actor is added (cannot be changed during object lifetime) */
+		HasStaticLights = 0x10000000,
 	};
 
 	DEFINE_ENUM_OPERATORS(ActorState);
@@ -238,7 +241,6 @@ namespace Jazz2::Actors
 			static std::int32_t NormalizeFrame(std::int32_t frame, std::int32_t min, std::int32_t max);
 		};
 
-		static constexpr std::uint8_t AlphaThreshold = 40;
 		static constexpr float CollisionCheckStep = 0.5f;
 		static constexpr std::int32_t PerPixelCollisionStep = 3;
 		static constexpr std::int32_t AnimationCandidatesCount = 5;
@@ -303,28 +305,18 @@ namespace Jazz2::Actors
 		static void PreloadMetadataAsync(const StringView path);
 		void RequestMetadata(const StringView path);
 
+		/// Same as @ref RequestMetadata(), metadata are always resolved synchronously, so the calling coroutine is never suspended
 #if defined(WITH_COROUTINES)
-		auto RequestMetadataAsync(const StringView path)
+		std::suspend_never RequestMetadataAsync(const StringView path)
 		{
-			struct awaitable {
-				ActorBase* actor;
-				const StringView& path;
-
-				bool await_ready() {
-					return false;
-				}
-				void await_suspend(std::coroutine_handle<> handle) {
-					// TODO: implement async
-					auto metadata = ContentResolver::Get().RequestMetadata(path);
-					actor->_metadata = metadata;
-					handle();
-				}
-				void await_resume() { }
-			};
-			return awaitable{this, path};
+			RequestMetadata(path);
+			return {};
 		}
 #else
-		void RequestMetadataAsync(const StringView path);
+		void RequestMetadataAsync(const StringView path)
+		{
+			RequestMetadata(path);
+		}
 #endif
 
 		constexpr void SetState(ActorState flags) noexcept
@@ -350,6 +342,7 @@ namespace Jazz2::Actors
 
 		bool IsCollidingWithAngled(ActorBase* other);
 		bool IsCollidingWithAngled(const AABBf& aabb);
+		static std::uint64_t GetPerPixelSampleBits(std::int32_t offset, std::int32_t length);
 
 		void RefreshAnimation(bool skipAnimation = false);
 	};
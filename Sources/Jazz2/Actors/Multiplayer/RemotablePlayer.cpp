@@ -9,7 +9,7 @@
 namespace Jazz2::Actors::Multiplayer
 {
 	RemotablePlayer::RemotablePlayer()
-		: _teamId(0), _warpPending(false)
+		: _teamId(0), _warpPending(false), _predictedStates{}, _predictedStatePos(0)
 	{
 	}
 
@@ -26,6 +26,16 @@ namespace Jazz2::Actors::Multiplayer
 	void RemotablePlayer::OnUpdate(float timeMult)
 	{
 		Player::OnUpdate(timeMult);
+
+		if (_correction.X != 0.0f || _correction.Y != 0.0f) {
+			// Prediction error is corrected gradually over several frames, so the player doesn't jump
+			Vector2f step = _correction * std::min(CorrectionPerFrame * timeMult, 1.0f);
+			if (step.SqrLength() < 0.01f) {
+				step = _correction;
+			}
+			MoveInstantly(step, MoveType::Relative);
+			_correction -= step;
+		}
 	}
 
 	void RemotablePlayer::OnWaterSplash(const Vector2f& pos, bool inwards)
@@ -88,6 +98,12 @@ namespace Jazz2::Actors::Multiplayer
 		MoveInstantly(pos, MoveType::Absolute | MoveType::Force);
 		_speed = speed;
 
+		// Position was set by the server, so the previous predictions are no longer valid
+		for (auto& state : _predictedStates) {
+			state.Time = 0;
+		}
+		_correction = Vector2f::Zero;
+
 		if (_warpPending) {
 			_warpPending = false;
 			_trailLastPos = _pos;
@@ -106,6 +122,59 @@ namespace Jazz2::Actors::Multiplayer
 			_levelHandler->HandlePlayerWarped(this, posPrev, WarpFlags::Fast);
 		}
 	}
+
+	void RemotablePlayer::RecordPredictedState(std::uint64_t time)
+	{
+		_predictedStates[_predictedStatePos].Time = time;
+		_predictedStates[_predictedStatePos].Pos = _pos;
+
+		_predictedStatePos++;
+		if (_predictedStatePos >= PredictedStateCount) {
+			_predictedStatePos = 0;
+		}
+	}
+
+	void RemotablePlayer::Reconcile(std::uint64_t time, const Vector2f& serverPos)
+	{
+		if (time == 0 || _warpPending || !_controllable) {
+			return;
+		}
+
+		PredictedState* acked = nullptr;
+		for (auto& state : _predictedStates) {
+			if (state.Time == time) {
+				acked = &state;
+				break;
+			}
+		}
+		if (acked == nullptr) {
+			// The state is too old or it was already invalidated
+			return;
+		}
+
+		Vector2f error = serverPos - acked->Pos;
+		float errorSqr = error.SqrLength();
+		float tolerance = BaseDeviation + _speed.Length() * SpeedDeviationFrames;
+		if (errorSqr <= tolerance * tolerance) {
+			return;
+		}
+
+		if (errorSqr > MaxDeviation * MaxDeviation) {
+			LOGW("Player %i position mismatch by %i pixels, moving to server position", _playerIndex, (std::int32_t)std::sqrt(errorSqr));
+			MoveInstantly(_pos + error, MoveType::Absolute | MoveType::Force);
+			_correction = Vector2f::Zero;
+		} else {
+			_correction += error;
+		}
+
+		// All newer predictions were based on the wrong position too, so they are now considered corrected,
+		// otherwise the same error would be corrected again when they are acknowledged
+		for (auto& state : _predictedStates) {
+			if (state.Time >= time) {
+				state.Pos += error;
+			}
+		}
+	}
 }
 
 #endif
\ No newline at end of file
@@ -19,6 +19,11 @@ namespace Jazz2::Actors::Multiplayer
 		void WarpIn();
 		void MoveRemotely(const Vector2f& pos, const Vector2f& speed);
 
+		/** @brief Remembers the locally predicted position that was sent to the server at the specified time */
+		void RecordPredictedState(std::uint64_t time);
+		/** @brief Compares position acknowledged by the server with the position predicted at the same time and corrects the difference */
+		void Reconcile(std::uint64_t time, const Vector2f& serverPos);
+
 	protected:
 		Task<bool> OnActivatedAsync(const ActorActivationDetails& details) override;
 		bool OnPerish(ActorBase* collider) override;
@@ -29,8 +34,24 @@ namespace Jazz2::Actors::Multiplayer
 		bool FireCurrentWeapon(WeaponType weaponType) override;
 
 	private:
+		struct PredictedState {
+			std::uint64_t Time;
+			Vector2f Pos;
+		};
+
+		static constexpr std::int32_t PredictedStateCount = 32;
+		// Differences below the base deviation (plus distance travelled in a few frames) are caused only by latency
+		static constexpr float BaseDeviation = 4.0f;
+		static constexpr float SpeedDeviationFrames = 4.0f;
+		// Larger differences are not smoothed, the player is moved to the server position immediately
+		static constexpr float MaxDeviation = 128.0f;
+		static constexpr float CorrectionPerFrame = 0.1f;
+
 		std::uint8_t _teamId;
 		bool _warpPending;
+		PredictedState _predictedStates[PredictedStateCount];
+		std::int32_t _predictedStatePos;
+		Vector2f _correction;
 	};
 }
 
@@ -7,7 +7,7 @@
 namespace Jazz2::Actors::Multiplayer
 {
 	RemoteActor::RemoteActor()
-		: _stateBufferPos(0), _lastAnim(AnimState::Idle)
+		: _stateBufferPos(0), _interpolationDelay(DefaultInterpolationDelay), _lastAnim(AnimState::Idle), _stateSeqNum(0), _latestSeqNum(0)
 	{
 	}
 
@@ -30,14 +30,32 @@ namespace Jazz2::Actors::Multiplayer
 	{
 		Clock& c = nCine::clock();
 		std::int64_t now = c.now() * 1000 / c.frequency();
-		std::int64_t renderTime = now - ServerDelay;
+		std::int64_t renderTime = now - _interpolationDelay;
 
 		std::int32_t nextIdx = _stateBufferPos - 1;
 		if (nextIdx < 0) {
 			nextIdx += static_cast<std::int32_t>(arraySize(_stateBuffer));
 		}
 
-		if (renderTime <= _stateBuffer[nextIdx].Time) {
+		if (renderTime > _stateBuffer[nextIdx].Time) {
+			std::int32_t prevIdx = nextIdx - 1;
+			if (prevIdx < 0) {
+				prevIdx += static_cast<std::int32_t>(arraySize(_stateBuffer));
+			}
+
+			// Newer state is late, so continue in the last known direction for a while to hide the gap. It's done only if
+			// the actor was included in the last snapshot, otherwise it's unchanged or culled by the server and no newer state is expected.
+			std::int64_t timeRange = (_stateBuffer[nextIdx].Time - _stateBuffer[prevIdx].Time);
+			std::int64_t extrapolationTime = renderTime - _stateBuffer[nextIdx].Time;
+			if (timeRange > 0 && extrapolationTime <= MaxExtrapolationTime && _stateSeqNum >= _latestSeqNum) {
+				Vector2f velocity = (_stateBuffer[nextIdx].Pos - _stateBuffer[prevIdx].Pos) / (float)timeRange;
+				MoveInstantly(_stateBuffer[nextIdx].Pos + velocity * (float)extrapolationTime, MoveType::Absolute | MoveType::Force);
+			} else {
+				// Blend back to the last known position, so the actor doesn't stay where it was extrapolated to
+				Vector2f diff = _stateBuffer[nextIdx].Pos - _pos;
+				MoveInstantly(_pos + diff * std::min(ExtrapolationBlendBackFactor * timeMult, 1.0f), MoveType::Absolute | MoveType::Force);
+			}
+		} else {
 			std::int32_t prevIdx;
 			while (true) {
 				prevIdx = nextIdx - 1;
@@ -78,10 +96,26 @@ namespace Jazz2::Actors::Multiplayer
 		SetState((GetState() & ~RemotedFlags) | (state & RemotedFlags));
 	}
 
-	void RemoteActor::SyncWithServer(const Vector2f& pos, AnimState anim, float rotation, bool isVisible, bool isFacingLeft, bool animPaused, Actors::ActorRendererType rendererType)
+	void RemoteActor::SetLatestSnapshot(std::uint64_t seqNum)
 	{
-		Clock& c = nCine::clock();
-		std::int64_t now = c.now() * 1000 / c.frequency();
+		_latestSeqNum = seqNum;
+	}
+
+	void RemoteActor::SyncWithServer(std::uint64_t seqNum, std::int64_t time, std::int64_t interpolationDelay, const Vector2f& pos, AnimState anim, float rotation,
+		bool isVisible, bool isFacingLeft, bool animPaused, Actors::ActorRendererType rendererType)
+	{
+		std::int32_t stateBufferPrevPos = _stateBufferPos - 1;
+		if (stateBufferPrevPos < 0) {
+			stateBufferPrevPos += static_cast<std::int32_t>(arraySize(_stateBuffer));
+		}
+
+		if (time <= _stateBuffer[stateBufferPrevPos].Time) {
+			// State is not newer than the last one (e.g., the same actor state was received twice), times must be increasing
+			time = _stateBuffer[stateBufferPrevPos].Time + 1;
+		}
+
+		_interpolationDelay = interpolationDelay;
+		_stateSeqNum = seqNum;
 
 		bool wasVisible = _renderer.isDrawEnabled();
 		_renderer.setDrawEnabled(isVisible);
@@ -98,20 +132,13 @@ namespace Jazz2::Actors::Multiplayer
 
 		if (wasVisible) {
 			// Actor is still visible, enable interpolation
-			_stateBuffer[_stateBufferPos].Time = now;
+			_stateBuffer[_stateBufferPos].Time = time;
 			_stateBuffer[_stateBufferPos].Pos = pos;
 		} else {
 			// Actor was hidden before, reset state buffer to disable interpolation
-			std::int32_t stateBufferPrevPos = _stateBufferPos - 1;
-			if (stateBufferPrevPos < 0) {
-				stateBufferPrevPos += static_cast<std::int32_t>(arraySize(_stateBuffer));
-			}
-
-			std::int64_t renderTime = now - ServerDelay;
-
-			_stateBuffer[stateBufferPrevPos].Time = renderTime;
+			_stateBuffer[stateBufferPrevPos].Time = time - 1;
 			_stateBuffer[stateBufferPrevPos].Pos = pos;
-			_stateBuffer[_stateBufferPos].Time = renderTime;
+			_stateBuffer[_stateBufferPos].Time = time;
 			_stateBuffer[_stateBufferPos].Pos = pos;
 		}
 
@@ -14,7 +14,11 @@ namespace Jazz2::Actors::Multiplayer
 		RemoteActor();
 
 		void AssignMetadata(const StringView& path, AnimState anim, ActorState state);
-		void SyncWithServer(const Vector2f& pos, AnimState anim, float rotation, bool isVisible, bool isFacingLeft, bool animPaused, Actors::ActorRendererType rendererType);
+		/** @brief Adds a state received from the server in snapshot `seqNum`, `time` is server time converted to the local clock */
+		void SyncWithServer(std::uint64_t seqNum, std::int64_t time, std::int64_t interpolationDelay, const Vector2f& pos, AnimState anim, float rotation,
+			bool isVisible, bool isFacingLeft, bool animPaused, Actors::ActorRendererType rendererType);
+		/** @brief Sets the last snapshot received from the server, if it didn't contain the actor, no newer state is expected soon */
+		void SetLatestSnapshot(std::uint64_t seqNum);
 
 	protected:
 		struct StateFrame {
@@ -22,11 +26,17 @@ namespace Jazz2::Actors::Multiplayer
 			Vector2f Pos;
 		};
 
-		static constexpr std::int64_t ServerDelay = 64;
+		static constexpr std::int64_t DefaultInterpolationDelay = 64;
+		// Position is extrapolated only for a short time if no newer state arrives, then the actor returns to the last known position
+		static constexpr std::int64_t MaxExtrapolationTime = 100;
+		static constexpr float ExtrapolationBlendBackFactor = 0.2f;
 
-		StateFrame _stateBuffer[8];
+		StateFrame _stateBuffer[16];
 		std::int32_t _stateBufferPos;
+		std::int64_t _interpolationDelay;
 		AnimState _lastAnim;
+		std::uint64_t _stateSeqNum;
+		std::uint64_t _latestSeqNum;
 
 		Task<bool> OnActivatedAsync(const ActorActivationDetails& details) override;
 		void OnUpdate(float timeMult) override;
@@ -2,6 +2,7 @@
 #include "JJ2Anims.Palettes.h"
 #include "JJ2Block.h"
 #include "AnimSetMapping.h"
+#include "../../nCine/ServiceLocator.h"
 
 #include <Containers/StringConcatenable.h>
 #include <IO/FileSystem.h>
@@ -300,6 +301,7 @@ namespace Jazz2::Compatibility
 		LOGI("Importing animations...");
 
 		AnimSetMapping animMapping = AnimSetMapping::GetAnimMapping(version);
+		SmallVector<PendingFile, 0> pendingFiles;
 
 		for (auto& anim : anims) {
 			if (anim.FrameCount == 0) {
@@ -440,11 +442,14 @@ namespace Jazz2::Compatibility
 			}
 
 			// TODO: Use single channel instead
-			MemoryStream so(16384);
-			WriteImageToStream(so, pixels.get(), sizeX, sizeY, 4, anim, entry);
-			so.Seek(0, SeekOrigin::Begin);
-			bool success = pakWriter.AddFile(so, filename);
-			ASSERT_MSG(success, "Cannot add file to .pak container");
+			auto so = std::make_unique<MemoryStream>(16384);
+			WriteImageToStream(*so, pixels.get(), sizeX, sizeY, 4, anim, entry);
+			so->Seek(0, SeekOrigin::Begin);
+			// Sprites are large, so use the faster compression, it's stored uncompressed if it doesn't pay off
+			pendingFiles.push_back(PendingFile { std::move(filename), std::move(so), PakPreferredCompression::DeflateFast });
+			if (pendingFiles.size() >= MaxPendingFiles) {
+				AddFilesToPak(pakWriter, pendingFiles);
+			}
 
 			/*if (!string.IsNullOrEmpty(data.Name) && !data.SkipNormalMap) {
 				PngWriter normalMap = NormalMapGenerator.FromSprite(img,
@@ -454,6 +459,8 @@ namespace Jazz2::Compatibility
 				normalMap.Save(filename.Replace(".png", ".n.png"));
 			}*/
 		}
+
+		AddFilesToPak(pakWriter, pendingFiles);
 	}
 
 	void JJ2Anims::ImportAudioSamples(PakWriter& pakWriter, JJ2Version version, SmallVectorImpl<SampleSection>& samples)
@@ -465,6 +472,7 @@ namespace Jazz2::Compatibility
 		LOGI("Importing audio samples...");
 
 		AnimSetMapping mapping = AnimSetMapping::GetSampleMapping(version);
+		SmallVector<PendingFile, 0> pendingFiles;
 
 		for (auto& sample : samples) {
 			AnimSetMapping::Entry* entry = mapping.Get(sample.Set, sample.IdInSet);
@@ -480,7 +488,7 @@ namespace Jazz2::Compatibility
 				filename = fs::CombinePath({ "Animations"_s, entry->Category, String(entry->Name + ".wav"_s) });
 			}
 
-			MemoryStream so(16384);
+			auto so = std::make_unique<MemoryStream>(16384);
 
 			// TODO: The modulo here essentially clips the sample to 8- or 16-bit.
 			// There are some samples (at least the Rapier random noise) that at least get reported as 24-bit
@@ -498,30 +506,55 @@ namespace Jazz2::Compatibility
 
 			// Create PCM wave file
 			// Main header
-			so.Write("RIFF", 4);
-			so.WriteValue<std::uint32_t>(36 + sample.DataSize - dataOffset); // File size
-			so.Write("WAVE", 4);
+			so->Write("RIFF", 4);
+			so->WriteValue<std::uint32_t>(36 + sample.DataSize - dataOffset); // File size
+			so->Write("WAVE", 4);
 
 			// Format header
-			so.Write("fmt ", 4);
-			so.WriteValue<std::uint32_t>(16); // Header remainder length
-			so.WriteValue<std::uint16_t>(1); // Format = PCM
-			so.WriteValue<std::uint16_t>(1); // Channels
-			so.WriteValue<std::uint32_t>(sample.SampleRate); // Sample rate
-			so.WriteValue<std::uint32_t>(sample.SampleRate * bytesPerSample); // Bytes per second
-			so.WriteValue<std::uint32_t>(bytesPerSample * 0x00080001);
+			so->Write("fmt ", 4);
+			so->WriteValue<std::uint32_t>(16); // Header remainder length
+			so->WriteValue<std::uint16_t>(1); // Format = PCM
+			so->WriteValue<std::uint16_t>(1); // Channels
+			so->WriteValue<std::uint32_t>(sample.SampleRate); // Sample rate
+			so->WriteValue<std::uint32_t>(sample.SampleRate * bytesPerSample); // Bytes per second
+			so->WriteValue<std::uint32_t>(bytesPerSample * 0x00080001);
 
 			// Payload
-			so.Write("data", 4);
-			so.WriteValue<std::uint32_t>(sample.DataSize - dataOffset); // Payload size
+			so->Write("data", 4);
+			so->WriteValue<std::uint32_t>(sample.DataSize - dataOffset); // Payload size
 			for (std::uint32_t k = dataOffset; k < sample.DataSize; k++) {
-				so.WriteValue<std::uint8_t>((bytesPerSample << 7) ^ sample.Data[k]);
+				so->WriteValue<std::uint8_t>((bytesPerSample << 7) ^ sample.Data[k]);
+			}
+
+			so->Seek(0, SeekOrigin::Begin);
+			pendingFiles.push_back(PendingFile { std::move(filename), std::move(so), PakPreferredCompression::Deflate });
+			if (pendingFiles.size() >= MaxPendingFiles) {
+				AddFilesToPak(pakWriter, pendingFiles);
+			}
+		}
+
+		AddFilesToPak(pakWriter, pendingFiles);
+	}
+
+	void JJ2Anims::AddFilesToPak(PakWriter& pakWriter, SmallVectorImpl<PendingFile>& files)
+	{
+		// Files are compressed in parallel, but they are added in the original order, so the output is deterministic
+		SmallVector<PakWriter::PreparedFile, 0> preparedFiles(files.size());
+		theServiceLocator().GetThreadPool().ParallelFor(0, (std::int32_t)files.size(), 1, [&files, &preparedFiles](std::int32_t begin, std::int32_t end) {
+			for (std::int32_t i = begin; i < end; i++) {
+				PakWriter::PrepareFile(preparedFiles[i], *files[i].Source, files[i].Compression);
+				files[i].Source = nullptr;
 			}
+		});
 
-			so.Seek(0, SeekOrigin::Begin);
-			bool success = pakWriter.AddFile(so, filename, true);
+		for (std::int32_t i = 0; i < (std::int32_t)files.size(); i++) {
+			bool success = pakWriter.AddPreparedFile(preparedFiles[i], files[i].Path);
 			ASSERT_MSG(success, "Cannot add file to .pak container");
+			// Compressed data are not needed anymore once they are written
+			preparedFiles[i] = {};
 		}
+
+		files.clear();
 	}
 
 	void JJ2Anims::WriteImageToFile(const StringView targetPath, const std::uint8_t* data, std::int32_t width, std::int32_t height, std::int32_t channelCount, const AnimSection& anim, AnimSetMapping::Entry* entry)
@@ -8,7 +8,7 @@
 
 #include <Containers/SmallVector.h>
 #include <Containers/StringView.h>
-#include <IO/Stream.h>
+#include <IO/MemoryStream.h>
 #include <IO/PakFile.h>
 
 using namespace Death::Containers;
@@ -28,6 +28,8 @@ namespace Jazz2::Compatibility
 
 	private:
 		static constexpr int32_t AddBorder = 2;
+		// Files are compressed and written in batches, so only a limited number of them is kept in memory at once
+		static constexpr std::size_t MaxPendingFiles = 64;
 
 		struct AnimFrameSection {
 			std::int16_t SizeX, SizeY;
@@ -65,10 +67,19 @@ namespace Jazz2::Compatibility
 			std::uint16_t Multiplier;
 		};
 
+		/** @brief File that is waiting to be compressed and added to the .pak file */
+		struct PendingFile {
+			String Path;
+			std::unique_ptr<MemoryStream> Source;
+			PakPreferredCompression Compression;
+		};
+
 		JJ2Anims();
 
 		static void ImportAnimations(PakWriter& pakWriter, JJ2Version version, SmallVectorImpl<AnimSection>& anims);
 		static void ImportAudioSamples(PakWriter& pakWriter, JJ2Version version, SmallVectorImpl<SampleSection>& samples);
+		/** @brief Compresses pending files in parallel, adds them to the .pak file and clears the list */
+		static void AddFilesToPak(PakWriter& pakWriter, SmallVectorImpl<PendingFile>& files);
 
 		static void WriteImageToFile(const StringView targetPath, const std::uint8_t* data, std::int32_t width, std::int32_t height, std::int32_t channelCount, const AnimSection& anim, AnimSetMapping::Entry* entry);
 		static void WriteImageToStream(Stream& targetStream, const std::uint8_t* data, std::int32_t width, std::int32_t height, std::int32_t channelCount, const AnimSection& anim, AnimSetMapping::Entry* entry);
@@ -51,6 +51,103 @@ static Vector2i GetVector2iFromJson(simdjson_result<T> value, Vector2i defaultVa
 
 namespace Jazz2
 {
+	namespace
+	{
+		/** @brief Animation record of binary metadata cache */
+		struct MetadataCacheAnimation
+		{
+			enum {
+				LoopOnce = 0x01,
+				HasFrameCount = 0x02,
+				HasAnimDuration = 0x04
+			};
+
+			StringView Path;
+			std::uint8_t Flags;
+			std::uint16_t PaletteOffset;
+			std::int32_t FrameOffset;
+			std::int32_t FrameCount;
+			float AnimDuration;
+			std::uint8_t StateCount;
+			const std::uint8_t* States;
+		};
+
+		void WriteStringToCache(Stream& so, StringView value)
+		{
+			// Strings are null-terminated, so they can be used directly from memory-mapped file
+			so.WriteValue<std::uint16_t>((std::uint16_t)value.size());
+			so.Write(value.data(), (std::int32_t)value.size());
+			so.WriteValue<std::uint8_t>(0);
+		}
+
+		StringView ReadStringFromCache(MemoryStream& s)
+		{
+			std::uint16_t length = s.ReadValue<std::uint16_t>();
+			std::int64_t offset = s.GetPosition();
+			if (offset + length + 1 > s.GetSize()) {
+				s.Seek(0, SeekOrigin::End);
+				return {};
+			}
+			s.Seek(length + 1, SeekOrigin::Current);
+			return StringView(reinterpret_cast<const char*>(s.GetBuffer() + offset), length, StringViewFlags::NullTerminated);
+		}
+
+		bool ReadAnimationFromCache(MemoryStream& s, MetadataCacheAnimation& anim)
+		{
+			anim.Flags = s.ReadValue<std::uint8_t>();
+			anim.PaletteOffset = s.ReadValue<std::uint16_t>();
+			anim.FrameOffset = s.ReadValue<std::int32_t>();
+			anim.FrameCount = s.ReadValue<std::int32_t>();
+			anim.AnimDuration = s.ReadValue<float>();
+			anim.StateCount = s.ReadValue<std::uint8_t>();
+
+			std::int64_t offset = s.GetPosition();
+			std::int64_t statesSize = anim.StateCount * sizeof(std::int32_t);
+			if (offset + statesSize > s.GetSize()) {
+				return false;
+			}
+			anim.States = s.GetBuffer() + offset;
+			s.Seek(statesSize, SeekOrigin::Current);
+
+			anim.Path = ReadStringFromCache(s);
+			return !anim.Path.empty();
+		}
+	}
+
+	/** @brief Reusable JSON parser with grow-only padded buffer, every thread has its own instance */
+	struct ContentResolver::JsonParser
+	{
+		ondemand::parser Parser;
+		std::unique_ptr<char[]> Buffer;
+		std::int64_t BufferSize;
+
+		JsonParser() : BufferSize(0) { }
+
+		error_code Parse(ContentResolver& resolver, Stream& s, std::int64_t size, ondemand::document& doc)
+		{
+			std::int64_t requiredSize = size + simdjson::SIMDJSON_PADDING;
+			if (BufferSize < requiredSize) {
+				// Buffer never shrinks, so it's reallocated only a few times in total
+				BufferSize = std::max(requiredSize, BufferSize * 2);
+				Buffer = std::make_unique<char[]>(BufferSize);
+				resolver._jsonAllocations.fetchAdd(1, Atomic32::MemoryModel::RELAXED);
+			}
+
+			s.Read(Buffer.get(), (std::int32_t)size);
+			Buffer[size] = '\0';
+
+			std::size_t prevCapacity = Parser.capacity();
+			error_code error = Parser.iterate(Buffer.get(), size, BufferSize).get(doc);
+			if (Parser.capacity() != prevCapacity) {
+				resolver._jsonAllocations.fetchAdd(1, Atomic32::MemoryModel::RELAXED);
+			}
+
+			resolver._jsonFilesParsed.fetchAdd(1, Atomic32::MemoryModel::RELAXED);
+			resolver._jsonBytesParsed.fetchAdd(size, Atomic64::MemoryModel::RELAXED);
+			return error;
+		}
+	};
+
 	ContentResolver& ContentResolver::Get()
 	{
 		static ContentResolver current;
@@ -58,7 +155,7 @@ namespace Jazz2
 	}
 
 	ContentResolver::ContentResolver()
-		: _isHeadless(false), _isLoading(false), _cachedMetadata(64), _cachedGraphics(256),
+		: _isHeadless(false), _isLoading(false), _cachedMetadata(64), _cachedGraphics(256), _pendingGraphics(64),
 #if defined(WITH_AUDIO)
 			_cachedSounds(192),
 #endif
@@ -73,6 +170,7 @@ namespace Jazz2
 
 	void ContentResolver::Release()
 	{
+		ReleasePendingGraphics();
 		_cachedMetadata.clear();
 		_cachedGraphics.clear();
 #if defined(WITH_AUDIO)
@@ -88,6 +186,33 @@ namespace Jazz2
 		}
 	}
 
+	ContentResolver::LoadStatistics ContentResolver::GetLoadStatistics()
+	{
+		LoadStatistics stats;
+		stats.FilesParsed = _jsonFilesParsed.load(Atomic32::MemoryModel::RELAXED);
+		stats.BytesParsed = _jsonBytesParsed.load(Atomic64::MemoryModel::RELAXED);
+		stats.Allocations = _jsonAllocations.load(Atomic32::MemoryModel::RELAXED);
+		return stats;
+	}
+
+	ContentResolver::JsonParser& ContentResolver::GetJsonParser()
+	{
+		static DEATH_THREAD_LOCAL JsonParser* currentParser = nullptr;
+		if (currentParser == nullptr) {
+			// Parsers are owned by the resolver, so they are released even if a thread exits earlier
+			std::unique_ptr<JsonParser> parser = std::make_unique<JsonParser>();
+			currentParser = parser.get();
+#if defined(WITH_THREADS)
+			_jsonParsersLock.Lock();
+#endif
+			_jsonParsers.push_back(std::move(parser));
+#if defined(WITH_THREADS)
+			_jsonParsersLock.Unlock();
+#endif
+		}
+		return *currentParser;
+	}
+
 	StringView ContentResolver::GetContentPath() const
 	{
 #if defined(DEATH_TARGET_UNIX) || defined(DEATH_TARGET_WINDOWS_RT)
@@ -443,8 +568,30 @@ namespace Jazz2
 
 	void ContentResolver::PreloadMetadataAsync(const StringView path)
 	{
-		// TODO: Reimplement async preloading
-		RequestMetadata(path);
+		String pathNormalized = fs::ToNativeSeparators(path);
+		if (_cachedMetadata.contains(pathNormalized)) {
+			// Already loaded - Mark as referenced
+			RequestMetadata(pathNormalized);
+			return;
+		}
+
+		// Only animation records are read here, graphics are decoded in background and metadata are created later in RequestMetadata()
+		MetadataCache cache;
+		if (!OpenMetadataCache(pathNormalized, cache)) {
+			return;
+		}
+
+		MemoryStream s(cache.Data, cache.Size);
+		s.Seek(MetadataCacheHeaderSize + 2 * sizeof(std::int32_t), SeekOrigin::Begin);
+
+		std::uint16_t animationCount = s.ReadValue<std::uint16_t>();
+		for (std::uint32_t i = 0; i < animationCount; i++) {
+			MetadataCacheAnimation anim;
+			if (!ReadAnimationFromCache(s, anim)) {
+				break;
+			}
+			ScheduleGraphics(anim.Path, anim.PaletteOffset);
+		}
 	}
 
 	Metadata* ContentResolver::RequestMetadata(const StringView path)
@@ -471,33 +618,239 @@ namespace Jazz2
 		}
 
 		// Try to load it
-		auto s = fs::Open(fs::CombinePath({ GetContentPath(), "Metadata"_s, String(pathNormalized + ".res"_s) }), FileAccess::Read);
+		MetadataCache cache;
+		if (!OpenMetadataCache(pathNormalized, cache)) {
+			return nullptr;
+		}
+
+		std::unique_ptr<Metadata> metadata = std::make_unique<Metadata>();
+		metadata->Path = std::move(pathNormalized);
+		metadata->Flags |= MetadataFlags::Referenced;
+
+		MemoryStream s(cache.Data, cache.Size);
+		s.Seek(MetadataCacheHeaderSize, SeekOrigin::Begin);
+
+		std::int32_t boundingBoxX = s.ReadValue<std::int32_t>();
+		std::int32_t boundingBoxY = s.ReadValue<std::int32_t>();
+		metadata->BoundingBox = Vector2i(boundingBoxX, boundingBoxY);
+
+		std::uint16_t animationCount = s.ReadValue<std::uint16_t>();
+		metadata->Animations.reserve(animationCount);
+
+		for (std::uint32_t i = 0; i < animationCount; i++) {
+			MetadataCacheAnimation anim;
+			if (!ReadAnimationFromCache(s, anim)) {
+				break;
+			}
+
+			GraphicResource graphics;
+			graphics.LoopMode = ((anim.Flags & MetadataCacheAnimation::LoopOnce) == MetadataCacheAnimation::LoopOnce
+				? AnimationLoopMode::Once : AnimationLoopMode::Loop);
+
+			graphics.Base = RequestGraphics(anim.Path, anim.PaletteOffset);
+			if (graphics.Base == nullptr) {
+				continue;
+			}
+
+			graphics.FrameOffset = anim.FrameOffset;
+			graphics.AnimDuration = ((anim.Flags & MetadataCacheAnimation::HasAnimDuration) == MetadataCacheAnimation::HasAnimDuration
+				? anim.AnimDuration : graphics.Base->AnimDuration);
+			graphics.FrameCount = ((anim.Flags & MetadataCacheAnimation::HasFrameCount) == MetadataCacheAnimation::HasFrameCount
+				? anim.FrameCount : graphics.Base->FrameCount - graphics.FrameOffset);
+
+			// If no bounding box is provided, use the first sprite
+			if (metadata->BoundingBox == Vector2i(InvalidValue, InvalidValue)) {
+				// TODO: Remove this bounding box reduction
+				metadata->BoundingBox = graphics.Base->FrameDimensions - Vector2i(2, 2);
+			}
+
+			if (anim.StateCount > 0) {
+				for (std::uint32_t j = 0; j < anim.StateCount; j++) {
+					std::int32_t state;
+					std::memcpy(&state, anim.States + j * sizeof(std::int32_t), sizeof(std::int32_t));
+#if defined(DEATH_DEBUG)
+					// Additional checks only for Debug configuration
+					for (const auto& prevAnim : metadata->Animations) {
+						if (prevAnim.State == (AnimState)state) {
+							LOGW("Animation state %u defined twice in file \"%s\"", (std::uint32_t)state, path.data());
+							break;
+						}
+					}
+#endif
+					graphics.State = (AnimState)state;
+					metadata->Animations.push_back(graphics);
+				}
+			} else {
+				graphics.State = AnimState::Default;
+				metadata->Animations.push_back(graphics);
+			}
+		}
+
+		// Animation states must be sorted, so binary search can be used
+		sort(metadata->Animations.begin(), metadata->Animations.end());
+
+		std::uint16_t soundCount = s.ReadValue<std::uint16_t>();
+#if defined(WITH_AUDIO)
+		if (!_isHeadless) {
+			// Don't load sounds in headless mode
+			metadata->Sounds.reserve(soundCount);
+
+			for (std::uint32_t i = 0; i < soundCount; i++) {
+				StringView key = ReadStringFromCache(s);
+				std::uint8_t pathCount = s.ReadValue<std::uint8_t>();
+
+				SoundResource sound;
+				for (std::uint32_t j = 0; j < pathCount; j++) {
+					StringView assetPath = ReadStringFromCache(s);
+					if (assetPath.empty()) {
+						continue;
+					}
+
+					auto it = _cachedSounds.find(String::nullTerminatedView(assetPath));
+					if (it != _cachedSounds.end()) {
+						it->second->Flags |= GenericSoundResourceFlags::Referenced;
+						sound.Buffers.emplace_back(it->second.get());
+					} else {
+						auto s = OpenContentFile(fs::CombinePath("Animations"_s, assetPath));
+						auto res = _cachedSounds.emplace(assetPath, std::make_unique<GenericSoundResource>(std::move(s), assetPath));
+						res.first->second->Flags |= GenericSoundResourceFlags::Referenced;
+						sound.Buffers.emplace_back(res.first->second.get());
+					}
+				}
+
+				if (!key.empty() && !sound.Buffers.empty()) {
+					metadata->Sounds.emplace(key, std::move(sound));
+				}
+			}
+		}
+#else
+		static_cast<void>(soundCount);
+#endif
+
+		return _cachedMetadata.emplace(metadata->Path, std::move(metadata)).first->second.get();
+	}
+
+	bool ContentResolver::OpenMetadataCache(const StringView path, MetadataCache& cache)
+	{
+		String sourcePath = fs::CombinePath({ GetContentPath(), "Metadata"_s, String(path + ".res"_s) });
+		std::int64_t sourceSize = fs::GetFileSize(sourcePath);
+		DateTime sourceModified = fs::GetLastModificationTime(sourcePath);
+		bool canUseCache = (sourceSize > 0 && sourceModified.IsValid());
+
+		String cachePath;
+		if (canUseCache) {
+			cachePath = fs::CombinePath({ GetCachePath(), "Metadata"_s, String(path + ".cache"_s) });
+
+#if defined(DEATH_TARGET_UNIX) || (defined(DEATH_TARGET_WINDOWS) && !defined(DEATH_TARGET_WINDOWS_RT))
+			if (fs::IsReadableFile(cachePath)) {
+				cache.MappedFile = fs::OpenAsMemoryMapped(cachePath, FileAccess::Read);
+				if (cache.MappedFile) {
+					cache.Data = reinterpret_cast<const std::uint8_t*>(cache.MappedFile->data());
+					cache.Size = (std::int64_t)cache.MappedFile->size();
+					if (IsMetadataCacheValid(cache.Data, cache.Size, sourceSize, sourceModified.GetValue())) {
+						return true;
+					}
+					cache.MappedFile = std::nullopt;
+				}
+			}
+#else
+			auto s = fs::Open(cachePath, FileAccess::Read);
+			std::int64_t cacheSize = s->GetSize();
+			if (cacheSize >= MetadataCacheHeaderSize && cacheSize <= 64 * 1024 * 1024) {
+				cache.FileData = std::make_unique<std::uint8_t[]>(cacheSize);
+				s->Read(cache.FileData.get(), cacheSize);
+				cache.Data = cache.FileData.get();
+				cache.Size = cacheSize;
+				if (IsMetadataCacheValid(cache.Data, cache.Size, sourceSize, sourceModified.GetValue())) {
+					return true;
+				}
+				cache.FileData = nullptr;
+			}
+#endif
+		}
+
+		// Cache doesn't exist or it's stale, convert metadata from JSON
+		auto s = fs::Open(sourcePath, FileAccess::Read);
 		auto fileSize = s->GetSize();
 		if (fileSize < 4 || fileSize > 64 * 1024 * 1024) {
 			// 64 MB file size limit
-			return nullptr;
+			return false;
 		}
 
-		auto buffer = std::make_unique<char[]>(fileSize + simdjson::SIMDJSON_PADDING);
-		s->Read(buffer.get(), fileSize);
-		buffer[fileSize] = '\0';
+		cache.ConvertedData = std::make_unique<MemoryStream>(1024);
+		MemoryStream& so = *cache.ConvertedData;
+		so.WriteValue<std::uint64_t>(0x2095A59FF0BFBBEF);	// Signature
+		so.WriteValue<std::uint8_t>(MetadataCacheFile);
+		so.WriteValue<std::uint16_t>(MetadataCacheVersion);
+		so.WriteValue<std::uint8_t>(0x00);				// Flags
+		so.WriteValue<std::int64_t>(sourceSize);
+		so.WriteValue<std::int64_t>(canUseCache ? sourceModified.GetValue() : 0);
+		so.WriteValue<std::uint32_t>(0);				// Total size, it's updated later
+		ConvertMetadataFromJson(path, *s, fileSize, so);
+
+		std::int64_t totalSize = so.GetSize();
+		so.Seek(MetadataCacheHeaderSize - sizeof(std::uint32_t), SeekOrigin::Begin);
+		so.WriteValue<std::uint32_t>((std::uint32_t)totalSize);
+
+		cache.Data = so.GetBuffer();
+		cache.Size = totalSize;
+
+		if (canUseCache) {
+			// Save the converted metadata, so JSON doesn't have to be parsed next time
+			StringView cacheDir = fs::GetDirectoryName(cachePath);
+			if (fs::DirectoryExists(cacheDir) || fs::CreateDirectories(cacheDir)) {
+				auto cacheFile = fs::Open(cachePath, FileAccess::Write);
+				if (cacheFile->IsValid()) {
+					cacheFile->Write(cache.Data, (std::int32_t)cache.Size);
+				}
+			}
+		}
 
-		bool multipleAnimsNoStatesWarning = false;
+		return true;
+	}
 
-		std::unique_ptr<Metadata> metadata = std::make_unique<Metadata>();
-		metadata->Path = std::move(pathNormalized);
-		metadata->Flags |= MetadataFlags::Referenced;
+	bool ContentResolver::IsMetadataCacheValid(const std::uint8_t* data, std::int64_t size, std::int64_t sourceSize, std::int64_t sourceModified)
+	{
+		if (size < MetadataCacheHeaderSize) {
+			return false;
+		}
+
+		MemoryStream s(data, size);
+		std::uint64_t signature = s.ReadValue<std::uint64_t>();
+		std::uint8_t fileType = s.ReadValue<std::uint8_t>();
+		std::uint16_t version = s.ReadValue<std::uint16_t>();
+		s.ReadValue<std::uint8_t>();	// Flags
+		std::int64_t cachedSourceSize = s.ReadValue<std::int64_t>();
+		std::int64_t cachedSourceModified = s.ReadValue<std::int64_t>();
+		std::uint32_t totalSize = s.ReadValue<std::uint32_t>();
+
+		return (signature == 0x2095A59FF0BFBBEF && fileType == MetadataCacheFile && version == MetadataCacheVersion &&
+			cachedSourceSize == sourceSize && cachedSourceModified == sourceModified && totalSize == size);
+	}
+
+	void ContentResolver::ConvertMetadataFromJson(const StringView path, Stream& s, std::int64_t size, Stream& so)
+	{
+		Vector2i boundingBox = Vector2i(InvalidValue, InvalidValue);
+		std::uint16_t animationCount = 0;
+		std::uint16_t soundCount = 0;
+
+		std::int64_t boundingBoxOffset = so.GetPosition();
+		so.WriteValue<std::int32_t>(boundingBox.X);
+		so.WriteValue<std::int32_t>(boundingBox.Y);
+		std::int64_t animationCountOffset = so.GetPosition();
+		so.WriteValue<std::uint16_t>(animationCount);
+
+		bool multipleAnimsNoStatesWarning = false;
 
-		ondemand::parser parser;
 		ondemand::document doc;
-		if (parser.iterate(buffer.get(), fileSize, fileSize + simdjson::SIMDJSON_PADDING).get(doc) == SUCCESS) {
-			metadata->BoundingBox = GetVector2iFromJson(doc["BoundingBox"], Vector2i(InvalidValue, InvalidValue));
+		if (GetJsonParser().Parse(*this, s, size, doc) == SUCCESS) {
+			boundingBox = GetVector2iFromJson(doc["BoundingBox"], Vector2i(InvalidValue, InvalidValue));
 
 			ondemand::object animations;
 			if (doc["Animations"].get(animations) == SUCCESS) {
 				std::size_t count;
-				if (animations.count_fields().get(count) == SUCCESS) {
-					metadata->Animations.reserve(count);
+				if (animations.count_fields().get(count) != SUCCESS) {
+					count = 0;
 				}
 
 				for (auto it : animations) {
@@ -508,15 +861,14 @@ namespace Jazz2
 						continue;
 					}
 
-					GraphicResource graphics;
-					graphics.LoopMode = AnimationLoopMode::Loop;
+					std::uint8_t animFlags = 0;
 
 					//bool keepIndexed = false;
 
 					std::uint64_t flags;
 					if (value["Flags"].get(flags) == SUCCESS) {
 						if ((flags & 0x01) == 0x01) {
-							graphics.LoopMode = AnimationLoopMode::Once;
+							animFlags |= MetadataCacheAnimation::LoopOnce;
 						}
 						//if ((flags & 0x02) == 0x02) {
 						//	keepIndexed = true;
@@ -529,120 +881,115 @@ namespace Jazz2
 						paletteOffset = 0;
 					}
 
-					graphics.Base = RequestGraphics(assetPath, (uint16_t)paletteOffset);
-					if (graphics.Base == nullptr) {
-						continue;
-					}
-
 					std::int64_t frameOffset;
 					if (value["FrameOffset"].get(frameOffset) != SUCCESS) {
 						frameOffset = 0;
 					}
-					graphics.FrameOffset = (int32_t)frameOffset;
-
-					graphics.AnimDuration = graphics.Base->AnimDuration;
-					graphics.FrameCount = graphics.Base->FrameCount;
 
 					std::int64_t frameCount;
 					if (value["FrameCount"].get(frameCount) == SUCCESS) {
-						graphics.FrameCount = (int32_t)frameCount;
+						animFlags |= MetadataCacheAnimation::HasFrameCount;
 					} else {
-						graphics.FrameCount -= graphics.FrameOffset;
+						frameCount = 0;
 					}
 
 					// TODO: Use AnimDuration instead
+					float animDuration = 0.0f;
 					double frameRate;
 					if (value["FrameRate"].get(frameRate) == SUCCESS) {
-						graphics.AnimDuration = (frameRate <= 0 ? -1.0f : (1.0f / (float)frameRate) * 5.0f);
-					}
-
-					// If no bounding box is provided, use the first sprite
-					if (metadata->BoundingBox == Vector2i(InvalidValue, InvalidValue)) {
-						// TODO: Remove this bounding box reduction
-						metadata->BoundingBox = graphics.Base->FrameDimensions - Vector2i(2, 2);
+						animFlags |= MetadataCacheAnimation::HasAnimDuration;
+						animDuration = (frameRate <= 0 ? -1.0f : (1.0f / (float)frameRate) * 5.0f);
 					}
 
-					ondemand::array states;
-					if (value["States"].get(states) == SUCCESS) {
-						for (auto stateItem : states) {
+					SmallVector<std::int32_t, 8> states;
+					ondemand::array statesArray;
+					if (value["States"].get(statesArray) == SUCCESS) {
+						for (auto stateItem : statesArray) {
 							std::int64_t state;
 							if (stateItem.get(state) == SUCCESS) {
-#if defined(DEATH_DEBUG)
-								// Additional checks only for Debug configuration
-								for (const auto& anim : metadata->Animations) {
-									if (anim.State == (AnimState)state) {
-										LOGW("Animation state %u defined twice in file \"%s\"", (std::uint32_t)state, path.data());
-										break;
-									}
-								}
-#endif
-								graphics.State = (AnimState)state;
-								metadata->Animations.push_back(graphics);
+								states.push_back((std::int32_t)state);
 							}
 						}
+						if (states.empty()) {
+							// No valid state specified, so the animation would be never used
+							continue;
+						}
 					} else if (count > 1) {
 						if (!multipleAnimsNoStatesWarning) {
 							multipleAnimsNoStatesWarning = true;
-							LOGW("Multiple animations defined but no states specified in file \"%s\"", path.data());
+							LOGW("Multiple animations defined but no states specified in file \"%s\"", String::nullTerminatedView(path).data());
 						}
-					} else {
-						graphics.State = AnimState::Default;
-						metadata->Animations.push_back(graphics);
+						continue;
 					}
-				}
 
-				// Animation states must be sorted, so binary search can be used
-				sort(metadata->Animations.begin(), metadata->Animations.end());
+					so.WriteValue<std::uint8_t>(animFlags);
+					so.WriteValue<std::uint16_t>((std::uint16_t)paletteOffset);
+					so.WriteValue<std::int32_t>((std::int32_t)frameOffset);
+					so.WriteValue<std::int32_t>((std::int32_t)frameCount);
+					so.WriteValue<float>(animDuration);
+					so.WriteValue<std::uint8_t>((std::uint8_t)states.size());
+					if (!states.empty()) {
+						so.Write(states.data(), (std::int32_t)(states.size() * sizeof(std::int32_t)));
+					}
+					WriteStringToCache(so, fs::ToNativeSeparators(assetPath));
+					animationCount++;
+				}
 			}
 
-#if defined(WITH_AUDIO)
-			if (!_isHeadless) {
-				// Don't load sounds in headless mode
-				ondemand::object sounds;
-				if (doc["Sounds"].get(sounds) == SUCCESS) {
-					std::size_t count;
-					if (sounds.count_fields().get(count) == SUCCESS) {
-						metadata->Sounds.reserve(count);
-					}
+			// Sounds are always included, even if they are not loaded in headless mode
+			ondemand::object sounds;
+			if (doc["Sounds"].get(sounds) == SUCCESS) {
+				std::int64_t soundCountOffset = so.GetPosition();
+				so.WriteValue<std::uint16_t>(soundCount);
 
-					for (auto it : sounds) {
-						std::string_view key;
-						ondemand::object value;
-						ondemand::array assetPaths;
-						bool isEmpty;
-						if (it.unescaped_key().get(key) != SUCCESS || it.value().get(value) != SUCCESS || key.empty() ||
-							value["Paths"].get(assetPaths) != SUCCESS || assetPaths.is_empty().get(isEmpty) != SUCCESS || isEmpty) {
-							continue;
-						}
+				for (auto it : sounds) {
+					std::string_view key;
+					ondemand::object value;
+					ondemand::array assetPaths;
+					bool isEmpty;
+					if (it.unescaped_key().get(key) != SUCCESS || it.value().get(value) != SUCCESS || key.empty() ||
+						value["Paths"].get(assetPaths) != SUCCESS || assetPaths.is_empty().get(isEmpty) != SUCCESS || isEmpty) {
+						continue;
+					}
 
-						SoundResource sound;
-						for (auto assetPathItem : assetPaths) {
-							std::string_view assetPath;
-							if (assetPathItem.get(assetPath) == SUCCESS && !assetPath.empty()) {
-								auto assetPathNormalized = fs::ToNativeSeparators(assetPath);
-								auto it = _cachedSounds.find(assetPathNormalized);
-								if (it != _cachedSounds.end()) {
-									it->second->Flags |= GenericSoundResourceFlags::Referenced;
-									sound.Buffers.emplace_back(it->second.get());
-								} else {
-									auto s = OpenContentFile(fs::CombinePath("Animations"_s, assetPathNormalized));
-									auto res = _cachedSounds.emplace(assetPathNormalized, std::make_unique<GenericSoundResource>(std::move(s), assetPathNormalized));
-									res.first->second->Flags |= GenericSoundResourceFlags::Referenced;
-									sound.Buffers.emplace_back(res.first->second.get());
-								}
-							}
+					SmallVector<String, 4> paths;
+					for (auto assetPathItem : assetPaths) {
+						std::string_view assetPath;
+						if (assetPathItem.get(assetPath) == SUCCESS && !assetPath.empty()) {
+							paths.push_back(fs::ToNativeSeparators(assetPath));
 						}
+					}
+					if (paths.empty()) {
+						continue;
+					}
 
-						if (!sound.Buffers.empty()) {
-							metadata->Sounds.emplace(key, std::move(sound));
-						}
+					WriteStringToCache(so, key);
+					so.WriteValue<std::uint8_t>((std::uint8_t)paths.size());
+					for (const auto& assetPath : paths) {
+						WriteStringToCache(so, assetPath);
 					}
+					soundCount++;
 				}
+
+				std::int64_t endOffset = so.GetPosition();
+				so.Seek(soundCountOffset, SeekOrigin::Begin);
+				so.WriteValue<std::uint16_t>(soundCount);
+				so.Seek(endOffset, SeekOrigin::Begin);
+			} else {
+				so.WriteValue<std::uint16_t>(soundCount);
 			}
-#endif
+		} else {
+			so.WriteValue<std::uint16_t>(soundCount);
 		}
 
-		return _cachedMetadata.emplace(metadata->Path, std::move(metadata)).first->second.get();
+		// Update values that weren't known at the beginning
+		std::int64_t endOffset = so.GetPosition();
+		so.Seek(boundingBoxOffset, SeekOrigin::Begin);
+		so.WriteValue<std::int32_t>(boundingBox.X);
+		so.WriteValue<std::int32_t>(boundingBox.Y);
+		so.Seek(animationCountOffset, SeekOrigin::Begin);
+		so.WriteValue<std::uint16_t>(animationCount);
+		so.Seek(endOffset, SeekOrigin::Begin);
 	}
 
 	GenericGraphicResource* ContentResolver::RequestGraphics(const StringView path, uint16_t paletteOffset)
@@ -658,41 +1005,118 @@ namespace Jazz2
 			return it->second.get();
 		}
 
-		if (fs::GetExtension(pathNormalized) == "aura"_s) {
-			return RequestGraphicsAura(pathNormalized, paletteOffset);
+		auto pendingIt = _pendingGraphics.find(Pair(String::nullTerminatedView(pathNormalized), paletteOffset));
+		if (pendingIt != _pendingGraphics.end()) {
+			// Already loading in background - help with loading until it's finished and then upload it
+			std::unique_ptr<PendingGraphics> pending = std::move(pendingIt->second);
+			_pendingGraphics.erase(pendingIt);
+			theServiceLocator().GetThreadPool().Wait(&pending->LoadJob);
+			return FinalizeGraphics(*pending);
 		}
 
-		auto s = fs::Open(fs::CombinePath({ GetContentPath(), "Animations"_s, String(pathNormalized + ".res"_s) }), FileAccess::Read);
+		std::unique_ptr<PendingGraphics> pending = CreatePendingGraphics(std::move(pathNormalized), paletteOffset);
+		LoadGraphics(*pending);
+		return FinalizeGraphics(*pending);
+	}
+
+	void ContentResolver::FinalizePendingGraphics()
+	{
+		if (_pendingGraphics.empty()) {
+			return;
+		}
+
+		ZoneScopedC(0x888888);
+
+		std::int32_t finalizedCount = 0;
+		auto it = _pendingGraphics.begin();
+		while (it != _pendingGraphics.end() && finalizedCount < MaxGraphicsFinalizedPerCall) {
+			if (it->second->LoadJob.UnfinishedJobs.load(Atomic32::MemoryModel::ACQUIRE) > 0) {
+				++it;
+				continue;
+			}
+
+			FinalizeGraphics(*it->second);
+			it = _pendingGraphics.erase(it);
+			finalizedCount++;
+		}
+	}
+
+	std::unique_ptr<ContentResolver::PendingGraphics> ContentResolver::CreatePendingGraphics(String path, std::uint16_t paletteOffset)
+	{
+		std::unique_ptr<PendingGraphics> pending = std::make_unique<PendingGraphics>();
+		pending->Path = std::move(path);
+		pending->PaletteOffset = paletteOffset;
+		pending->Pixels = nullptr;
+		pending->Width = 0;
+		pending->Height = 0;
+		pending->LinearSampling = false;
+
+		// Palette is copied, so it can be applied in background even if it's changed in the meantime
+		std::int32_t colorCount = std::min(ColorsPerPalette, PaletteCount * ColorsPerPalette - (std::int32_t)paletteOffset);
+		std::memcpy(pending->Palette, _palettes + paletteOffset, colorCount * sizeof(std::uint32_t));
+		std::memset(pending->Palette + colorCount, 0, (ColorsPerPalette - colorCount) * sizeof(std::uint32_t));
+		return pending;
+	}
+
+	void ContentResolver::ScheduleGraphics(const StringView path, std::uint16_t paletteOffset)
+	{
+		// First resources are requested, reset _isLoading flag, because palette should be already applied
+		_isLoading = false;
+
+		auto pathNormalized = fs::ToNativeSeparators(path);
+		auto it = _cachedGraphics.find(Pair(String::nullTerminatedView(pathNormalized), paletteOffset));
+		if (it != _cachedGraphics.end()) {
+			// Already loaded - Mark as referenced
+			it->second->Flags |= GenericGraphicResourceFlags::Referenced;
+			return;
+		}
+		if (_pendingGraphics.contains(Pair(String::nullTerminatedView(pathNormalized), paletteOffset))) {
+			return;
+		}
+
+		std::unique_ptr<PendingGraphics> pending = CreatePendingGraphics(pathNormalized, paletteOffset);
+		PendingGraphics* pendingPtr = pending.get();
+		IThreadPool::InitializeJob(&pendingPtr->LoadJob, [](void* userData, std::int32_t begin, std::int32_t end) {
+			ContentResolver::Get().LoadGraphics(*static_cast<PendingGraphics*>(userData));
+		}, pendingPtr, 0, 0, nullptr);
+
+		_pendingGraphics.emplace(Pair(std::move(pathNormalized), paletteOffset), std::move(pending));
+		theServiceLocator().GetThreadPool().Run(&pendingPtr->LoadJob);
+	}
+
+	void ContentResolver::LoadGraphics(PendingGraphics& pending)
+	{
+		// This function can be called from any thread, so it must not access any cache or GPU resources
+		if (fs::GetExtension(pending.Path) == "aura"_s) {
+			LoadGraphicsAura(pending);
+			return;
+		}
+
+		auto s = fs::Open(fs::CombinePath({ GetContentPath(), "Animations"_s, String(pending.Path + ".res"_s) }), FileAccess::Read);
 		auto fileSize = s->GetSize();
 		if (fileSize < 4 || fileSize > 64 * 1024 * 1024) {
 			// 64 MB file size limit, also if not found try to use cache
-			return nullptr;
+			return;
 		}
 
-		auto buffer = std::make_unique<char[]>(fileSize + simdjson::SIMDJSON_PADDING);
-		s->Read(buffer.get(), fileSize);
-		s->Dispose();
-		buffer[fileSize] = '\0';
-
-		ondemand::parser parser;
 		ondemand::document doc;
-		if (parser.iterate(buffer.get(), fileSize, fileSize + simdjson::SIMDJSON_PADDING).get(doc) == SUCCESS) {
+		if (GetJsonParser().Parse(*this, *s, fileSize, doc) == SUCCESS) {
 			// Try to load it
 			std::unique_ptr<GenericGraphicResource> graphics = std::make_unique<GenericGraphicResource>();
 			graphics->Flags |= GenericGraphicResourceFlags::Referenced;
 
-			String fullPath = fs::CombinePath({ GetContentPath(), "Animations"_s, pathNormalized });
+			String fullPath = fs::CombinePath({ GetContentPath(), "Animations"_s, pending.Path });
 			std::unique_ptr<ITextureLoader> texLoader = ITextureLoader::createFromFile(fullPath);
 			if (texLoader->hasLoaded()) {
 				auto texFormat = texLoader->texFormat().internalFormat();
 				if (texFormat != GL_RGBA8 && texFormat != GL_RGB8) {
-					return nullptr;
+					return;
 				}
 
 				std::int32_t w = texLoader->width();
 				std::int32_t h = texLoader->height();
 				std::uint32_t* pixels = (std::uint32_t*)texLoader->pixels();
-				const std::uint32_t* palette = _palettes + paletteOffset;
+				const std::uint32_t* palette = pending.Palette;
 				bool linearSampling = false;
 				bool needsMask = true;
 
@@ -711,32 +1135,20 @@ namespace Jazz2
 					}
 				}
 
-				if (needsMask) {
-					graphics->Mask = std::make_unique<std::uint8_t[]>(w * h);
+				graphics->FrameDimensions = GetVector2iFromJson(doc["FrameSize"]);
+				graphics->FrameConfiguration = GetVector2iFromJson(doc["FrameConfiguration"]);
 
-					for (std::int32_t i = 0; i < w * h; i++) {
-						// Save original alpha value for collision checking
-						graphics->Mask[i] = ((pixels[i] >> 24) & 0xff);
-						if (palette != nullptr) {
-							std::uint32_t color = palette[pixels[i] & 0xff];
-							pixels[i] = (color & 0xffffff) | ((((color >> 24) & 0xff) * ((pixels[i] >> 24) & 0xff) / 255) << 24);
-						}
-					}
-				} else if (palette != nullptr) {
+				if (needsMask) {
+					// Save original alpha value for collision checking
+					graphics->CreateMask(pixels, w);
+				}
+				if (palette != nullptr) {
 					for (std::int32_t i = 0; i < w * h; i++) {
 						std::uint32_t color = palette[pixels[i] & 0xff];
 						pixels[i] = (color & 0xffffff) | ((((color >> 24) & 0xff) * ((pixels[i] >> 24) & 0xff) / 255) << 24);
 					}
 				}
 
-				if (!_isHeadless) {
-					// Don't load textures in headless mode, only collision masks
-					graphics->TextureDiffuse = std::make_unique<Texture>(fullPath.data(), Texture::Format::RGBA8, w, h);
-					graphics->TextureDiffuse->loadFromTexels((unsigned char*)pixels, 0, 0, w, h);
-					graphics->TextureDiffuse->setMinFiltering(linearSampling ? SamplerFilter::Linear : SamplerFilter::Nearest);
-					graphics->TextureDiffuse->setMagFiltering(linearSampling ? SamplerFilter::Linear : SamplerFilter::Nearest);
-				}
-
 				double animDuration;
 				if (doc["Duration"].get(animDuration) != SUCCESS) {
 					animDuration = 0.0;
@@ -748,32 +1160,32 @@ namespace Jazz2
 					frameCount = 0;
 				}
 				graphics->FrameCount = (std::int32_t)frameCount;
-
-				graphics->FrameDimensions = GetVector2iFromJson(doc["FrameSize"]);
-				graphics->FrameConfiguration = GetVector2iFromJson(doc["FrameConfiguration"]);
 				
 				graphics->Hotspot = GetVector2iFromJson(doc["Hotspot"]);
 				graphics->Coldspot = GetVector2iFromJson(doc["Coldspot"], Vector2i(InvalidValue, InvalidValue));
 				graphics->Gunspot = GetVector2iFromJson(doc["Gunspot"], Vector2i(InvalidValue, InvalidValue));
 
-#if defined(DEATH_DEBUG)
-				MigrateGraphics(pathNormalized);
-#endif
-				return _cachedGraphics.emplace(Pair(String(pathNormalized), paletteOffset), std::move(graphics)).first->second.get();
+				pending.Resource = std::move(graphics);
+				pending.Width = w;
+				pending.Height = h;
+				pending.LinearSampling = linearSampling;
+				if (!_isHeadless) {
+					// Don't keep pixels in headless mode, only collision masks are needed
+					pending.Pixels = pixels;
+					pending.TextureLoader = std::move(texLoader);
+				}
 			}
 		}
-
-		return nullptr;
 	}
 
-	GenericGraphicResource* ContentResolver::RequestGraphicsAura(const StringView path, std::uint16_t paletteOffset)
+	void ContentResolver::LoadGraphicsAura(PendingGraphics& pending)
 	{
-		auto s = OpenContentFile(fs::CombinePath("Animations"_s, path));
+		auto s = OpenContentFile(fs::CombinePath("Animations"_s, pending.Path));
 
 		auto fileSize = s->GetSize();
 		if (fileSize < 16 || fileSize > 64 * 1024 * 1024) {
 			// 64 MB file size limit, also if not found try to use cache
-			return nullptr;
+			return;
 		}
 
 		std::uint64_t signature1 = s->ReadValue<std::uint64_t>();
@@ -782,7 +1194,7 @@ namespace Jazz2
 		std::uint8_t flags = s->ReadValue<std::uint8_t>();
 
 		if (signature1 != 0xB8EF8498E2BFBBEF || signature2 != 0x208F || version != 2 || (flags & 0x80) != 0x80) {
-			return nullptr;
+			return;
 		}
 
 		std::uint8_t channelCount = s->ReadValue<std::uint8_t>();
@@ -806,14 +1218,10 @@ namespace Jazz2
 		std::uint32_t width = frameDimensionsX * frameConfigurationX;
 		std::uint32_t height = frameDimensionsY * frameConfigurationY;
 
-		std::unique_ptr<std::uint32_t[]> pixels = std::make_unique<std::uint32_t[]>(width * height);
-
-		ReadImageFromFile(s, (std::uint8_t*)pixels.get(), width, height, channelCount);
-
 		std::unique_ptr<GenericGraphicResource> graphics = std::make_unique<GenericGraphicResource>();
 		graphics->Flags |= GenericGraphicResourceFlags::Referenced;
 
-		const std::uint32_t* palette = _palettes + paletteOffset;
+		const std::uint32_t* palette = pending.Palette;
 		bool linearSampling = false;
 		bool needsMask = true;
 		if ((flags & 0x01) == 0x01) {
@@ -824,36 +1232,19 @@ namespace Jazz2
 			needsMask = false;
 		}
 
-		if (needsMask) {
-			graphics->Mask = std::make_unique<std::uint8_t[]>(width * height);
+		graphics->FrameDimensions = Vector2i(frameDimensionsX, frameDimensionsY);
+		graphics->FrameConfiguration = Vector2i(frameConfigurationX, frameConfigurationY);
 
-			for (std::uint32_t i = 0; i < width * height; i++) {
-				// Save original alpha value for collision checking
-				graphics->Mask[i] = ((pixels[i] >> 24) & 0xff);
-				if (palette != nullptr) {
-					std::uint32_t color = palette[pixels[i] & 0xff];
-					pixels[i] = (color & 0xffffff) | ((((color >> 24) & 0xff) * ((pixels[i] >> 24) & 0xff) / 255) << 24);
-				}
-			}
-		} else if (palette != nullptr) {
-			for (std::uint32_t i = 0; i < width * height; i++) {
-				std::uint32_t color = palette[pixels[i] & 0xff];
-				pixels[i] = (color & 0xffffff) | ((((color >> 24) & 0xff) * ((pixels[i] >> 24) & 0xff) / 255) << 24);
-			}
+		if (needsMask) {
+			// Original alpha value is saved for collision checking while decoding
+			graphics->InitializeMask();
 		}
 
-		if (!_isHeadless) {
-			// Don't load textures in headless mode, only collision masks
-			graphics->TextureDiffuse = std::make_unique<Texture>(path.data(), Texture::Format::RGBA8, width, height);
-			graphics->TextureDiffuse->loadFromTexels((unsigned char*)pixels.get(), 0, 0, width, height);
-			graphics->TextureDiffuse->setMinFiltering(linearSampling ? SamplerFilter::Linear : SamplerFilter::Nearest);
-			graphics->TextureDiffuse->setMagFiltering(linearSampling ? SamplerFilter::Linear : SamplerFilter::Nearest);
-		}
+		std::unique_ptr<std::uint32_t[]> pixels = std::make_unique<std::uint32_t[]>(width * height);
+		ReadImageFromFile(s, (std::uint8_t*)pixels.get(), width, height, channelCount, palette, needsMask ? graphics.get() : nullptr);
 
 		// AnimDuration is multiplied by 256 before saving, so divide it here back
 		graphics->AnimDuration = animDuration / 256.0f;
-		graphics->FrameDimensions = Vector2i(frameDimensionsX, frameDimensionsY);
-		graphics->FrameConfiguration = Vector2i(frameConfigurationX, frameConfigurationY);
 		graphics->FrameCount = frameCount;
 
 		if (hotspotX != UINT16_MAX || hotspotY != UINT16_MAX) {
@@ -874,10 +1265,60 @@ namespace Jazz2
 			graphics->Gunspot = Vector2i(InvalidValue, InvalidValue);
 		}
 
-		return _cachedGraphics.emplace(Pair(String(path), paletteOffset), std::move(graphics)).first->second.get();
+		pending.Resource = std::move(graphics);
+		pending.Width = (std::int32_t)width;
+		pending.Height = (std::int32_t)height;
+		pending.LinearSampling = linearSampling;
+		if (!_isHeadless) {
+			// Don't keep pixels in headless mode, only collision masks are needed
+			pending.Pixels = pixels.get();
+			pending.OwnedPixels = std::move(pixels);
+		}
+	}
+
+	GenericGraphicResource* ContentResolver::FinalizeGraphics(PendingGraphics& pending)
+	{
+		if (pending.Resource == nullptr) {
+			return nullptr;
+		}
+
+		if (pending.Pixels != nullptr) {
+			// Don't load textures in headless mode, only collision masks
+			auto& graphics = pending.Resource;
+			graphics->TextureDiffuse = std::make_unique<Texture>(pending.Path.data(), Texture::Format::RGBA8, pending.Width, pending.Height);
+			graphics->TextureDiffuse->loadFromTexels((unsigned char*)pending.Pixels, 0, 0, pending.Width, pending.Height);
+			graphics->TextureDiffuse->setMinFiltering(pending.LinearSampling ? SamplerFilter::Linear : SamplerFilter::Nearest);
+			graphics->TextureDiffuse->setMagFiltering(pending.LinearSampling ? SamplerFilter::Linear : SamplerFilter::Nearest);
+
+			// Pixels are not needed anymore
+			pending.Pixels = nullptr;
+			pending.TextureLoader = nullptr;
+			pending.OwnedPixels = nullptr;
+		}
+
+#if defined(DEATH_DEBUG)
+		if (fs::GetExtension(pending.Path) != "aura"_s) {
+			MigrateGraphics(pending.Path);
+		}
+#endif
+		return _cachedGraphics.emplace(Pair(std::move(pending.Path), pending.PaletteOffset), std::move(pending.Resource)).first->second.get();
+	}
+
+	void ContentResolver::ReleasePendingGraphics()
+	{
+		if (_pendingGraphics.empty()) {
+			return;
+		}
+
+		// Background jobs still reference pending graphics, so they have to be finished first
+		auto& threadPool = theServiceLocator().GetThreadPool();
+		for (auto& [key, pending] : _pendingGraphics) {
+			threadPool.Wait(&pending->LoadJob);
+		}
+		_pendingGraphics.clear();
 	}
 
-	void ContentResolver::ReadImageFromFile(std::unique_ptr<Stream>& s, std::uint8_t* data, std::int32_t width, std::int32_t height, std::int32_t channelCount)
+	void ContentResolver::ReadImageFromFile(std::unique_ptr<Stream>& s, std::uint8_t* data, std::int32_t width, std::int32_t height, std::int32_t channelCount, const std::uint32_t* palette, GenericGraphicResource* mask)
 	{
 		typedef union {
 			struct {
@@ -897,31 +1338,85 @@ namespace Jazz2
 
 		#define QOI_COLOR_HASH(C) (C.rgba.r*3 + C.rgba.g*5 + C.rgba.b*7 + C.rgba.a*11)
 
+		// Compressed data are read in blocks, but the stream can continue with other data after the image, so it must
+		// never be read past the end of the image. Every opcode produces at most 62 pixels, so the number of remaining
+		// pixels gives the lower bound of remaining bytes that can be safely read ahead.
+		constexpr std::int32_t MaxPixelsPerOp = 62;
+		constexpr std::int32_t BufferSize = 16384;
+
+		std::uint8_t buffer[BufferSize];
+		std::int32_t bufferPos = 0;
+		std::int32_t bufferEnd = 0;
+
+		auto ensureBytes = [&](std::int32_t required, std::int32_t pixelsAfter) {
+			std::int32_t available = bufferEnd - bufferPos;
+			if (available >= required) {
+				return;
+			}
+
+			std::memmove(buffer, buffer + bufferPos, available);
+			bufferPos = 0;
+			bufferEnd = available;
+
+			std::int32_t bytesToRead = required - available + (std::max(pixelsAfter, 0) + MaxPixelsPerOp - 1) / MaxPixelsPerOp;
+			bytesToRead = std::min(bytesToRead, BufferSize - available);
+			std::int32_t bytesRead = s->Read(buffer + bufferEnd, bytesToRead);
+			if (bytesRead > 0) {
+				bufferEnd += bytesRead;
+			}
+			if (bufferEnd < required) {
+				// Stream is truncated, fill the rest with zeros
+				std::memset(buffer + bufferEnd, 0, required - bufferEnd);
+				bufferEnd = required;
+			}
+		};
+
 		rgba_t index[64] { };
 		rgba_t px;
 		std::int32_t run = 0;
-		std::int32_t px_len = width * height * channelCount;
+		std::int32_t pixelsLeft = width * height;
 
 		px.rgba.r = 0;
 		px.rgba.g = 0;
 		px.rgba.b = 0;
 		px.rgba.a = 255;
 
-		for (std::int32_t px_pos = 0; px_pos < px_len; px_pos += channelCount) {
-			if (run > 0) {
-				run--;
-			} else {
-				std::int32_t b1 = s->ReadValue<std::uint8_t>();
+		// Other formats are decoded to a temporary row first and then packed
+		std::unique_ptr<std::uint32_t[]> rowBuffer;
+		if (channelCount != 4) {
+			rowBuffer = std::make_unique<std::uint32_t[]>(width);
+		}
+
+		for (std::int32_t y = 0; y < height; y++) {
+			std::uint32_t* row = (channelCount == 4 ? (std::uint32_t*)data + y * width : rowBuffer.get());
+			std::int32_t x = 0;
+			while (x < width) {
+				if (run > 0) {
+					// Expand the whole run at once, it can continue on the next row
+					std::int32_t count = std::min(run, width - x);
+					std::fill_n(row + x, count, px.v);
+					x += count;
+					run -= count;
+					pixelsLeft -= count;
+					continue;
+				}
+
+				ensureBytes(1, pixelsLeft - MaxPixelsPerOp);
+				std::int32_t b1 = buffer[bufferPos++];
 
 				if (b1 == QOI_OP_RGB) {
-					px.rgba.r = s->ReadValue<std::uint8_t>();
-					px.rgba.g = s->ReadValue<std::uint8_t>();
-					px.rgba.b = s->ReadValue<std::uint8_t>();
+					ensureBytes(3, pixelsLeft - 1);
+					px.rgba.r = buffer[bufferPos];
+					px.rgba.g = buffer[bufferPos + 1];
+					px.rgba.b = buffer[bufferPos + 2];
+					bufferPos += 3;
 				} else if (b1 == QOI_OP_RGBA) {
-					px.rgba.r = s->ReadValue<std::uint8_t>();
-					px.rgba.g = s->ReadValue<std::uint8_t>();
-					px.rgba.b = s->ReadValue<std::uint8_t>();
-					px.rgba.a = s->ReadValue<std::uint8_t>();
+					ensureBytes(4, pixelsLeft - 1);
+					px.rgba.r = buffer[bufferPos];
+					px.rgba.g = buffer[bufferPos + 1];
+					px.rgba.b = buffer[bufferPos + 2];
+					px.rgba.a = buffer[bufferPos + 3];
+					bufferPos += 4;
 				} else if ((b1 & QOI_MASK_2) == QOI_OP_INDEX) {
 					px = index[b1];
 				} else if ((b1 & QOI_MASK_2) == QOI_OP_DIFF) {
@@ -929,19 +1424,41 @@ namespace Jazz2
 					px.rgba.g += ((b1 >> 2) & 0x03) - 2;
 					px.rgba.b += (b1 & 0x03) - 2;
 				} else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA) {
-					std::int32_t b2 = s->ReadValue<std::uint8_t>();
+					ensureBytes(1, pixelsLeft - 1);
+					std::int32_t b2 = buffer[bufferPos++];
 					std::int32_t vg = (b1 & 0x3f) - 32;
 					px.rgba.r += vg - 8 + ((b2 >> 4) & 0x0f);
 					px.rgba.g += vg;
 					px.rgba.b += vg - 8 + (b2 & 0x0f);
 				} else if ((b1 & QOI_MASK_2) == QOI_OP_RUN) {
-					run = (b1 & 0x3f);
+					// The current pixel is repeated, so the run is expanded with the following pixels at once
+					run = (b1 & 0x3f) + 1;
 				}
 
 				index[QOI_COLOR_HASH(px) & 63] = px;
+
+				if (run == 0) {
+					row[x++] = px.v;
+					pixelsLeft--;
+				}
 			}
 
-			*(rgba_t*)(data + px_pos) = px;
+			// Mask extraction and palette remapping are done while the row is still in cache
+			if (mask != nullptr) {
+				mask->UpdateMaskRow(row, y);
+			}
+			if (palette != nullptr) {
+				for (std::int32_t i = 0; i < width; i++) {
+					std::uint32_t color = palette[row[i] & 0xff];
+					row[i] = (color & 0xffffff) | ((((color >> 24) & 0xff) * ((row[i] >> 24) & 0xff) / 255) << 24);
+				}
+			}
+			if (channelCount != 4) {
+				std::uint8_t* dst = data + y * width * channelCount;
+				for (std::int32_t i = 0; i < width; i++) {
+					std::memcpy(dst + i * channelCount, &row[i], channelCount);
+				}
+			}
 		}
 	}
 
@@ -986,6 +1503,7 @@ namespace Jazz2
 #if defined(DEATH_DEBUG)
 					LOGW("Releasing all animations because of different palette - Metadata: 0|%i, Animations: 0|%i", (std::int32_t)_cachedMetadata.size(), (std::int32_t)_cachedGraphics.size());
 #endif
+					ReleasePendingGraphics();
 					_cachedMetadata.clear();
 					_cachedGraphics.clear();
 
@@ -1002,14 +1520,17 @@ namespace Jazz2
 		}
 
 		// Mask
+		// Mask is stored as 1 bit per pixel (LSB first), so every 4 bytes form one 32px row of a tile
 		std::uint32_t maskSize = uc.ReadValue<std::uint32_t>();
-		std::unique_ptr<uint8_t[]> mask = std::make_unique<std::uint8_t[]>(maskSize * 8);
-		for (std::uint32_t j = 0; j < maskSize; j++) {
-			std::uint8_t idx = uc.ReadValue<std::uint8_t>();
-			for (std::uint32_t k = 0; k < 8; k++) {
-				std::uint32_t pixelIdx = 8 * j + k;
-				mask[pixelIdx] = (((idx >> k) & 0x01) != 0);
-			}
+		std::uint32_t maskRows = (maskSize + 3) / 4;
+		std::unique_ptr<std::uint8_t[]> maskBytes = std::make_unique<std::uint8_t[]>(maskRows * 4);
+		uc.Read(maskBytes.get(), maskSize);
+		std::memset(&maskBytes[maskSize], 0, maskRows * 4 - maskSize);
+
+		std::unique_ptr<std::uint32_t[]> mask = std::make_unique<std::uint32_t[]>(maskRows);
+		for (std::uint32_t j = 0; j < maskRows; j++) {
+			const std::uint8_t* src = &maskBytes[j * 4];
+			mask[j] = (std::uint32_t)src[0] | ((std::uint32_t)src[1] << 8) | ((std::uint32_t)src[2] << 16) | ((std::uint32_t)src[3] << 24);
 		}
 
 		std::unique_ptr<Texture> textureDiffuse;
@@ -1134,7 +1655,7 @@ namespace Jazz2
 			return nullptr;
 		}
 
-		return std::make_unique<Tiles::TileSet>(tileCount, std::move(textureDiffuse), std::move(mask), maskSize * 8, std::move(captionTile));
+		return std::make_unique<Tiles::TileSet>(tileCount, std::move(textureDiffuse), std::move(mask), maskRows, std::move(captionTile));
 	}
 
 	bool ContentResolver::LevelExists(const StringView episodeName, const StringView levelName)
@@ -1219,6 +1740,7 @@ namespace Jazz2
 			if (std::memcmp(_palettes, newPalette, ColorsPerPalette * sizeof(std::uint32_t)) != 0) {
 				// Palettes differs, drop all cached resources, so it will be reloaded with new palette
 				if (_isLoading) {
+					ReleasePendingGraphics();
 					_cachedMetadata.clear();
 					_cachedGraphics.clear();
 
@@ -1295,6 +1817,7 @@ namespace Jazz2
 		if (std::memcmp(_palettes, SpritePalette, ColorsPerPalette * sizeof(std::uint32_t)) != 0) {
 			// Palettes differs, drop all cached resources, so it will be reloaded with new palette
 			if (_isLoading) {
+				ReleasePendingGraphics();
 				_cachedMetadata.clear();
 				_cachedGraphics.clear();
 
@@ -1406,7 +1929,8 @@ namespace Jazz2
 
 	UI::Font* ContentResolver::GetFont(FontType fontType)
 	{
-		if (fontType >= FontType::Count) {
+		// Don't load fonts in headless mode
+		if (fontType >= FontType::Count || _isHeadless) {
 			return nullptr;
 		}
 
@@ -1679,15 +2203,8 @@ namespace Jazz2
 			return;
 		}
 
-
-		auto buffer = std::make_unique<char[]>(fileSize + simdjson::SIMDJSON_PADDING);
-		s->Read(buffer.get(), fileSize);
-		s->Dispose();
-		buffer[fileSize] = '\0';
-
-		ondemand::parser parser;
 		ondemand::document doc;
-		if (parser.iterate(buffer.get(), fileSize, fileSize + simdjson::SIMDJSON_PADDING).get(doc) == SUCCESS) {
+		if (GetJsonParser().Parse(*this, *s, fileSize, doc) == SUCCESS) {
 			String fullPath = fs::CombinePath({ GetContentPath(), "Animations"_s, path });
 			std::unique_ptr<ITextureLoader> texLoader = ITextureLoader::createFromFile(fullPath);
 			if (texLoader->hasLoaded()) {
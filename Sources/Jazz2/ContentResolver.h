@@ -15,12 +15,16 @@
 #include "../nCine/Graphics/Texture.h"
 #include "../nCine/Graphics/Viewport.h"
 #include "../nCine/Base/HashMap.h"
+#include "../nCine/Graphics/ITextureLoader.h"
+#include "../nCine/Threading/IThreadPool.h"
+#include "../nCine/Threading/ThreadSync.h"
 
 #include <Containers/Pair.h>
 #include <Containers/Reference.h>
 #include <Containers/SmallVector.h>
 #include <Containers/StringView.h>
 #include <IO/FileSystem.h>
+#include <IO/MemoryStream.h>
 #include <IO/PakFile.h>
 #include <IO/Stream.h>
 
@@ -45,17 +49,28 @@ namespace Jazz2
 		static constexpr std::uint8_t ConfigFile = 4;
 		static constexpr std::uint8_t StateFile = 5;
 		static constexpr std::uint8_t SfxListFile = 6;
+		static constexpr std::uint8_t MetadataCacheFile = 7;
 
 		static constexpr std::int32_t PaletteCount = 256;
 		static constexpr std::int32_t ColorsPerPalette = 256;
 		static constexpr std::int32_t InvalidValue = INT_MAX;
 
+		/** @brief Statistics of parsed content files */
+		struct LoadStatistics
+		{
+			std::int32_t FilesParsed;
+			std::int64_t BytesParsed;
+			std::int32_t Allocations;
+		};
+
 		static ContentResolver& Get();
 
 		~ContentResolver();
 		
 		void Release();
 
+		LoadStatistics GetLoadStatistics();
+
 		StringView GetContentPath() const;
 		StringView GetCachePath() const;
 		StringView GetSourcePath() const;
@@ -74,6 +89,8 @@ namespace Jazz2
 		void PreloadMetadataAsync(const StringView path);
 		Metadata* RequestMetadata(const StringView path);
 		GenericGraphicResource* RequestGraphics(const StringView path, std::uint16_t paletteOffset);
+		/** @brief Uploads textures of graphics that were decoded in background, only a few per call to spread it across frames */
+		void FinalizePendingGraphics();
 
 		std::unique_ptr<Tiles::TileSet> RequestTileSet(const StringView path, std::uint16_t captionTileId, bool applyPalette, const std::uint8_t* paletteRemapping = nullptr);
 		bool LevelExists(const StringView episodeName, const StringView levelName);
@@ -100,6 +117,44 @@ namespace Jazz2
 			}
 		};
 
+		/** @brief Graphics that are loaded and decoded in background, only texture upload is done on the main thread */
+		struct PendingGraphics
+		{
+			Job LoadJob;
+			String Path;
+			std::uint16_t PaletteOffset;
+			std::uint32_t Palette[ColorsPerPalette];
+			std::unique_ptr<GenericGraphicResource> Resource;
+			std::unique_ptr<ITextureLoader> TextureLoader;
+			std::unique_ptr<std::uint32_t[]> OwnedPixels;
+			std::uint32_t* Pixels;
+			std::int32_t Width;
+			std::int32_t Height;
+			bool LinearSampling;
+		};
+
+		struct JsonParser;
+
+		/** @brief Binary metadata, either memory-mapped from cache or converted from JSON */
+		struct MetadataCache
+		{
+#if defined(DEATH_TARGET_UNIX) || (defined(DEATH_TARGET_WINDOWS) && !defined(DEATH_TARGET_WINDOWS_RT))
+			std::optional<Array<char, fs::MapDeleter>> MappedFile;
+#else
+			std::unique_ptr<std::uint8_t[]> FileData;
+#endif
+			std::unique_ptr<MemoryStream> ConvertedData;
+			const std::uint8_t* Data;
+			std::int64_t Size;
+		};
+
+		/** @brief Version of binary metadata cache, it must be increased if the format or metadata semantics change */
+		static constexpr std::uint16_t MetadataCacheVersion = 1;
+		static constexpr std::int32_t MetadataCacheHeaderSize = 32;
+
+		/** @brief Maximum number of textures uploaded by @ref FinalizePendingGraphics() */
+		static constexpr std::int32_t MaxGraphicsFinalizedPerCall = 4;
+
 		ContentResolver();
 
 		ContentResolver(const ContentResolver&) = delete;
@@ -107,8 +162,17 @@ namespace Jazz2
 
 		void InitializePaths();
 
-		GenericGraphicResource* RequestGraphicsAura(const StringView path, std::uint16_t paletteOffset);
-		static void ReadImageFromFile(std::unique_ptr<Stream>& s, std::uint8_t* data, std::int32_t width, std::int32_t height, std::int32_t channelCount);
+		JsonParser& GetJsonParser();
+		bool OpenMetadataCache(const StringView path, MetadataCache& cache);
+		static bool IsMetadataCacheValid(const std::uint8_t* data, std::int64_t size, std::int64_t sourceSize, std::int64_t sourceModified);
+		void ConvertMetadataFromJson(const StringView path, Stream& s, std::int64_t size, Stream& so);
+		std::unique_ptr<PendingGraphics> CreatePendingGraphics(String path, std::uint16_t paletteOffset);
+		void ScheduleGraphics(const StringView path, std::uint16_t paletteOffset);
+		void LoadGraphics(PendingGraphics& pending);
+		void LoadGraphicsAura(PendingGraphics& pending);
+		GenericGraphicResource* FinalizeGraphics(PendingGraphics& pending);
+		void ReleasePendingGraphics();
+		static void ReadImageFromFile(std::unique_ptr<Stream>& s, std::uint8_t* data, std::int32_t width, std::int32_t height, std::int32_t channelCount, const std::uint32_t* palette = nullptr, GenericGraphicResource* mask = nullptr);
 		
 		std::unique_ptr<Shader> CompileShader(const char* shaderName, Shader::DefaultVertex vertex, const char* fragment, Shader::Introspection introspection = Shader::Introspection::Enabled);
 		std::unique_ptr<Shader> CompileShader(const char* shaderName, const char* vertex, const char* fragment, Shader::Introspection introspection = Shader::Introspection::Enabled);
@@ -123,6 +187,14 @@ namespace Jazz2
 		std::uint32_t _palettes[PaletteCount * ColorsPerPalette];
 		HashMap<Reference<String>, std::unique_ptr<Metadata>, FNV1aHashFunc<String>, StringRefEqualTo> _cachedMetadata;
 		HashMap<Pair<String, std::uint16_t>, std::unique_ptr<GenericGraphicResource>> _cachedGraphics;
+		HashMap<Pair<String, std::uint16_t>, std::unique_ptr<PendingGraphics>> _pendingGraphics;
+		SmallVector<std::unique_ptr<JsonParser>, 0> _jsonParsers;
+#if defined(WITH_THREADS)
+		Mutex _jsonParsersLock;
+#endif
+		Atomic32 _jsonFilesParsed;
+		Atomic64 _jsonBytesParsed;
+		Atomic32 _jsonAllocations;
 #if defined(WITH_AUDIO)
 		HashMap<String, std::unique_ptr<GenericSoundResource>> _cachedSounds;
 #endif
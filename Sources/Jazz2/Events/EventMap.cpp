@@ -9,7 +9,7 @@
 namespace Jazz2::Events
 {
 	EventMap::EventMap(const Vector2i& layoutSize)
-		: _levelHandler(nullptr), _layoutSize(layoutSize), _pitType(PitType::FallForever)
+		: _levelHandler(nullptr), _layoutSize(layoutSize), _pitType(PitType::FallForever), _chunksPerRow(0)
 	{
 	}
 
@@ -91,6 +91,8 @@ namespace Jazz2::Events
 				}
 			}
 		}
+
+		RebuildEventChunks();
 	}
 
 	void EventMap::StoreTileEvent(std::int32_t x, std::int32_t y, EventType eventType, Actors::ActorState eventFlags, std::uint8_t* tileParams)
@@ -99,7 +101,10 @@ namespace Jazz2::Events
 			return;
 		}
 
-		EventTile& previousEvent = _eventLayout[x + y * _layoutSize.X];
+		std::int32_t tileIdx = x + y * _layoutSize.X;
+		EventTile& previousEvent = _eventLayout[tileIdx];
+		bool wasEmpty = (previousEvent.Event == EventType::Empty);
+		bool wasPending = (!wasEmpty && !previousEvent.IsEventActive);
 
 		EventTile newEvent = { };
 		newEvent.Event = eventType,
@@ -112,6 +117,27 @@ namespace Jazz2::Events
 		}
 
 		previousEvent = newEvent;
+
+		if (!_eventChunks.empty()) {
+			// Keep the activation index in sync
+			EventChunk& chunk = GetEventChunk(x, y);
+			bool isEmpty = (newEvent.Event == EventType::Empty);
+			if (wasEmpty && !isEmpty) {
+				chunk.Events.push_back(tileIdx);
+			} else if (!wasEmpty && isEmpty) {
+				for (std::size_t i = 0; i < chunk.Events.size(); i++) {
+					if (chunk.Events[i] == tileIdx) {
+						chunk.Events.erase(chunk.Events.begin() + i);
+						break;
+					}
+				}
+			}
+
+			bool isPending = (!isEmpty && !newEvent.IsEventActive);
+			if (isPending != wasPending) {
+				chunk.PendingCount += (isPending ? 1 : -1);
+			}
+		}
 	}
 
 	void EventMap::PreloadEventsAsync()
@@ -120,9 +146,6 @@ namespace Jazz2::Events
 
 		auto eventSpawner = _levelHandler->EventSpawner();
 
-		// TODO
-		//ContentResolver::Get().SuspendAsync();
-
 		// Preload all events
 		for (auto& tile : _eventLayout) {
 			// TODO: Exclude also some modifiers here ?
@@ -136,8 +159,7 @@ namespace Jazz2::Events
 			eventSpawner->PreloadEvent(generator.Event, generator.EventParams);
 		}
 
-		// Don't wait for finalization of resources, it will be done in a few next frames
-		//ContentResolver::Get().ResumeAsync();
+		// Graphics are decoded in background, don't wait for them, they will be finalized in a few next frames
 	}
 
 	void EventMap::ProcessGenerators(float timeMult)
@@ -176,16 +198,42 @@ namespace Jazz2::Events
 	{
 		ZoneScopedC(0x9D5BA3);
 
+		if (_eventChunks.empty()) {
+			return;
+		}
+
 		std::int32_t x1 = std::max(0, tx1);
 		std::int32_t x2 = std::min(_layoutSize.X - 1, tx2);
 		std::int32_t y1 = std::max(0, ty1);
 		std::int32_t y2 = std::min(_layoutSize.Y - 1, ty2);
+		if (x1 > x2 || y1 > y2) {
+			return;
+		}
+
+		// Only chunks that contain some inactive events need to be visited
+		for (std::int32_t cy = y1 / ChunkSize; cy <= y2 / ChunkSize; cy++) {
+			for (std::int32_t cx = x1 / ChunkSize; cx <= x2 / ChunkSize; cx++) {
+				EventChunk& chunk = _eventChunks[cx + cy * _chunksPerRow];
+				if (chunk.PendingCount <= 0) {
+					continue;
+				}
+
+				// Spawned actors can modify the event map, so the list is accessed by index
+				for (std::size_t i = 0; i < chunk.Events.size(); i++) {
+					std::int32_t tileIdx = chunk.Events[i];
+					auto& tile = _eventLayout[tileIdx];
+					if (tile.IsEventActive) {
+						continue;
+					}
+
+					std::int32_t x = tileIdx % _layoutSize.X;
+					std::int32_t y = tileIdx / _layoutSize.X;
+					if (x < x1 || x > x2 || y < y1 || y > y2) {
+						continue;
+					}
 
-		for (std::int32_t x = x1; x <= x2; x++) {
-			for (std::int32_t y = y1; y <= y2; y++) {
-				auto& tile = _eventLayout[x + y * _layoutSize.X];
-				if (!tile.IsEventActive && tile.Event != EventType::Empty) {
 					tile.IsEventActive = true;
+					chunk.PendingCount--;
 
 					if (tile.Event == EventType::AreaWeather) {
 						_levelHandler->SetWeather((WeatherType)tile.EventParams[0], tile.EventParams[1]);
@@ -208,7 +256,14 @@ namespace Jazz2::Events
 	void EventMap::Deactivate(std::int32_t x, std::int32_t y)
 	{
 		if (HasEventByPosition(x, y)) {
-			_eventLayout[x + y * _layoutSize.X].IsEventActive = false;
+			EventTile& tile = _eventLayout[x + y * _layoutSize.X];
+			if (tile.IsEventActive) {
+				tile.IsEventActive = false;
+				// Re-arm the tile in the activation index
+				if (!_eventChunks.empty()) {
+					GetEventChunk(x, y).PendingCount++;
+				}
+			}
 		}
 	}
 
@@ -226,6 +281,34 @@ namespace Jazz2::Events
 		_generators[generatorIdx].SpawnedActor = nullptr;
 	}
 
+	EventMap::EventChunk& EventMap::GetEventChunk(std::int32_t x, std::int32_t y)
+	{
+		return _eventChunks[(x / ChunkSize) + (y / ChunkSize) * _chunksPerRow];
+	}
+
+	void EventMap::RebuildEventChunks()
+	{
+		_chunksPerRow = (_layoutSize.X + (ChunkSize - 1)) / ChunkSize;
+		std::int32_t chunksPerColumn = (_layoutSize.Y + (ChunkSize - 1)) / ChunkSize;
+
+		_eventChunks.clear();
+		_eventChunks.resize(_chunksPerRow * chunksPerColumn);
+
+		for (std::int32_t y = 0; y < _layoutSize.Y; y++) {
+			for (std::int32_t x = 0; x < _layoutSize.X; x++) {
+				std::int32_t tileIdx = x + y * _layoutSize.X;
+				const EventTile& tile = _eventLayout[tileIdx];
+				if (tile.Event != EventType::Empty) {
+					EventChunk& chunk = GetEventChunk(x, y);
+					chunk.Events.push_back(tileIdx);
+					if (!tile.IsEventActive) {
+						chunk.PendingCount++;
+					}
+				}
+			}
+		}
+	}
+
 	const EventMap::EventTile& EventMap::GetEventTile(std::int32_t x, std::int32_t y) const
 	{
 		return _eventLayout[x + y * _layoutSize.X];
@@ -405,6 +488,8 @@ namespace Jazz2::Events
 				}
 			}
 		}
+
+		RebuildEventChunks();
 	}
 
 	void EventMap::AddWarpTarget(std::uint16_t id, std::int32_t x, std::int32_t y)
@@ -437,6 +522,8 @@ namespace Jazz2::Events
 			tile.EventFlags = (Actors::ActorState)src.ReadVariableUint32();
 			src.Read(tile.EventParams, sizeof(tile.EventParams));
 		}
+
+		RebuildEventChunks();
 	}
 
 	void EventMap::SerializeResumableToStream(Stream& dest)
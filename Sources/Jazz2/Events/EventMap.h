@@ -59,6 +59,15 @@ namespace Jazz2::Events
 		void SerializeResumableToStream(Stream& dest);
 
 	private:
+		/** @brief Size of a chunk of the activation index in tiles */
+		static constexpr std::int32_t ChunkSize = 16;
+
+		/** @brief Chunk of the activation index, it contains all non-empty events in the area */
+		struct EventChunk {
+			SmallVector<std::int32_t, 0> Events;
+			std::int32_t PendingCount;
+		};
+
 		struct GeneratorInfo {
 			std::int32_t EventPos;
 
@@ -88,5 +97,10 @@ namespace Jazz2::Events
 		SmallVector<GeneratorInfo, 0> _generators;
 		SmallVector<SpawnPoint, 0> _spawnPoints;
 		SmallVector<WarpTarget, 0> _warpTargets;
+		SmallVector<EventChunk, 0> _eventChunks;
+		std::int32_t _chunksPerRow;
+
+		EventChunk& GetEventChunk(std::int32_t x, std::int32_t y);
+		void RebuildEventChunks();
 	};
 }
\ No newline at end of file
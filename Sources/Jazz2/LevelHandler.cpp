@@ -111,7 +111,8 @@ namespace Jazz2
 		: _root(root), _lightingShader(nullptr), _blurShader(nullptr), _downsampleShader(nullptr), _combineShader(nullptr), _combineWithWaterShader(nullptr),
 			_eventSpawner(this), _difficulty(GameDifficulty::Default), _isReforged(false), _cheatsUsed(false), _checkpointCreated(false),
 			_cheatsBufferLength(0), _nextLevelType(ExitType::None), _nextLevelTime(0.0f), _elapsedFrames(0.0f), _checkpointFrames(0.0f),
-			_waterLevel(FLT_MAX), _weatherType(WeatherType::None), _pressedKeys(ValueInit, (std::size_t)KeySym::COUNT), _overrideActions(0)
+			_waterLevel(FLT_MAX), _weatherType(WeatherType::None), _deactivationBucketsPerRow(0), _deactivationChecksCount(0),
+			_staticLightGridDirty(false), _staticLightQuery(0), _dynamicLightsFrame(0), _pressedKeys(ValueInit, (std::size_t)KeySym::COUNT), _overrideActions(0)
 	{
 	}
 
@@ -124,6 +125,7 @@ namespace Jazz2
 		_hud->setParent(nullptr);
 
 		TracyPlot("Actors", 0LL);
+		TracyPlot("Actors Checked For Deactivation", 0LL);
 	}
 
 	bool LevelHandler::Initialize(const LevelInitialization& levelInit)
@@ -139,7 +141,9 @@ namespace Jazz2
 		auto& resolver = ContentResolver::Get();
 		resolver.BeginLoading();
 
-		_noiseTexture = resolver.GetNoiseTexture();
+		if (!resolver.IsHeadless()) {
+			_noiseTexture = resolver.GetNoiseTexture();
+		}
 
 		_rootNode = std::make_unique<SceneNode>();
 		_rootNode->setVisitOrderState(SceneNode::VisitOrderState::Disabled);
@@ -185,7 +189,9 @@ namespace Jazz2
 		auto& resolver = ContentResolver::Get();
 		resolver.BeginLoading();
 
-		_noiseTexture = resolver.GetNoiseTexture();
+		if (!resolver.IsHeadless()) {
+			_noiseTexture = resolver.GetNoiseTexture();
+		}
 
 		_rootNode = std::make_unique<SceneNode>();
 		_rootNode->setVisitOrderState(SceneNode::VisitOrderState::Disabled);
@@ -342,10 +348,13 @@ namespace Jazz2
 	{
 		ZoneScopedC(0x4876AF);
 
-		if (!descriptor.DisplayName.empty()) {
-			theApplication().GetGfxDevice().setWindowTitle(String(NCINE_APP_NAME " - " + descriptor.DisplayName));
-		} else {
-			theApplication().GetGfxDevice().setWindowTitle(NCINE_APP_NAME);
+		// There is no window in headless mode
+		if (!ContentResolver::Get().IsHeadless()) {
+			if (!descriptor.DisplayName.empty()) {
+				theApplication().GetGfxDevice().setWindowTitle(String(NCINE_APP_NAME " - " + descriptor.DisplayName));
+			} else {
+				theApplication().GetGfxDevice().setWindowTitle(NCINE_APP_NAME);
+			}
 		}
 
 		_defaultNextLevel = std::move(descriptor.NextLevel);
@@ -358,6 +367,11 @@ namespace Jazz2
 		_eventMap = std::move(descriptor.EventMap);
 		_eventMap->SetLevelHandler(this);
 
+		Vector2i eventMapSize = _eventMap->GetSize();
+		_deactivationBucketsPerRow = (eventMapSize.X + (DeactivationBucketSize - 1)) / DeactivationBucketSize;
+		std::int32_t deactivationBucketsPerColumn = (eventMapSize.Y + (DeactivationBucketSize - 1)) / DeactivationBucketSize;
+		_deactivationBuckets.resize(_deactivationBucketsPerRow * deactivationBucketsPerColumn);
+
 		Vector2i levelBounds = _tileMap->GetLevelBounds();
 		_levelBounds = Recti(0, 0, levelBounds.X, levelBounds.Y);
 		_viewBoundsTarget = _levelBounds.As<float>();
@@ -444,6 +458,9 @@ namespace Jazz2
 	{
 		ZoneScopedC(0x4876AF);
 
+		// Upload graphics that were decoded in background in the meantime
+		ContentResolver::Get().FinalizePendingGraphics();
+
 		float timeMult = theApplication().GetTimeMult();
 
 		if (_pauseMenu == nullptr) {
@@ -549,7 +566,8 @@ namespace Jazz2
 		}
 
 #if defined(DEATH_DEBUG) && defined(WITH_IMGUI)
-		if (PreferencesCache::ShowPerformanceMetrics) {
+		// ImGui is not available in headless mode
+		if (PreferencesCache::ShowPerformanceMetrics && !ContentResolver::Get().IsHeadless()) {
 			ImDrawList* drawList = ImGui::GetBackgroundDrawList();
 
 			std::size_t actorsCount = _actors.size();
@@ -567,6 +585,16 @@ namespace Jazz2
 				drawList->AddRect(aabbMin, aabbMax, ImColor(120, 200, 255, 180));
 				drawList->AddRect(aabbInnerMin, aabbInnerMax, ImColor(255, 255, 255));
 			}
+
+			char actorsCheckedString[64];
+			formatString(actorsCheckedString, arraySize(actorsCheckedString), "Actors checked for deactivation: %i / %i", _deactivationChecksCount, (std::int32_t)actorsCount);
+			drawList->AddText(ImVec2(6.0f, 6.0f), ImColor(255, 255, 255), actorsCheckedString);
+
+			auto loadStats = ContentResolver::Get().GetLoadStatistics();
+			char loadStatsString[128];
+			formatString(loadStatsString, arraySize(loadStatsString), "Content files parsed: %i (%.1f kB), allocations: %i",
+				loadStats.FilesParsed, loadStats.BytesParsed / 1024.0f, loadStats.Allocations);
+			drawList->AddText(ImVec2(6.0f, 22.0f), ImColor(255, 255, 255), loadStatsString);
 		}
 #endif
 
@@ -593,11 +621,17 @@ namespace Jazz2
 		}
 
 		_viewSize = Vector2i(w, h);
+
+		auto& resolver = ContentResolver::Get();
+		if (resolver.IsHeadless()) {
+			// Nothing is rendered in headless mode, so no viewports and no shaders are needed
+			return;
+		}
+
 		_upscalePass.Initialize(w, h, width, height);
 
 		bool notInitialized = (_combineShader == nullptr);
 
-		auto& resolver = ContentResolver::Get();
 		if (notInitialized) {
 			LOGI("Acquiring required shaders");
 
@@ -794,6 +828,17 @@ namespace Jazz2
 			actor->CollisionProxyID = _collisions.CreateProxy(actor->AABB, actor.get());
 		}
 
+		if ((actor->_state & (Actors::ActorState::IsCreatedFromEventMap | Actors::ActorState::IsFromGenerator)) != Actors::ActorState::None) {
+			auto* bucket = GetDeactivationBucket(actor->_originTile);
+			if (bucket != nullptr) {
+				bucket->push_back(actor.get());
+			}
+		}
+
+		if (actor->GetState(Actors::ActorState::HasStaticLights)) {
+			AddStaticLights(actor.get());
+		}
+
 		_actors.emplace_back(actor);
 	}
 
@@ -1444,8 +1489,43 @@ namespace Jazz2
 				playerZones.emplace_back(activationRange.L - 4, activationRange.T - 4, activationRange.R + 4, activationRange.B + 4);
 			}
 
-			for (auto& actor : _actors) {
-				if ((actor->_state & (Actors::ActorState::IsCreatedFromEventMap | Actors::ActorState::IsFromGenerator)) != Actors::ActorState::None) {
+			// Event-spawned actors are bucketed by their origin tile, buckets that lie completely inside
+			// of any deactivation zone can be skipped, so only actors near zone borders are checked
+			_deactivationChecksCount = 0;
+
+			std::int32_t bucketCount = (std::int32_t)_deactivationBuckets.size();
+			std::int32_t lastBucketX = _deactivationBucketsPerRow - 1;
+			std::int32_t lastBucketY = (_deactivationBucketsPerRow > 0 ? bucketCount / _deactivationBucketsPerRow - 1 : 0);
+			for (std::int32_t b = 0; b < bucketCount; b++) {
+				auto& bucket = _deactivationBuckets[b];
+				if (bucket.empty()) {
+					continue;
+				}
+
+				std::int32_t bx = b % _deactivationBucketsPerRow;
+				std::int32_t by = b / _deactivationBucketsPerRow;
+				AABBi bucketBounds(bx * DeactivationBucketSize, by * DeactivationBucketSize,
+					(bx + 1) * DeactivationBucketSize - 1, (by + 1) * DeactivationBucketSize - 1);
+				// Border buckets contain also actors with origin outside of the level
+				if (bx == 0) bucketBounds.L = INT32_MIN;
+				if (by == 0) bucketBounds.T = INT32_MIN;
+				if (bx == lastBucketX) bucketBounds.R = INT32_MAX;
+				if (by == lastBucketY) bucketBounds.B = INT32_MAX;
+
+				bool isBucketInside = false;
+				for (std::size_t i = 1; i < playerZones.size(); i += 2) {
+					if (playerZones[i].Contains(bucketBounds)) {
+						isBucketInside = true;
+						break;
+					}
+				}
+				if (isBucketInside) {
+					continue;
+				}
+
+				// Actors can be added to the bucket during iteration, so it's accessed by index
+				for (std::size_t j = 0; j < bucket.size(); j++) {
+					Actors::ActorBase* actor = bucket[j];
 					Vector2i originTile = actor->_originTile;
 					bool isInside = false;
 					for (std::size_t i = 1; i < playerZones.size(); i += 2) {
@@ -1455,6 +1535,8 @@ namespace Jazz2
 						}
 					}
 
+					_deactivationChecksCount++;
+
 					if (!isInside && actor->OnTileDeactivated()) {
 						if ((actor->_state & Actors::ActorState::IsFromGenerator) == Actors::ActorState::IsFromGenerator) {
 							_eventMap->ResetGenerator(originTile.X, originTile.Y);
@@ -1466,6 +1548,8 @@ namespace Jazz2
 				}
 			}
 
+			TracyPlot("Actors Checked For Deactivation", static_cast<std::int64_t>(_deactivationChecksCount));
+
 			for (std::size_t i = 0; i < playerZones.size(); i += 2) {
 				const auto& activationZone = playerZones[i];
 				_eventMap->ActivateEvents(activationZone.L, activationZone.T, activationZone.R, activationZone.B, true);
@@ -1693,10 +1777,24 @@ namespace Jazz2
 			Actors::ActorBase* actor = it->get();
 			if (actor->GetState(Actors::ActorState::IsDestroyed)) {
 				BeforeActorDestroyed(actor);
+				if ((actor->_state & (Actors::ActorState::IsCreatedFromEventMap | Actors::ActorState::IsFromGenerator)) != Actors::ActorState::None) {
+					auto* bucket = GetDeactivationBucket(actor->_originTile);
+					if (bucket != nullptr) {
+						for (std::size_t i = 0; i < bucket->size(); i++) {
+							if ((*bucket)[i] == actor) {
+								bucket->eraseUnordered(i);
+								break;
+							}
+						}
+					}
+				}
 				if (actor->CollisionProxyID != Collisions::NullNode) {
 					_collisions.DestroyProxy(actor->CollisionProxyID);
 					actor->CollisionProxyID = Collisions::NullNode;
 				}
+				if (actor->GetState(Actors::ActorState::HasStaticLights)) {
+					RemoveStaticLights(actor);
+				}
 				it = _actors.eraseUnordered(it);
 				continue;
 			}
@@ -1734,6 +1832,142 @@ namespace Jazz2
 		_collisions.UpdatePairs(&helper);
 	}
 
+	SmallVector<Actors::ActorBase*, 0>* LevelHandler::GetDeactivationBucket(const Vector2i& originTile)
+	{
+		if (_deactivationBuckets.empty()) {
+			return nullptr;
+		}
+
+		std::int32_t bucketsPerColumn = (std::int32_t)_deactivationBuckets.size() / _deactivationBucketsPerRow;
+		std::int32_t bx = std::clamp(originTile.X / DeactivationBucketSize, 0, _deactivationBucketsPerRow - 1);
+		std::int32_t by = std::clamp(originTile.Y / DeactivationBucketSize, 0, bucketsPerColumn - 1);
+		return &_deactivationBuckets[bx + by * _deactivationBucketsPerRow];
+	}
+
+	void LevelHandler::AddStaticLights(Actors::ActorBase* actor)
+	{
+		SmallVector<LightEmitter, 4> lights;
+		actor->OnEmitLights(lights);
+
+		for (const LightEmitter& light : lights) {
+			_staticLights.push_back(StaticLight { actor, light, 0 });
+		}
+		if (!lights.empty()) {
+			_staticLightGridDirty = true;
+		}
+	}
+
+	void LevelHandler::RemoveStaticLights(Actors::ActorBase* actor)
+	{
+		for (std::size_t i = _staticLights.size(); i > 0; i--) {
+			if (_staticLights[i - 1].Owner == actor) {
+				_staticLights.eraseUnordered(i - 1);
+				_staticLightGridDirty = true;
+			}
+		}
+	}
+
+	void LevelHandler::RebuildStaticLightGrid()
+	{
+		_staticLightGridDirty = false;
+
+		for (auto& cell : _staticLightGrid) {
+			cell.clear();
+		}
+
+		if (_staticLights.empty()) {
+			_staticLightGridBounds = Recti();
+			return;
+		}
+
+		// Grid covers only the area of all static lights, lights usually aren't spread across the whole level
+		Vector2i min = Vector2i(INT32_MAX, INT32_MAX);
+		Vector2i max = Vector2i(INT32_MIN, INT32_MIN);
+		for (const StaticLight& staticLight : _staticLights) {
+			const LightEmitter& light = staticLight.Light;
+			min.X = std::min(min.X, (std::int32_t)std::floor((light.Pos.X - light.RadiusFar) / LightGridCellSize));
+			min.Y = std::min(min.Y, (std::int32_t)std::floor((light.Pos.Y - light.RadiusFar) / LightGridCellSize));
+			max.X = std::max(max.X, (std::int32_t)std::floor((light.Pos.X + light.RadiusFar) / LightGridCellSize));
+			max.Y = std::max(max.Y, (std::int32_t)std::floor((light.Pos.Y + light.RadiusFar) / LightGridCellSize));
+		}
+
+		_staticLightGridBounds = Recti(min.X, min.Y, max.X - min.X + 1, max.Y - min.Y + 1);
+		std::size_t cellCount = (std::size_t)_staticLightGridBounds.W * (std::size_t)_staticLightGridBounds.H;
+		if (_staticLightGrid.size() < cellCount) {
+			_staticLightGrid.resize(cellCount);
+		}
+
+		for (std::int32_t i = 0; i < (std::int32_t)_staticLights.size(); i++) {
+			const LightEmitter& light = _staticLights[i].Light;
+			std::int32_t x1 = (std::int32_t)std::floor((light.Pos.X - light.RadiusFar) / LightGridCellSize) - min.X;
+			std::int32_t y1 = (std::int32_t)std::floor((light.Pos.Y - light.RadiusFar) / LightGridCellSize) - min.Y;
+			std::int32_t x2 = (std::int32_t)std::floor((light.Pos.X + light.RadiusFar) / LightGridCellSize) - min.X;
+			std::int32_t y2 = (std::int32_t)std::floor((light.Pos.Y + light.RadiusFar) / LightGridCellSize) - min.Y;
+			for (std::int32_t y = y1; y <= y2; y++) {
+				for (std::int32_t x = x1; x <= x2; x++) {
+					_staticLightGrid[x + y * _staticLightGridBounds.W].push_back(i);
+				}
+			}
+		}
+	}
+
+	void LevelHandler::QueryVisibleLights(const Rectf& bounds, SmallVectorImpl<LightEmitter>& lights)
+	{
+		auto isVisible = [&bounds](const LightEmitter& light) {
+			return (light.Pos.X + light.RadiusFar >= bounds.X && light.Pos.X - light.RadiusFar <= bounds.X + bounds.W &&
+					light.Pos.Y + light.RadiusFar >= bounds.Y && light.Pos.Y - light.RadiusFar <= bounds.Y + bounds.H);
+		};
+
+		// Dynamic lights are emitted only once per frame, even if there are more viewports
+		unsigned long int frameCount = theApplication().GetFrameCount();
+		if (_dynamicLightsFrame != frameCount) {
+			_dynamicLightsFrame = frameCount;
+			_dynamicLights.clear();
+
+			std::size_t actorsCount = _actors.size();
+			for (std::size_t i = 0; i < actorsCount; i++) {
+				auto* actor = _actors[i].get();
+				if (!actor->GetState(Actors::ActorState::HasStaticLights)) {
+					actor->OnEmitLights(_dynamicLights);
+				}
+			}
+		}
+
+		for (const LightEmitter& light : _dynamicLights) {
+			if (isVisible(light)) {
+				lights.push_back(light);
+			}
+		}
+
+		if (_staticLightGridDirty) {
+			RebuildStaticLightGrid();
+		}
+		if (_staticLights.empty()) {
+			return;
+		}
+
+		std::int32_t x1 = std::max((std::int32_t)std::floor(bounds.X / LightGridCellSize) - _staticLightGridBounds.X, 0);
+		std::int32_t y1 = std::max((std::int32_t)std::floor(bounds.Y / LightGridCellSize) - _staticLightGridBounds.Y, 0);
+		std::int32_t x2 = std::min((std::int32_t)std::floor((bounds.X + bounds.W) / LightGridCellSize) - _staticLightGridBounds.X, _staticLightGridBounds.W - 1);
+		std::int32_t y2 = std::min((std::int32_t)std::floor((bounds.Y + bounds.H) / LightGridCellSize) - _staticLightGridBounds.Y, _staticLightGridBounds.H - 1);
+
+		// Light can intersect more cells, so each light is added only once per query
+		_staticLightQuery++;
+		for (std::int32_t y = y1; y <= y2; y++) {
+			for (std::int32_t x = x1; x <= x2; x++) {
+				for (std::int32_t index : _staticLightGrid[x + y * _staticLightGridBounds.W]) {
+					StaticLight& staticLight = _staticLights[index];
+					if (staticLight.LastQuery != _staticLightQuery) {
+						staticLight.LastQuery = _staticLightQuery;
+						if (isVisible(staticLight.Light)) {
+							lights.push_back(staticLight.Light);
+						}
+					}
+				}
+			}
+		}
+	}
+
 	void LevelHandler::AssignViewport(Actors::Player* player)
 	{
 		_assignedViewports.emplace_back(std::make_unique<PlayerViewport>(this, player));
@@ -1932,6 +2166,11 @@ namespace Jazz2
 	{
 		ZoneScopedC(0x4876AF);
 
+		if (ContentResolver::Get().IsHeadless()) {
+			// There are no local players and no input devices in headless mode
+			return;
+		}
+
 		auto& input = theApplication().GetInputManager();
 
 		const JoyMappedState* joyStates[UI::ControlScheme::MaxConnectedGamepads];
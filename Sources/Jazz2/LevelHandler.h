@@ -213,6 +213,30 @@ namespace Jazz2
 		std::unique_ptr<Tiles::TileMap> _tileMap;
 		Collisions::DynamicTreeBroadPhase _collisions;
 
+		/** @brief Size of a bucket of event-spawned actors (by origin tile) in tiles */
+		static constexpr std::int32_t DeactivationBucketSize = 8;
+
+		SmallVector<SmallVector<Actors::ActorBase*, 0>, 0> _deactivationBuckets;
+		std::int32_t _deactivationBucketsPerRow;
+		std::int32_t _deactivationChecksCount;
+
+		/** @brief Size of a cell of the static light grid in pixels */
+		static constexpr std::int32_t LightGridCellSize = 256;
+
+		struct StaticLight {
+			Actors::ActorBase* Owner;
+			LightEmitter Light;
+			std::uint32_t LastQuery;
+		};
+
+		SmallVector<StaticLight, 0> _staticLights;
+		SmallVector<SmallVector<std::int32_t, 0>, 0> _staticLightGrid;	// Indices of static lights which intersect each cell
+		Recti _staticLightGridBounds;		// Bounds of the static light grid in cells
+		bool _staticLightGridDirty;
+		std::uint32_t _staticLightQuery;
+		SmallVector<LightEmitter, 0> _dynamicLights;	// Lights emitted by other actors in the current frame, shared by all viewports
+		unsigned long int _dynamicLightsFrame;
+
 		Vector2i _viewSize;
 		Rectf _viewBoundsTarget;
 		float _elapsedFrames;
@@ -247,6 +271,11 @@ namespace Jazz2
 		Recti GetPlayerViewportBounds(std::int32_t w, std::int32_t h, std::int32_t index);
 		void ProcessWeather(float timeMult);
 		void ResolveCollisions(float timeMult);
+		SmallVector<Actors::ActorBase*, 0>* GetDeactivationBucket(const Vector2i& originTile);
+		void AddStaticLights(Actors::ActorBase* actor);
+		void RemoveStaticLights(Actors::ActorBase* actor);
+		void RebuildStaticLightGrid();
+		void QueryVisibleLights(const Rectf& bounds, SmallVectorImpl<LightEmitter>& lights);
 		void AssignViewport(Actors::Player* player);
 		void InitializeCamera(PlayerViewport& viewport);
 		void UpdatePressedActions();
@@ -54,11 +54,13 @@ namespace Jazz2::Multiplayer
 {
 	MultiLevelHandler::MultiLevelHandler(IRootController* root, NetworkManager* networkManager)
 		: LevelHandler(root), _gameMode(MultiplayerGameMode::Unknown), _networkManager(networkManager), _updateTimeLeft(1.0f),
-			_initialUpdateSent(false), _lastSpawnedActorId(-1), _seqNum(0), _seqNumWarped(0), _suppressRemoting(false),
-			_ignorePackets(false)
+			_statsTimeLeft(FrameTimer::FramesPerSecond), _initialUpdateSent(false), _lastSpawnedActorId(-1), _seqNum(0), _seqNumWarped(0),
+			_lastSnapshotSeqNum(0), _ackedSnapshotSeqNum(0), _lastServerTime(0), _serverTimeOffset(0),
+			_snapshotInterval(1000.0f / UpdatesPerSecond), _snapshotJitter(0.0f), _interpolationDelay(MinInterpolationDelay), _tileMapVersion(0), _tileMapStateVersion(0), _tileMapSynchronized(false),
+			_suppressRemoting(false), _ignorePackets(false), _actorsCulled(0)
 #if defined(DEATH_DEBUG) && defined(WITH_IMGUI)
 			, _plotIndex(0), _actorsMaxCount(0.0f), _actorsCount{}, _remoteActorsCount{}, _remotingActorsCount{},
-			_mirroredActorsCount{}, _updatePacketMaxSize(0.0f), _updatePacketSize {}, _compressedUpdatePacketSize {}
+			_mirroredActorsCount{}, _culledActorsCount{}, _updatePacketMaxSize(0.0f), _updatePacketSize{}, _compressedUpdatePacketSize{}
 #endif
 	{
 		_isServer = (networkManager->GetState() == NetworkState::Listening);
@@ -146,6 +148,20 @@ namespace Jazz2::Multiplayer
 			playerState.PressedKeysLast |= playerState.PressedKeys;
 		}
 
+		if (_isServer) {
+			_statsTimeLeft -= timeMult;
+			if (_statsTimeLeft < 0.0f) {
+				_statsTimeLeft += FrameTimer::FramesPerSecond;
+
+				for (auto& [peer, peerDesc] : _peerDesc) {
+					peerDesc.BytesPerSecond = peerDesc.BytesSent;
+					peerDesc.BytesSent = 0;
+				}
+			}
+
+			SendTileMapChunks();
+		}
+
 		_updateTimeLeft -= timeMult;
 		if (_updateTimeLeft < 0.0f) {
 			_updateTimeLeft = FrameTimer::FramesPerSecond / UpdatesPerSecond;
@@ -186,104 +202,7 @@ namespace Jazz2::Multiplayer
 #endif
 
 			if (_isServer) {
-				std::uint32_t actorCount = (std::uint32_t)(_players.size() + _remotingActors.size());
-
-				MemoryStream packet(5 + actorCount * 19);
-				//packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::UpdateAllActors);
-				packet.WriteVariableUint32(actorCount);
-
-				for (Actors::Player* player : _players) {
-					/*Vector2f pos;
-					auto it = _playerStates.find(player->_playerIndex);
-					if (it != _playerStates.end()) {
-						// Remote players
-						pos = player->_pos;
-
-						// TODO: This should be WarpUpdatesLeft
-						if (it->second.WarpTimeLeft > 0.0f) {
-							it->second.WarpTimeLeft -= timeMult;
-							if (it->second.WarpTimeLeft <= 0.0f) {
-								it->second.WarpTimeLeft = 0.0f;
-								LOGW("Player warped without permission (possible cheating attempt)");
-							}
-						} else if (it->second.WarpTimeLeft < 0.0f) {
-							it->second.WarpTimeLeft += timeMult;
-							if (it->second.WarpTimeLeft >= 0.0f) {
-								it->second.WarpTimeLeft = 0.0f;
-								LOGW("Player failed to warp in time (possible cheating attempt)");
-							}
-						}
-					} else {
-						// Local players
-						pos = player->_pos;
-					}*/
-					Vector2f pos = player->_pos;
-
-					packet.WriteVariableUint32(player->_playerIndex);
-					packet.WriteValue<std::int32_t>((std::int32_t)(pos.X * 512.0f));
-					packet.WriteValue<std::int32_t>((std::int32_t)(pos.Y * 512.0f));
-					packet.WriteVariableUint32((std::uint32_t)(player->_currentTransition != nullptr ? player->_currentTransition->State : player->_currentAnimation->State));
-
-					float rotation = player->_renderer.rotation();
-					if (rotation < 0.0f) rotation += fRadAngle360;
-					packet.WriteValue<std::uint8_t>((std::uint8_t)(rotation * 255.0f / fRadAngle360));
-
-					std::uint8_t flags = 0;
-					if (player->IsFacingLeft()) {
-						flags |= 0x01;
-					}
-					if (player->_renderer.isDrawEnabled()) {
-						flags |= 0x02;
-					}
-					if (player->_renderer.AnimPaused) {
-						flags |= 0x04;
-					}
-					packet.WriteValue<std::uint8_t>(flags);
-
-					Actors::ActorRendererType rendererType = player->_renderer.GetRendererType();
-					packet.WriteValue<std::uint8_t>((std::uint8_t)rendererType);
-				}
-
-				for (const auto& [remotingActor, remotingActorId] : _remotingActors) {
-					packet.WriteVariableUint32(remotingActorId);
-					packet.WriteValue<std::int32_t>((std::int32_t)(remotingActor->_pos.X * 512.0f));
-					packet.WriteValue<std::int32_t>((std::int32_t)(remotingActor->_pos.Y * 512.0f));
-					packet.WriteVariableUint32((std::uint32_t)(remotingActor->_currentTransition != nullptr ? remotingActor->_currentTransition->State : (remotingActor->_currentAnimation != nullptr ? remotingActor->_currentAnimation->State : AnimState::Idle)));
-					
-					float rotation = remotingActor->_renderer.rotation();
-					if (rotation < 0.0f) rotation += fRadAngle360;
-					packet.WriteValue<std::uint8_t>((std::uint8_t)(rotation * 255.0f / fRadAngle360));
-
-					std::uint8_t flags = 0;
-					if (remotingActor->IsFacingLeft()) {
-						flags |= 0x01;
-					}
-					if (remotingActor->_renderer.isDrawEnabled()) {
-						flags |= 0x02;
-					}
-					if (remotingActor->_renderer.AnimPaused) {
-						flags |= 0x04;
-					}
-					packet.WriteValue<std::uint8_t>(flags);
-
-					Actors::ActorRendererType rendererType = remotingActor->_renderer.GetRendererType();
-					packet.WriteValue<std::uint8_t>((std::uint8_t)rendererType);
-				}
-
-				MemoryStream packetCompressed(1024);
-				packetCompressed.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::UpdateAllActors);
-				DeflateWriter dw(packetCompressed);
-				dw.Write(packet.GetBuffer(), packet.GetSize());
-				dw.Dispose();
-
-#if defined(DEATH_DEBUG) && defined(WITH_IMGUI)
-				_updatePacketSize[_plotIndex] = packet.GetSize();
-				_updatePacketMaxSize = std::max(_updatePacketMaxSize, _updatePacketSize[_plotIndex]);
-				_compressedUpdatePacketSize[_plotIndex] = packetCompressed.GetSize();
-#endif
-
-				_networkManager->SendToAll(NetworkChannel::UnreliableUpdates, packetCompressed.GetBuffer(), packetCompressed.GetSize());
-
+				SendActorUpdates();
 				SynchronizePeers();
 			} else {
 				if (!_players.empty()) {
@@ -307,7 +226,7 @@ namespace Jazz2::Multiplayer
 						flags |= PlayerFlags::JustWarped;
 					}
 
-					MemoryStream packet(20);
+					MemoryStream packet(29);
 					packet.WriteValue<std::uint8_t>((std::uint8_t)ClientPacketType::PlayerUpdate);
 					packet.WriteVariableUint32(_lastSpawnedActorId);
 					packet.WriteVariableUint64(now);
@@ -316,6 +235,10 @@ namespace Jazz2::Multiplayer
 					packet.WriteValue<std::int16_t>((std::int16_t)(player->_speed.X * 512.0f));
 					packet.WriteValue<std::int16_t>((std::int16_t)(player->_speed.Y * 512.0f));
 					packet.WriteVariableUint32((std::uint32_t)flags);
+					packet.WriteVariableUint64(_ackedSnapshotSeqNum);
+
+					// The position is predicted locally, the server acknowledges it later with the next snapshot
+					static_cast<Actors::Multiplayer::RemotablePlayer*>(player)->RecordPredictedState(now);
 
 					if (_seqNumWarped != 0) {
 						packet.WriteVariableUint64(_seqNumWarped);
@@ -332,9 +255,13 @@ namespace Jazz2::Multiplayer
 		}
 
 #if defined(DEATH_DEBUG) && defined(WITH_IMGUI)
-		ShowDebugWindow();
+		// ImGui is not available in headless mode
+		bool isHeadless = ContentResolver::Get().IsHeadless();
+		if (!isHeadless) {
+			ShowDebugWindow();
+		}
 
-		if (PreferencesCache::ShowPerformanceMetrics) {
+		if (PreferencesCache::ShowPerformanceMetrics && !isHeadless) {
 			ImDrawList* drawList = ImGui::GetBackgroundDrawList();
 
 			/*if (_isServer) {
@@ -492,22 +419,22 @@ namespace Jazz2::Multiplayer
 			}
 
 			if (actorId != UINT32_MAX) {
+				// The same message is sent to all peers, it's copied to their batches
+				MemoryStream packet(13 + identifier.size());
+				packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::PlaySfx);
+				packet.WriteVariableUint32(actorId);
+				// TODO: sourceRelative
+				// TODO: looping
+				packet.WriteValue<std::uint16_t>(floatToHalf(gain));
+				packet.WriteValue<std::uint16_t>(floatToHalf(pitch));
+				packet.WriteVariableUint32((std::uint32_t)identifier.size());
+				packet.Write(identifier.data(), (std::uint32_t)identifier.size());
+
 				for (const auto& [peer, peerDesc] : _peerDesc) {
 					if (self == peerDesc.Player) {
 						continue;
 					}
 
-					MemoryStream packet(13 + identifier.size());
-					packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::PlaySfx);
-					packet.WriteVariableUint32(actorId);
-					// TODO: sourceRelative
-					// TODO: looping
-					packet.WriteValue<std::uint16_t>(floatToHalf(gain));
-					packet.WriteValue<std::uint16_t>(floatToHalf(pitch));
-					packet.WriteVariableUint32((std::uint32_t)identifier.size());
-					packet.Write(identifier.data(), (std::uint32_t)identifier.size());
-
-					// TODO: If it fails, it will release the packet which is wrong
 					_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetSize());
 				}
 			}
@@ -519,18 +446,18 @@ namespace Jazz2::Multiplayer
 	std::shared_ptr<AudioBufferPlayer> MultiLevelHandler::PlayCommonSfx(const StringView identifier, const Vector3f& pos, float gain, float pitch)
 	{
 		if (_isServer) {
-			for (const auto& [peer, peerDesc] : _peerDesc) {
-				MemoryStream packet(14 + identifier.size());
-				packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::PlayCommonSfx);
-				packet.WriteVariableInt32((std::int32_t)pos.X);
-				packet.WriteVariableInt32((std::int32_t)pos.Y);
-				// TODO: looping
-				packet.WriteValue<std::uint16_t>(floatToHalf(gain));
-				packet.WriteValue<std::uint16_t>(floatToHalf(pitch));
-				packet.WriteVariableUint32((std::uint32_t)identifier.size());
-				packet.Write(identifier.data(), (std::uint32_t)identifier.size());
+			// The same message is sent to all peers, it's copied to their batches
+			MemoryStream packet(14 + identifier.size());
+			packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::PlayCommonSfx);
+			packet.WriteVariableInt32((std::int32_t)pos.X);
+			packet.WriteVariableInt32((std::int32_t)pos.Y);
+			// TODO: looping
+			packet.WriteValue<std::uint16_t>(floatToHalf(gain));
+			packet.WriteValue<std::uint16_t>(floatToHalf(pitch));
+			packet.WriteVariableUint32((std::uint32_t)identifier.size());
+			packet.Write(identifier.data(), (std::uint32_t)identifier.size());
 
-				// TODO: If it fails, it will release the packet which is wrong
+			for (const auto& [peer, peerDesc] : _peerDesc) {
 				_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetSize());
 			}
 		}
@@ -603,7 +530,8 @@ namespace Jazz2::Multiplayer
 						flags |= 0x02;
 					}
 
-					MemoryStream packet(18);
+					std::uint8_t packetBuffer[19];
+					MemoryStream packet(packetBuffer, sizeof(packetBuffer));
 					packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::PlayerActivateSpring);
 					packet.WriteVariableUint32(player->_playerIndex);
 					packet.WriteValue<std::int32_t>((std::int32_t)(pos.X * 512.0f));
@@ -611,7 +539,7 @@ namespace Jazz2::Multiplayer
 					packet.WriteValue<std::int16_t>((std::int16_t)(force.X * 512.0f));
 					packet.WriteValue<std::int16_t>((std::int16_t)(force.Y * 512.0f));
 					packet.WriteValue<std::uint8_t>(flags);
-					_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetSize());
+					_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetPosition());
 					break;
 				}
 			}
@@ -637,10 +565,11 @@ namespace Jazz2::Multiplayer
 
 		for (const auto& [peer, peerDesc] : _peerDesc) {
 			if (peerDesc.Player == player) {
-				MemoryStream packet(5);
+				std::uint8_t packetBuffer[6];
+				MemoryStream packet(packetBuffer, sizeof(packetBuffer));
 				packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::PlayerWarpIn);
 				packet.WriteVariableUint32(player->_playerIndex);
-				_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetSize());
+				_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetPosition());
 				break;
 			}
 		}
@@ -652,12 +581,13 @@ namespace Jazz2::Multiplayer
 		if (_isServer) {
 			for (const auto& [peer, peerDesc] : _peerDesc) {
 				if (peerDesc.Player == player) {
-					MemoryStream packet(11);
+					std::uint8_t packetBuffer[13];
+					MemoryStream packet(packetBuffer, sizeof(packetBuffer));
 					packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::PlayerTakeDamage);
 					packet.WriteVariableUint32(player->_playerIndex);
 					packet.WriteVariableInt32(player->_health);
 					packet.WriteValue<std::int16_t>((std::int16_t)(pushForce * 512.0f));
-					_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetSize());
+					_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetPosition());
 					break;
 				}
 			}
@@ -670,12 +600,13 @@ namespace Jazz2::Multiplayer
 		if (_isServer) {
 			for (const auto& [peer, peerDesc] : _peerDesc) {
 				if (peerDesc.Player == player) {
-					MemoryStream packet(8);
+					std::uint8_t packetBuffer[9];
+					MemoryStream packet(packetBuffer, sizeof(packetBuffer));
 					packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::PlayerRefreshAmmo);
 					packet.WriteVariableUint32(player->_playerIndex);
 					packet.WriteValue<std::uint8_t>((std::uint8_t)player->_currentWeapon);
 					packet.WriteValue<std::uint16_t>((std::uint16_t)player->_weaponAmmo[(std::uint8_t)player->_currentWeapon]);
-					_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetSize());
+					_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetPosition());
 					break;
 				}
 			}
@@ -688,12 +619,13 @@ namespace Jazz2::Multiplayer
 		if (_isServer) {
 			for (const auto& [peer, peerDesc] : _peerDesc) {
 				if (peerDesc.Player == player) {
-					MemoryStream packet(7);
+					std::uint8_t packetBuffer[8];
+					MemoryStream packet(packetBuffer, sizeof(packetBuffer));
 					packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::PlayerRefreshWeaponUpgrades);
 					packet.WriteVariableUint32(player->_playerIndex);
 					packet.WriteValue<std::uint8_t>((std::uint8_t)player->_currentWeapon);
 					packet.WriteValue<std::uint8_t>((std::uint8_t)player->_weaponUpgrades[(std::uint8_t)player->_currentWeapon]);
-					_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetSize());
+					_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetPosition());
 					break;
 				}
 			}
@@ -706,11 +638,12 @@ namespace Jazz2::Multiplayer
 		if (_isServer) {
 			for (const auto & [peer, peerDesc] : _peerDesc) {
 				if (peerDesc.Player == player) {
-					MemoryStream packet(6);
+					std::uint8_t packetBuffer[7];
+					MemoryStream packet(packetBuffer, sizeof(packetBuffer));
 					packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::PlayerChangeWeapon);
 					packet.WriteVariableUint32(player->_playerIndex);
 					packet.WriteValue<std::uint8_t>((std::uint8_t)player->_currentWeapon);
-					_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetSize());
+					_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetPosition());
 					break;
 				}
 			}
@@ -733,14 +666,15 @@ namespace Jazz2::Multiplayer
 		if (_isServer) {
 			for (const auto& [peer, peerDesc] : _peerDesc) {
 				if (peerDesc.Player == player) {
-					MemoryStream packet(17);
+					std::uint8_t packetBuffer[18];
+					MemoryStream packet(packetBuffer, sizeof(packetBuffer));
 					packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::PlayerMoveInstantly);
 					packet.WriteVariableUint32(player->_playerIndex);
 					packet.WriteValue<std::int32_t>((std::int32_t)(player->_pos.X * 512.0f));
 					packet.WriteValue<std::int32_t>((std::int32_t)(player->_pos.Y * 512.0f));
 					packet.WriteValue<std::int16_t>((std::int16_t)(player->_speed.X * 512.0f));
 					packet.WriteValue<std::int16_t>((std::int16_t)(player->_speed.Y * 512.0f));
-					_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetSize());
+					_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetPosition());
 					break;
 				}
 			}
@@ -754,11 +688,12 @@ namespace Jazz2::Multiplayer
 		if (_isServer) {
 			for (const auto& [peer, peerDesc] : _peerDesc) {
 				if (peerDesc.Player == player) {
-					MemoryStream packet(9);
+					std::uint8_t packetBuffer[11];
+					MemoryStream packet(packetBuffer, sizeof(packetBuffer));
 					packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::PlayerRefreshCoins);
 					packet.WriteVariableUint32(player->_playerIndex);
 					packet.WriteVariableInt32(newCount);
-					_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetSize());
+					_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetPosition());
 					break;
 				}
 			}
@@ -772,11 +707,12 @@ namespace Jazz2::Multiplayer
 		if (_isServer) {
 			for (const auto& [peer, peerDesc] : _peerDesc) {
 				if (peerDesc.Player == player) {
-					MemoryStream packet(9);
+					std::uint8_t packetBuffer[11];
+					MemoryStream packet(packetBuffer, sizeof(packetBuffer));
 					packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::PlayerRefreshGems);
 					packet.WriteVariableUint32(player->_playerIndex);
 					packet.WriteVariableInt32(newCount);
-					_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetSize());
+					_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetPosition());
 					break;
 				}
 			}
@@ -917,13 +853,17 @@ namespace Jazz2::Multiplayer
 	void MultiLevelHandler::OnAdvanceDestructibleTileAnimation(std::int32_t tx, std::int32_t ty, std::int32_t amount)
 	{
 		if (_isServer) {
-			MemoryStream packet(13);
+			_tileMapVersion++;
+
+			std::uint8_t packetBuffer[21];
+			MemoryStream packet(packetBuffer, sizeof(packetBuffer));
 			packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::AdvanceTileAnimation);
+			packet.WriteVariableUint32(_tileMapVersion);
 			packet.WriteVariableInt32(tx);
 			packet.WriteVariableInt32(ty);
 			packet.WriteVariableInt32(amount);
 
-			_networkManager->SendToAll(NetworkChannel::Main, packet.GetBuffer(), packet.GetSize());
+			_networkManager->SendToAll(NetworkChannel::Main, packet.GetBuffer(), packet.GetPosition());
 		}
 	}
 
@@ -1121,6 +1061,8 @@ namespace Jazz2::Multiplayer
 					float speedX = packet.ReadValue<std::int16_t>() / 512.0f;
 					float speedY = packet.ReadValue<std::int16_t>() / 512.0f;
 					PlayerFlags flags = (PlayerFlags)packet.ReadVariableUint32();
+					// Next snapshot is encoded as delta against this one, or it's full if zero
+					it->second.AckedSnapshotSeqNum = packet.ReadVariableUint64();
 
 					/*bool justWarped = (flags & PlayerFlags::JustWarped) == PlayerFlags::JustWarped;
 					if (justWarped) {
@@ -1372,37 +1314,56 @@ namespace Jazz2::Multiplayer
 				case ServerPacketType::UpdateAllActors: {
 					MemoryStream packetCompressed(data + 1, dataLength - 1);
 					DeflateStream packet(packetCompressed);
-					std::uint32_t actorCount = packet.ReadVariableUint32();
-					for (std::uint32_t i = 0; i < actorCount; i++) {
-						std::uint32_t index = packet.ReadVariableUint32();
-						float posX = packet.ReadValue<std::int32_t>() / 512.0f;
-						float posY = packet.ReadValue<std::int32_t>() / 512.0f;
-						std::uint32_t anim = packet.ReadVariableUint32();
-						float rotation = packet.ReadValue<std::uint8_t>() * fRadAngle360 / 255.0f;
-						std::uint8_t flags = packet.ReadValue<std::uint8_t>();
-						Actors::ActorRendererType rendererType = (Actors::ActorRendererType)packet.ReadValue<std::uint8_t>();
-
-						auto it = _remoteActors.find(index);
-						if (it != _remoteActors.end()) {
-							if (auto* remoteActor = runtime_cast<Actors::Multiplayer::RemoteActor*>(it->second)) {
-								remoteActor->SyncWithServer(Vector2f(posX, posY), (AnimState)anim, rotation,
-									(flags & 0x02) != 0, (flags & 0x01) != 0, (flags & 0x04) != 0, rendererType);
-							}
-						}
-					}
+					ReceiveActorUpdates(packet);
 					return true;
 				}
 				case ServerPacketType::SyncTileMap: {
 					MemoryStream packet(data + 1, dataLength - 1);
+					std::uint32_t version = packet.ReadVariableUint32();
+					std::uint32_t totalSize = packet.ReadVariableUint32();
+					std::uint32_t offset = packet.ReadVariableUint32();
+					std::int64_t chunkOffset = packet.GetPosition();
 
-					LOGD("ServerPacketType::SyncTileMap received");
+					if (offset == 0) {
+						_tileMapTransfer = std::make_shared<MemoryStream>(totalSize);
+					}
+					if (_tileMapTransfer == nullptr || _tileMapTransfer->GetSize() != offset) {
+						LOGW("ServerPacketType::SyncTileMap received with unexpected offset %u", offset);
+						return true;
+					}
 
-					// TODO: No lock here ???
-					TileMap()->InitializeFromStream(packet);
+					_tileMapTransfer->Write(data + 1 + chunkOffset, (std::int64_t)dataLength - 1 - chunkOffset);
+					if (_tileMapTransfer->GetSize() < totalSize) {
+						return true;
+					}
+
+					LOGD("ServerPacketType::SyncTileMap received - version: %u, size: %u", version, totalSize);
+
+					std::shared_ptr<MemoryStream> state = std::move(_tileMapTransfer);
+					_root->InvokeAsync([this, state]() {
+						state->Seek(0, SeekOrigin::Begin);
+						DeflateStream stateStream(*state);
+						TileMap()->InitializeFromStream(stateStream);
+					});
+
+					_tileMapVersion = version;
+					_tileMapSynchronized = true;
+
+					// Changes received in the meantime are applied only if they are newer than the received state
+					auto pendingChanges = std::move(_pendingTileMapChanges);
+					_pendingTileMapChanges.clear();
+					for (auto& pendingChange : pendingChanges) {
+						OnPacketReceived(peer, channelId, pendingChange.data(), pendingChange.size());
+					}
 					return true;
 				}
 				case ServerPacketType::SetTrigger: {
 					MemoryStream packet(data + 1, dataLength - 1);
+					std::uint32_t version = packet.ReadVariableUint32();
+					if (!ShouldApplyTileMapChange(version, data, dataLength)) {
+						return true;
+					}
+
 					std::uint8_t triggerId = packet.ReadValue<std::uint8_t>();
 					bool newState = (bool)packet.ReadValue<std::uint8_t>();
 
@@ -1415,6 +1376,11 @@ namespace Jazz2::Multiplayer
 				}
 				case ServerPacketType::AdvanceTileAnimation: {
 					MemoryStream packet(data + 1, dataLength - 1);
+					std::uint32_t version = packet.ReadVariableUint32();
+					if (!ShouldApplyTileMapChange(version, data, dataLength)) {
+						return true;
+					}
+
 					std::int32_t tx = packet.ReadVariableInt32();
 					std::int32_t ty = packet.ReadVariableInt32();
 					std::int32_t amount = packet.ReadVariableInt32();
@@ -1613,12 +1579,16 @@ namespace Jazz2::Multiplayer
 		LevelHandler::SetTrigger(triggerId, newState);
 
 		if (_isServer) {
-			MemoryStream packet(3);
+			_tileMapVersion++;
+
+			std::uint8_t packetBuffer[8];
+			MemoryStream packet(packetBuffer, sizeof(packetBuffer));
 			packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::SetTrigger);
+			packet.WriteVariableUint32(_tileMapVersion);
 			packet.WriteValue<std::uint8_t>(triggerId);
 			packet.WriteValue<std::uint8_t>(newState);
 
-			_networkManager->SendToAll(NetworkChannel::Main, packet.GetBuffer(), packet.GetSize());
+			_networkManager->SendToAll(NetworkChannel::Main, packet.GetBuffer(), packet.GetPosition());
 		}
 	}
 
@@ -1648,12 +1618,13 @@ namespace Jazz2::Multiplayer
 		std::uint32_t actorId = it->second;
 
 		for (auto& [peer, peerDesc] : _peerDesc) {
-			MemoryStream packet(5);
+			peerDesc.ActorPriorities.erase(actorId);
+
+			std::uint8_t packetBuffer[6];
+			MemoryStream packet(packetBuffer, sizeof(packetBuffer));
 			packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::DestroyRemoteActor);
 			packet.WriteVariableUint32(actorId);
-
-			// TODO: If it fails, it will release the packet which is wrong
-			_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetSize());
+			_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetPosition());
 		}
 
 		_remotingActors.erase(it);
@@ -1678,6 +1649,357 @@ namespace Jazz2::Multiplayer
 		}
 	}
 
+	void MultiLevelHandler::SendActorUpdates()
+	{
+		// Capture the state of all players and remoting actors only once, every peer then picks only relevant actors
+		_actorUpdates.clear();
+
+		auto captureActor = [this](Actors::ActorBase* actor, std::uint32_t actorId, bool isPlayer) {
+			ActorSnapshot state;
+			state.ActorId = actorId;
+			state.PosX = (std::int32_t)(actor->_pos.X * 512.0f);
+			state.PosY = (std::int32_t)(actor->_pos.Y * 512.0f);
+			state.Anim = (std::uint32_t)(actor->_currentTransition != nullptr ? actor->_currentTransition->State : (actor->_currentAnimation != nullptr ? actor->_currentAnimation->State : AnimState::Idle));
+
+			float rotation = actor->_renderer.rotation();
+			if (rotation < 0.0f) rotation += fRadAngle360;
+			state.Rotation = (std::uint8_t)(rotation * 255.0f / fRadAngle360);
+
+			state.Flags = 0;
+			if (actor->IsFacingLeft()) {
+				state.Flags |= 0x01;
+			}
+			if (actor->_renderer.isDrawEnabled()) {
+				state.Flags |= 0x02;
+			}
+			if (actor->_renderer.AnimPaused) {
+				state.Flags |= 0x04;
+			}
+
+			state.RendererType = (std::uint8_t)actor->_renderer.GetRendererType();
+
+			_actorUpdates.push_back(ActorUpdate { actor, state, isPlayer });
+		};
+
+		for (Actors::Player* player : _players) {
+			captureActor(player, player->_playerIndex, true);
+		}
+		for (const auto& [remotingActor, remotingActorId] : _remotingActors) {
+			captureActor(remotingActor, remotingActorId, false);
+		}
+
+		Clock& c = nCine::clock();
+		std::uint64_t now = c.now() * 1000 / c.frequency();
+
+		// Snapshots are sorted by actor ID, so they can be compared with baselines in a single pass
+		std::sort(_actorUpdates.begin(), _actorUpdates.end(), [](const ActorUpdate& a, const ActorUpdate& b) {
+			return a.State.ActorId < b.State.ActorId;
+		});
+
+		auto actorExists = [this](std::uint32_t actorId) {
+			auto it = std::lower_bound(_actorUpdates.begin(), _actorUpdates.end(), actorId, [](const ActorUpdate& update, std::uint32_t actorId) {
+				return update.State.ActorId < actorId;
+			});
+			return (it != _actorUpdates.end() && it->State.ActorId == actorId);
+		};
+
+		// Actors inside the view of a peer are always relevant, actors inside the activation range are relevant
+		// with lower priority, the rest is culled. Every relevant actor accumulates its priority until it's sent,
+		// so nearby and fast-moving actors are sent more often if the budget is exceeded.
+		constexpr float ViewRangeX = DefaultWidth * 0.5f + Tiles::TileSet::DefaultTileSize * 2;
+		constexpr float ViewRangeY = DefaultHeight * 0.5f + Tiles::TileSet::DefaultTileSize * 2;
+		constexpr float ActivationRange = ActivateTileRange * Tiles::TileSet::DefaultTileSize;
+
+		_actorsCulled = 0;
+
+#if defined(DEATH_DEBUG) && defined(WITH_IMGUI)
+		// Sizes of packets sent to all peers are summed up, so the plot shows the total upload per update
+		_updatePacketSize[_plotIndex] = 0.0f;
+		_compressedUpdatePacketSize[_plotIndex] = 0.0f;
+#endif
+
+		for (auto& [peer, peerDesc] : _peerDesc) {
+			if (peerDesc.State != PeerState::LevelSynchronized || peerDesc.Player == nullptr) {
+				continue;
+			}
+
+			Vector2f viewPos = peerDesc.Player->_pos;
+			std::uint32_t actorsCulled = 0;
+			_relevantActors.clear();
+			_snapshotActors.clear();
+
+			for (std::int32_t i = 0; i < (std::int32_t)_actorUpdates.size(); i++) {
+				const ActorUpdate& update = _actorUpdates[i];
+				if (update.IsPlayer) {
+					_snapshotActors.push_back(update.State);
+					continue;
+				}
+
+				float dx = std::abs(update.Actor->_pos.X - viewPos.X);
+				float dy = std::abs(update.Actor->_pos.Y - viewPos.Y);
+				if (dx > ActivationRange || dy > ActivationRange) {
+					peerDesc.ActorPriorities.erase(update.State.ActorId);
+					actorsCulled++;
+					continue;
+				}
+
+				float priority = (dx <= ViewRangeX && dy <= ViewRangeY ? ViewActorPriority : NearbyActorPriority);
+				priority += update.Actor->_speed.Length() * SpeedActorPriority;
+
+				float& accumulatedPriority = peerDesc.ActorPriorities[update.State.ActorId];
+				accumulatedPriority += priority;
+				_relevantActors.push_back(RelevantActor { accumulatedPriority, i });
+			}
+
+			if (_relevantActors.size() > MaxActorUpdatesPerPeer) {
+				std::nth_element(_relevantActors.begin(), _relevantActors.begin() + MaxActorUpdatesPerPeer, _relevantActors.end(), [](const RelevantActor& a, const RelevantActor& b) {
+					return a.Priority > b.Priority;
+				});
+				actorsCulled += (std::uint32_t)(_relevantActors.size() - MaxActorUpdatesPerPeer);
+				_relevantActors.resize(MaxActorUpdatesPerPeer);
+			}
+
+			for (const RelevantActor& relevant : _relevantActors) {
+				const ActorUpdate& update = _actorUpdates[relevant.UpdateIndex];
+				_snapshotActors.push_back(update.State);
+				peerDesc.ActorPriorities[update.State.ActorId] = 0.0f;
+			}
+
+			std::sort(_snapshotActors.begin(), _snapshotActors.end(), [](const ActorSnapshot& a, const ActorSnapshot& b) {
+				return a.ActorId < b.ActorId;
+			});
+
+			// The snapshot is encoded as delta against the last snapshot acknowledged by the peer. If the peer hasn't
+			// acknowledged any snapshot recently (e.g., because of packet loss), a full snapshot is sent instead.
+			if (peerDesc.Snapshots.empty()) {
+				peerDesc.Snapshots.resize(SnapshotHistoryCount);
+			}
+
+			std::uint64_t seqNum = ++peerDesc.LastSnapshotSeqNum;
+			const Snapshot* baseline = nullptr;
+			if (peerDesc.AckedSnapshotSeqNum != 0 && seqNum - peerDesc.AckedSnapshotSeqNum < SnapshotHistoryCount) {
+				const Snapshot& ackedSnapshot = peerDesc.Snapshots[peerDesc.AckedSnapshotSeqNum % SnapshotHistoryCount];
+				if (ackedSnapshot.SeqNum == peerDesc.AckedSnapshotSeqNum) {
+					baseline = &ackedSnapshot;
+				}
+			}
+
+			Snapshot& snapshot = peerDesc.Snapshots[seqNum % SnapshotHistoryCount];
+			snapshot.SeqNum = seqNum;
+			snapshot.Actors.clear();
+
+			// Both streams keep their capacity, so only the written part (up to the current position) is valid
+			_snapshotRecords.Seek(0, SeekOrigin::Begin);
+			std::uint32_t recordCount = 0;
+			std::size_t baselineIndex = 0;
+
+			for (const ActorSnapshot& state : _snapshotActors) {
+				const ActorSnapshot* baselineState = nullptr;
+				if (baseline != nullptr) {
+					// Actors that were not sent this time are still known to the peer, so keep them unless they were destroyed
+					while (baselineIndex < baseline->Actors.size() && baseline->Actors[baselineIndex].ActorId < state.ActorId) {
+						const ActorSnapshot& skippedState = baseline->Actors[baselineIndex++];
+						if (actorExists(skippedState.ActorId)) {
+							snapshot.Actors.push_back(skippedState);
+						}
+					}
+					if (baselineIndex < baseline->Actors.size() && baseline->Actors[baselineIndex].ActorId == state.ActorId) {
+						baselineState = &baseline->Actors[baselineIndex++];
+					}
+				}
+
+				if (WriteActorSnapshot(_snapshotRecords, state, baselineState)) {
+					recordCount++;
+				}
+				snapshot.Actors.push_back(state);
+			}
+
+			if (baseline != nullptr) {
+				for (; baselineIndex < baseline->Actors.size(); baselineIndex++) {
+					const ActorSnapshot& skippedState = baseline->Actors[baselineIndex];
+					if (actorExists(skippedState.ActorId)) {
+						snapshot.Actors.push_back(skippedState);
+					}
+				}
+			}
+
+			std::int64_t recordsSize = _snapshotRecords.GetPosition();
+			_snapshotPacket.Seek(0, SeekOrigin::Begin);
+			_snapshotPacket.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::UpdateAllActors);
+			DeflateWriter dw(_snapshotPacket);
+			dw.WriteVariableUint64(seqNum);
+			dw.WriteVariableUint64(baseline != nullptr ? baseline->SeqNum : 0);
+			// Server time is used by clients to interpolate, the last processed player update is used to reconcile prediction
+			dw.WriteVariableUint64(now);
+			dw.WriteVariableUint64(peerDesc.LastUpdated);
+			dw.WriteVariableUint32(recordCount);
+			dw.Write(_snapshotRecords.GetBuffer(), (std::int32_t)recordsSize);
+			dw.Dispose();
+
+			std::int64_t packetSize = _snapshotPacket.GetPosition();
+
+#if defined(DEATH_DEBUG) && defined(WITH_IMGUI)
+			_updatePacketSize[_plotIndex] += recordsSize;
+			_compressedUpdatePacketSize[_plotIndex] += packetSize;
+#endif
+
+			_networkManager->SendToPeer(peer, NetworkChannel::UnreliableUpdates, _snapshotPacket.GetBuffer(), packetSize);
+
+			peerDesc.BytesSent += (std::uint32_t)packetSize;
+			peerDesc.ActorsCulled = actorsCulled;
+			_actorsCulled += actorsCulled;
+		}
+
+#if defined(DEATH_DEBUG) && defined(WITH_IMGUI)
+		_updatePacketMaxSize = std::max(_updatePacketMaxSize, _updatePacketSize[_plotIndex]);
+		_culledActorsCount[_plotIndex] = _actorsCulled;
+#endif
+	}
+
+	void MultiLevelHandler::ReceiveActorUpdates(Stream& packet)
+	{
+		std::uint64_t seqNum = packet.ReadVariableUint64();
+		std::uint64_t baselineSeqNum = packet.ReadVariableUint64();
+		std::uint64_t serverTime = packet.ReadVariableUint64();
+		std::uint64_t ackedPlayerTime = packet.ReadVariableUint64();
+		if (seqNum <= _lastSnapshotSeqNum) {
+			// Snapshot arrived out of order, a newer one was already applied
+			return;
+		}
+
+		Clock& c = nCine::clock();
+		std::int64_t now = c.now() * 1000 / c.frequency();
+		std::int64_t offset = now - (std::int64_t)serverTime;
+		if (_lastServerTime == 0) {
+			_serverTimeOffset = offset;
+		} else {
+			// The offset quickly follows snapshots that arrived earlier than expected and slowly follows delayed ones,
+			// so it converges to the lowest latency and the rest is considered jitter
+			std::int64_t deviation = offset - _serverTimeOffset;
+			_snapshotJitter += ((float)std::abs(deviation) - _snapshotJitter) * 0.1f;
+			_snapshotInterval += ((float)(serverTime - _lastServerTime) - _snapshotInterval) * 0.1f;
+			_serverTimeOffset += (deviation < 0 ? deviation / 2 : (deviation + 31) / 32);
+		}
+		_lastServerTime = serverTime;
+
+		// Remote actors are rendered one snapshot interval plus jitter in the past, so a newer state is almost always available
+		_interpolationDelay = std::clamp((std::int64_t)(_snapshotInterval + _snapshotJitter * 2.0f), MinInterpolationDelay, MaxInterpolationDelay);
+		std::int64_t snapshotTime = (std::int64_t)serverTime + _serverTimeOffset;
+
+		if (_receivedSnapshots.empty()) {
+			_receivedSnapshots.resize(SnapshotHistoryCount);
+		}
+
+		const Snapshot* baseline = nullptr;
+		if (baselineSeqNum != 0) {
+			const Snapshot& baselineSnapshot = _receivedSnapshots[baselineSeqNum % SnapshotHistoryCount];
+			if (baselineSnapshot.SeqNum != baselineSeqNum || seqNum - baselineSeqNum >= SnapshotHistoryCount) {
+				LOGW("Snapshot #%llu received with unknown baseline #%llu, requesting full snapshot", seqNum, baselineSeqNum);
+				_ackedSnapshotSeqNum = 0;
+				return;
+			}
+			baseline = &baselineSnapshot;
+		}
+
+		std::uint32_t recordCount = packet.ReadVariableUint32();
+		std::size_t baselineIndex = 0;
+		_snapshotActors.clear();
+
+		for (std::uint32_t i = 0; i < recordCount; i++) {
+			std::uint32_t actorId = packet.ReadVariableUint32();
+			ActorSnapshotFields fields = (ActorSnapshotFields)packet.ReadValue<std::uint8_t>();
+
+			// Records are sorted by actor ID, so unchanged actors in between can be copied from the baseline
+			if (baseline != nullptr) {
+				while (baselineIndex < baseline->Actors.size() && baseline->Actors[baselineIndex].ActorId < actorId) {
+					_snapshotActors.push_back(baseline->Actors[baselineIndex++]);
+				}
+			}
+
+			const ActorSnapshot* baselineState = nullptr;
+			if (baseline != nullptr && baselineIndex < baseline->Actors.size() && baseline->Actors[baselineIndex].ActorId == actorId) {
+				baselineState = &baseline->Actors[baselineIndex++];
+			}
+
+			ActorSnapshot state = {};
+			if ((fields & ActorSnapshotFields::IsFull) != ActorSnapshotFields::IsFull) {
+				if (baselineState == nullptr) {
+					LOGW("Snapshot #%llu contains delta of actor %u that is not in baseline #%llu, requesting full snapshot", seqNum, actorId, baselineSeqNum);
+					_ackedSnapshotSeqNum = 0;
+					return;
+				}
+				state = *baselineState;
+			}
+			state.ActorId = actorId;
+
+			if ((fields & ActorSnapshotFields::PosX) == ActorSnapshotFields::PosX) {
+				state.PosX += packet.ReadVariableInt32();
+			}
+			if ((fields & ActorSnapshotFields::PosY) == ActorSnapshotFields::PosY) {
+				state.PosY += packet.ReadVariableInt32();
+			}
+			if ((fields & ActorSnapshotFields::Anim) == ActorSnapshotFields::Anim) {
+				state.Anim = packet.ReadVariableUint32();
+			}
+			if ((fields & ActorSnapshotFields::Rotation) == ActorSnapshotFields::Rotation) {
+				state.Rotation = packet.ReadValue<std::uint8_t>();
+			}
+			if ((fields & ActorSnapshotFields::Flags) == ActorSnapshotFields::Flags) {
+				state.Flags = packet.ReadValue<std::uint8_t>();
+			}
+			if ((fields & ActorSnapshotFields::RendererType) == ActorSnapshotFields::RendererType) {
+				state.RendererType = packet.ReadValue<std::uint8_t>();
+			}
+
+			_snapshotActors.push_back(state);
+
+			auto it = _remoteActors.find(actorId);
+			if (it != _remoteActors.end()) {
+				if (auto* remoteActor = runtime_cast<Actors::Multiplayer::RemoteActor*>(it->second)) {
+					remoteActor->SyncWithServer(seqNum, snapshotTime, _interpolationDelay, Vector2f(state.PosX / 512.0f, state.PosY / 512.0f), (AnimState)state.Anim,
+						state.Rotation * fRadAngle360 / 255.0f, (state.Flags & 0x02) != 0, (state.Flags & 0x01) != 0,
+						(state.Flags & 0x04) != 0, (Actors::ActorRendererType)state.RendererType);
+				}
+			}
+		}
+
+		if (baseline != nullptr) {
+			for (; baselineIndex < baseline->Actors.size(); baselineIndex++) {
+				_snapshotActors.push_back(baseline->Actors[baselineIndex]);
+			}
+		}
+
+		Snapshot& snapshot = _receivedSnapshots[seqNum % SnapshotHistoryCount];
+		snapshot.SeqNum = seqNum;
+		std::swap(snapshot.Actors, _snapshotActors);
+
+		if (ackedPlayerTime != 0) {
+			auto it = std::lower_bound(snapshot.Actors.begin(), snapshot.Actors.end(), _lastSpawnedActorId, [](const ActorSnapshot& state, std::uint32_t actorId) {
+				return state.ActorId < actorId;
+			});
+			if (it != snapshot.Actors.end() && it->ActorId == _lastSpawnedActorId) {
+				Vector2f serverPos = Vector2f(it->PosX / 512.0f, it->PosY / 512.0f);
+				_root->InvokeAsync([this, ackedPlayerTime, serverPos]() {
+					if (!_players.empty()) {
+						static_cast<Actors::Multiplayer::RemotablePlayer*>(_players[0])->Reconcile(ackedPlayerTime, serverPos);
+					}
+				});
+			}
+		}
+
+		// Actors omitted from the snapshot won't get a newer state soon, so they must not be extrapolated
+		_root->InvokeAsync([this, seqNum]() {
+			for (auto& [actorId, actor] : _remoteActors) {
+				if (auto* remoteActor = runtime_cast<Actors::Multiplayer::RemoteActor*>(actor)) {
+					remoteActor->SetLatestSnapshot(seqNum);
+				}
+			}
+		});
+
+		_lastSnapshotSeqNum = seqNum;
+		_ackedSnapshotSeqNum = seqNum;
+	}
+
 	void MultiLevelHandler::SynchronizePeers()
 	{
 		for (auto& [peer, peerDesc] : _peerDesc) {
@@ -1714,14 +2036,10 @@ namespace Jazz2::Multiplayer
 			AddActor(player);
 			_suppressRemoting = false;
 
-			// Synchronize tilemap
-			{
-				// TODO: Use deflate compression here?
-				MemoryStream packet(20 * 1024);
-				packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::SyncTileMap);
-				_tileMap->SerializeResumableToStream(packet);
-				_networkManager->SendToPeer(peer, NetworkChannel::Main, packet.GetBuffer(), packet.GetSize());
-			}
+			// Synchronize tilemap, the compressed state is sent in chunks from SendTileMapChunks()
+			peerDesc.TileMapState = GetCompressedTileMapState();
+			peerDesc.TileMapStateVersion = _tileMapStateVersion;
+			peerDesc.TileMapStateOffset = 0;
 
 			// Spawn the player also on the remote side
 			{
@@ -1828,6 +2146,77 @@ namespace Jazz2::Multiplayer
 		}
 	}
 
+	std::shared_ptr<MemoryStream> MultiLevelHandler::GetCompressedTileMapState()
+	{
+		// The state is compressed only once and shared by all peers that join until the tilemap changes
+		if (_tileMapState == nullptr || _tileMapStateVersion != _tileMapVersion) {
+			auto state = std::make_shared<MemoryStream>(8192);
+			DeflateWriter dw(*state);
+			_tileMap->SerializeResumableToStream(dw);
+			dw.Dispose();
+
+			LOGD("Compressed tilemap state to %u bytes (version %u)", (std::uint32_t)state->GetSize(), _tileMapVersion);
+
+			_tileMapState = std::move(state);
+			_tileMapStateVersion = _tileMapVersion;
+		}
+
+		return _tileMapState;
+	}
+
+	void MultiLevelHandler::SendTileMapChunks()
+	{
+		// Chunks are enqueued only while the reliable window of the peer is not full, so the transfer is paced by acknowledgements
+		// and it doesn't build up a queue that would delay other reliable messages
+		for (auto& [peer, peerDesc] : _peerDesc) {
+			if (peerDesc.TileMapState == nullptr) {
+				continue;
+			}
+
+			const MemoryStream& state = *peerDesc.TileMapState;
+			std::uint32_t totalSize = (std::uint32_t)state.GetSize();
+
+			while (peerDesc.TileMapStateOffset < totalSize) {
+				std::uint32_t chunkSize = std::min(totalSize - peerDesc.TileMapStateOffset, TileMapChunkSize);
+				if (_networkManager->GetReliableSendCapacity(peer) < 16 + chunkSize) {
+					break;
+				}
+
+				std::uint8_t packetBuffer[16 + TileMapChunkSize];
+				MemoryStream packet(packetBuffer, sizeof(packetBuffer));
+				packet.WriteValue<std::uint8_t>((std::uint8_t)ServerPacketType::SyncTileMap);
+				packet.WriteVariableUint32(peerDesc.TileMapStateVersion);
+				packet.WriteVariableUint32(totalSize);
+				packet.WriteVariableUint32(peerDesc.TileMapStateOffset);
+				packet.Write(state.GetBuffer() + peerDesc.TileMapStateOffset, chunkSize);
+
+				_networkManager->SendToPeer(peer, NetworkChannel::Transfer, packet.GetBuffer(), packet.GetPosition());
+
+				peerDesc.TileMapStateOffset += chunkSize;
+			}
+
+			if (peerDesc.TileMapStateOffset >= totalSize) {
+				peerDesc.TileMapState = nullptr;
+			}
+		}
+	}
+
+	bool MultiLevelHandler::ShouldApplyTileMapChange(std::uint32_t version, const std::uint8_t* data, std::size_t dataLength)
+	{
+		if (!_tileMapSynchronized) {
+			// The tilemap state is transferred on another channel, so the change has to wait until it's received
+			_pendingTileMapChanges.emplace_back(data, data + dataLength);
+			return false;
+		}
+		if (version <= _tileMapVersion) {
+			// The change is already included in the received tilemap state
+			return false;
+		}
+
+		_tileMapVersion = version;
+		return true;
+	}
+
 	std::uint32_t MultiLevelHandler::FindFreeActorId()
 	{
 		//return ++_lastSpawnedActorId;
@@ -1881,110 +2270,53 @@ namespace Jazz2::Multiplayer
 				runtime_cast<Actors::Solid::PinballPaddle*>(actor) || runtime_cast<Actors::Solid::SpikeBall*>(actor));
 	}
 
-	/*void MultiLevelHandler::UpdatePlayerLocalPos(Actors::Player* player, PlayerState& playerState, float timeMult)
-	{
-		if (playerState.WarpTimeLeft > 0.0f || !player->_controllable || !player->GetState(Actors::ActorState::CollideWithTileset)) {
-			// Don't interpolate if warping is in progress or if collisions with tileset are disabled (when climbing or in tube)
-			return;
-		}
-
-		Clock& c = nCine::clock();
-		std::int64_t now = c.now() * 1000 / c.frequency();
-		std::int64_t renderTime = now - ServerDelay;
-
-		std::int32_t nextIdx = playerState.StateBufferPos - 1;
-		if (nextIdx < 0) {
-			nextIdx += arraySize(playerState.StateBuffer);
-		}
-
-		if (renderTime <= playerState.StateBuffer[nextIdx].Time) {
-			std::int32_t prevIdx;
-			while (true) {
-				prevIdx = nextIdx - 1;
-				if (prevIdx < 0) {
-					prevIdx += arraySize(playerState.StateBuffer);
-				}
-
-				if (prevIdx == playerState.StateBufferPos || playerState.StateBuffer[prevIdx].Time <= renderTime) {
-					break;
-				}
-
-				nextIdx = prevIdx;
-			}
-
-			Vector2f pos;
-			Vector2f speed;
-			std::int64_t timeRange = (playerState.StateBuffer[nextIdx].Time - playerState.StateBuffer[prevIdx].Time);
-			if (timeRange > 0) {
-				float lerp = (float)(renderTime - playerState.StateBuffer[prevIdx].Time) / timeRange;
-				pos = playerState.StateBuffer[prevIdx].Pos + (playerState.StateBuffer[nextIdx].Pos - playerState.StateBuffer[prevIdx].Pos) * lerp;
-				speed = playerState.StateBuffer[prevIdx].Speed + (playerState.StateBuffer[nextIdx].Speed - playerState.StateBuffer[prevIdx].Speed) * lerp;
-			} else {
-				pos = playerState.StateBuffer[nextIdx].Pos;
-				speed = playerState.StateBuffer[nextIdx].Speed;
-			}
-
-			constexpr float BaseDeviation = 2.0f;
-			constexpr float DeviationTimeMax = 90.0f;
-			constexpr float DeviationTimeCutoff = 40.0f;
-
-			float devSqr = (player->_pos - pos).SqrLength();
-			float speedSqr = std::max(player->_speed.SqrLength(), speed.SqrLength());
-			if (devSqr > speedSqr + (BaseDeviation * BaseDeviation)) {
-				playerState.DeviationTime += timeMult;
-				if (playerState.DeviationTime > DeviationTimeMax) {
-					LOGW("Deviation of player %i was high for too long (deviation: %0.2fpx, speed: %0.2f)", player->_playerIndex, sqrt(devSqr), sqrt(speedSqr));
-					playerState.DeviationTime = 0.0f;
-					player->MoveInstantly(pos, Actors::MoveType::Absolute);
-					return;
-				}
-			} else {
-				playerState.DeviationTime = 0.0f;
-			}
-
-			float alpha = std::clamp(playerState.DeviationTime - DeviationTimeCutoff, 0.0f, DeviationTimeMax - DeviationTimeCutoff) / (DeviationTimeMax - DeviationTimeCutoff);
-			if (alpha > 0.01f) {
-				player->MoveInstantly(Vector2f(lerp(player->_pos.X, pos.X, alpha), lerp(player->_pos.Y, pos.Y, alpha)), Actors::MoveType::Absolute);
-				player->_speed = Vector2f(lerp(player->_speed.X, speed.X, alpha), lerp(player->_speed.Y, speed.Y, alpha));
-				LOGW("Deviation of player %i is high (alpha: %0.1f, deviation: %0.2fpx, speed: %0.2f)", player->_playerIndex, alpha, sqrt(devSqr), sqrt(speedSqr));
-			}
-		}
-	}*/
-
-	/*void MultiLevelHandler::OnRemotePlayerPosReceived(PlayerState& playerState, const Vector2f& pos, const Vector2f speed, PlayerFlags flags)
+	bool MultiLevelHandler::WriteActorSnapshot(Stream& dest, const ActorSnapshot& state, const ActorSnapshot* baseline)
 	{
-		Clock& c = nCine::clock();
-		std::int64_t now = c.now() * 1000 / c.frequency();
+		static const ActorSnapshot EmptyState = {};
 
-		if ((flags & PlayerFlags::JustWarped) != PlayerFlags::JustWarped) {
-			// Player is still visible, enable interpolation
-			playerState.StateBuffer[playerState.StateBufferPos].Time = now;
-			playerState.StateBuffer[playerState.StateBufferPos].Pos = pos;
-			playerState.StateBuffer[playerState.StateBufferPos].Speed = speed;
+		ActorSnapshotFields fields;
+		if (baseline == nullptr) {
+			// Actor is not in the baseline, so all fields are written relative to zero
+			baseline = &EmptyState;
+			fields = ActorSnapshotFields::All | ActorSnapshotFields::IsFull;
 		} else {
-			// Player just warped, reset state buffer to disable interpolation
-			std::int32_t stateBufferPrevPos = playerState.StateBufferPos - 1;
-			if (stateBufferPrevPos < 0) {
-				stateBufferPrevPos += arraySize(playerState.StateBuffer);
+			fields = ActorSnapshotFields::None;
+			if (state.PosX != baseline->PosX) fields |= ActorSnapshotFields::PosX;
+			if (state.PosY != baseline->PosY) fields |= ActorSnapshotFields::PosY;
+			if (state.Anim != baseline->Anim) fields |= ActorSnapshotFields::Anim;
+			if (state.Rotation != baseline->Rotation) fields |= ActorSnapshotFields::Rotation;
+			if (state.Flags != baseline->Flags) fields |= ActorSnapshotFields::Flags;
+			if (state.RendererType != baseline->RendererType) fields |= ActorSnapshotFields::RendererType;
+
+			if (fields == ActorSnapshotFields::None) {
+				// Unchanged actors are omitted completely
+				return false;
 			}
+		}
 
-			std::int64_t renderTime = now - ServerDelay;
+		dest.WriteVariableUint32(state.ActorId);
+		dest.WriteValue<std::uint8_t>((std::uint8_t)fields);
 
-			playerState.StateBuffer[stateBufferPrevPos].Time = renderTime;
-			playerState.StateBuffer[stateBufferPrevPos].Pos = pos;
-			playerState.StateBuffer[stateBufferPrevPos].Speed = speed;
-			playerState.StateBuffer[playerState.StateBufferPos].Time = renderTime;
-			playerState.StateBuffer[playerState.StateBufferPos].Pos = pos;
-			playerState.StateBuffer[playerState.StateBufferPos].Speed = speed;
+		if ((fields & ActorSnapshotFields::PosX) == ActorSnapshotFields::PosX) {
+			dest.WriteVariableInt32(state.PosX - baseline->PosX);
 		}
-
-		playerState.StateBufferPos++;
-		if (playerState.StateBufferPos >= static_cast<std::int32_t>(arraySize(playerState.StateBuffer))) {
-			playerState.StateBufferPos = 0;
+		if ((fields & ActorSnapshotFields::PosY) == ActorSnapshotFields::PosY) {
+			dest.WriteVariableInt32(state.PosY - baseline->PosY);
 		}
-
-		playerState.Flags = (flags & ~PlayerFlags::JustWarped);
-	}*/
+		if ((fields & ActorSnapshotFields::Anim) == ActorSnapshotFields::Anim) {
+			dest.WriteVariableUint32(state.Anim);
+		}
+		if ((fields & ActorSnapshotFields::Rotation) == ActorSnapshotFields::Rotation) {
+			dest.WriteValue<std::uint8_t>(state.Rotation);
+		}
+		if ((fields & ActorSnapshotFields::Flags) == ActorSnapshotFields::Flags) {
+			dest.WriteValue<std::uint8_t>(state.Flags);
+		}
+		if ((fields & ActorSnapshotFields::RendererType) == ActorSnapshotFields::RendererType) {
+			dest.WriteValue<std::uint8_t>(state.RendererType);
+		}
+		return true;
+	}
 
 #if defined(DEATH_DEBUG) && defined(WITH_IMGUI)
 	void MultiLevelHandler::ShowDebugWindow()
@@ -2022,18 +2354,24 @@ namespace Jazz2::Multiplayer
 		ImGui::SameLine(360.0f);
 		ImGui::Text("%.0f", _remotingActorsCount[_plotIndex]);
 
+		ImGui::PlotLines("Culled Actors", _culledActorsCount, PlotValueCount, _plotIndex, nullptr, 0.0f, _actorsMaxCount, ImVec2(appWidth * 0.2f, 40.0f));
+		ImGui::SameLine(360.0f);
+		ImGui::Text("%.0f", _culledActorsCount[_plotIndex]);
+
 		ImGui::Text("Last spawned ID: %u", _lastSpawnedActorId);
 
 		ImGui::SeparatorText("Peers");
 
 		ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Reorderable | ImGuiTableFlags_Hideable | ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_BordersInner | ImGuiTableFlags_NoPadOuterX;
-		if (ImGui::BeginTable("peers", 6, flags, ImVec2(0.0f, 0.0f))) {
+		if (ImGui::BeginTable("peers", 8, flags, ImVec2(0.0f, 0.0f))) {
 			ImGui::TableSetupColumn("Peer");
 			ImGui::TableSetupColumn("Player Index");
 			ImGui::TableSetupColumn("State");
 			ImGui::TableSetupColumn("Last Updated");
 			ImGui::TableSetupColumn("X");
 			ImGui::TableSetupColumn("Y");
+			ImGui::TableSetupColumn("Bytes/s");
+			ImGui::TableSetupColumn("Culled");
 			ImGui::TableHeadersRow();
 			
 			for (auto& [peer, desc] : _peerDesc) {
@@ -2049,13 +2387,19 @@ namespace Jazz2::Multiplayer
 				ImGui::Text("0x%x", desc.State);
 
 				ImGui::TableSetColumnIndex(3);
-				ImGui::Text("%u", desc.LastUpdated);
+				ImGui::Text("%llu", desc.LastUpdated);
 
 				ImGui::TableSetColumnIndex(4);
 				ImGui::Text("%.2f", desc.Player != nullptr ? desc.Player->GetPos().X : -1.0f);
 
 				ImGui::TableSetColumnIndex(5);
 				ImGui::Text("%.2f", desc.Player != nullptr ? desc.Player->GetPos().Y : -1.0f);
+
+				ImGui::TableSetColumnIndex(6);
+				ImGui::Text("%u", desc.BytesPerSecond);
+
+				ImGui::TableSetColumnIndex(7);
+				ImGui::Text("%u", desc.ActorsCulled);
 			}
 			ImGui::EndTable();
 		}
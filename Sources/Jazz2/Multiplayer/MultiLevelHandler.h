@@ -114,13 +114,72 @@ namespace Jazz2::Multiplayer
 			LevelSynchronized
 		};
 
+		struct ActorSnapshot {
+			std::uint32_t ActorId;
+			std::int32_t PosX;		// Quantized to 1/512 px
+			std::int32_t PosY;		// Quantized to 1/512 px
+			std::uint32_t Anim;
+			std::uint8_t Rotation;
+			std::uint8_t Flags;
+			std::uint8_t RendererType;
+		};
+
+		/// Changed fields of an actor relative to the baseline snapshot
+		enum class ActorSnapshotFields : std::uint8_t {
+			None = 0,
+
+			PosX = 0x01,
+			PosY = 0x02,
+			Anim = 0x04,
+			Rotation = 0x08,
+			Flags = 0x10,
+			RendererType = 0x20,
+
+			All = 0x3F,
+
+			// Record contains absolute values, because the actor is not in the baseline snapshot
+			IsFull = 0x80
+		};
+
+		DEFINE_PRIVATE_ENUM_OPERATORS(ActorSnapshotFields);
+
+		struct Snapshot {
+			std::uint64_t SeqNum;
+			SmallVector<ActorSnapshot, 0> Actors;	// Sorted by actor ID
+
+			Snapshot() : SeqNum(0) {}
+		};
+
 		struct PeerDesc {
 			Actors::Multiplayer::RemotePlayerOnServer* Player;
 			PeerState State;
-			std::uint32_t LastUpdated;
+			std::uint64_t LastUpdated;		// Client time of the last processed player update
+			HashMap<std::uint32_t, float> ActorPriorities;	// Accumulated priority of relevant actors, the highest ones are sent first
+			std::uint32_t BytesSent;		// Bytes of actor updates sent in the current second
+			std::uint32_t BytesPerSecond;	// Bytes of actor updates sent in the last second
+			std::uint32_t ActorsCulled;		// Actors that were not sent in the last update
+			SmallVector<Snapshot, 0> Snapshots;		// Recently sent snapshots, indexed by sequence number modulo SnapshotHistoryCount
+			std::uint64_t LastSnapshotSeqNum;		// Sequence number of the last sent snapshot
+			std::uint64_t AckedSnapshotSeqNum;		// Sequence number of the last snapshot acknowledged by the peer, 0 if none
+			std::shared_ptr<MemoryStream> TileMapState;	// Compressed tilemap state that is being transferred to the peer
+			std::uint32_t TileMapStateVersion;		// Tilemap version of the transferred state
+			std::uint32_t TileMapStateOffset;		// Bytes of the transferred state already sent
 
 			PeerDesc() {}
-			PeerDesc(Actors::Multiplayer::RemotePlayerOnServer* player, PeerState state) : Player(player), State(state), LastUpdated(0) {}
+			PeerDesc(Actors::Multiplayer::RemotePlayerOnServer* player, PeerState state)
+				: Player(player), State(state), LastUpdated(0), BytesSent(0), BytesPerSecond(0), ActorsCulled(0),
+					LastSnapshotSeqNum(0), AckedSnapshotSeqNum(0), TileMapStateVersion(0), TileMapStateOffset(0) {}
+		};
+
+		struct ActorUpdate {
+			Actors::ActorBase* Actor;
+			ActorSnapshot State;
+			bool IsPlayer;
+		};
+
+		struct RelevantActor {
+			float Priority;
+			std::int32_t UpdateIndex;
 		};
 
 		enum class PlayerFlags {
@@ -149,12 +208,20 @@ namespace Jazz2::Multiplayer
 		};
 
 		static constexpr float UpdatesPerSecond = 16.0f; // ~62 ms interval
-		static constexpr std::int64_t ServerDelay = 64;
+		static constexpr std::int64_t MinInterpolationDelay = 32;
+		static constexpr std::int64_t MaxInterpolationDelay = 250;
+		static constexpr std::int32_t MaxActorUpdatesPerPeer = 96; // Players are not counted
+		static constexpr float ViewActorPriority = 4.0f;
+		static constexpr float NearbyActorPriority = 1.0f;
+		static constexpr float SpeedActorPriority = 0.25f;
+		static constexpr std::int32_t SnapshotHistoryCount = 32; // ~2 seconds, older baselines fall back to a full snapshot
+		static constexpr std::uint32_t TileMapChunkSize = 4096;
 
 		NetworkManager* _networkManager;
 		MultiplayerGameMode _gameMode;
 		bool _isServer;
 		float _updateTimeLeft;
+		float _statsTimeLeft;
 		bool _initialUpdateSent;
 		HashMap<Peer, PeerDesc> _peerDesc; // Server: Per peer description
 		HashMap<std::uint8_t, PlayerState> _playerStates; // Server: Per (remote) player state
@@ -163,14 +230,40 @@ namespace Jazz2::Multiplayer
 		std::uint32_t _lastSpawnedActorId;	// Server: last assigned actor/player ID, Client: ID assigned by server
 		std::uint64_t _seqNum; // Client: sequence number of the last update
 		std::uint64_t _seqNumWarped; // Client: set to _seqNum from HandlePlayerWarped() when warped
+		std::uint64_t _lastSnapshotSeqNum; // Client: sequence number of the last received snapshot
+		std::uint64_t _ackedSnapshotSeqNum; // Client: sequence number of the snapshot to acknowledge, 0 to request a full snapshot
+		SmallVector<Snapshot, 0> _receivedSnapshots; // Client: Recently received snapshots, indexed by sequence number modulo SnapshotHistoryCount
+		std::uint64_t _lastServerTime; // Client: server time of the last received snapshot
+		std::int64_t _serverTimeOffset; // Client: estimated difference between local and server clock including the lowest latency
+		float _snapshotInterval; // Client: smoothed interval between snapshots in milliseconds
+		float _snapshotJitter; // Client: smoothed deviation of snapshot arrival in milliseconds
+		std::int64_t _interpolationDelay; // Client: how far in the past remote actors are rendered, it adapts to interval and jitter
+		std::uint32_t _tileMapVersion; // Server: incremented on every tilemap change, Client: version of the applied tilemap state
+		std::uint32_t _tileMapStateVersion; // Server: tilemap version of the cached compressed state
+		std::shared_ptr<MemoryStream> _tileMapState; // Server: Cached compressed tilemap state, it's shared by all joining peers
+		std::shared_ptr<MemoryStream> _tileMapTransfer; // Client: Compressed tilemap state received so far
+		bool _tileMapSynchronized; // Client: true if the tilemap state was already received
+		SmallVector<SmallVector<std::uint8_t, 0>, 0> _pendingTileMapChanges; // Client: Tilemap changes received before the tilemap state
 		bool _suppressRemoting; // Server: if true, actor will not be automatically remoted to other players
 		bool _ignorePackets;
-
+		SmallVector<ActorUpdate, 0> _actorUpdates; // Server: Serialized state of all players and remoting actors in the current update
+		SmallVector<RelevantActor, 0> _relevantActors; // Server: Actors relevant to the currently processed peer
+		SmallVector<ActorSnapshot, 0> _snapshotActors; // Actors of the currently processed snapshot, sorted by actor ID
+		MemoryStream _snapshotRecords; // Server: Encoded records of the currently processed snapshot, it's rewound for each peer
+		MemoryStream _snapshotPacket; // Server: Compressed packet of the currently processed snapshot, it's rewound for each peer
+		std::uint32_t _actorsCulled; // Server: Actors that were not sent to peers in the last update, summed for all peers
+
+		void SendActorUpdates();
+		void ReceiveActorUpdates(Stream& packet);
 		void SynchronizePeers();
+		std::shared_ptr<MemoryStream> GetCompressedTileMapState();
+		void SendTileMapChunks();
+		bool ShouldApplyTileMapChange(std::uint32_t version, const std::uint8_t* data, std::size_t dataLength);
 		std::uint32_t FindFreeActorId();
 		std::uint8_t FindFreePlayerId();
 
 		static bool ActorShouldBeMirrored(Actors::ActorBase* actor);
+		static bool WriteActorSnapshot(Stream& dest, const ActorSnapshot& state, const ActorSnapshot* baseline);
 
 #if defined(DEATH_DEBUG) && defined(WITH_IMGUI)
 		static constexpr std::int32_t PlotValueCount = 512;
@@ -181,6 +274,7 @@ namespace Jazz2::Multiplayer
 		float _remoteActorsCount[PlotValueCount];
 		float _remotingActorsCount[PlotValueCount];
 		float _mirroredActorsCount[PlotValueCount];
+		float _culledActorsCount[PlotValueCount];
 		float _updatePacketMaxSize;
 		float _updatePacketSize[PlotValueCount];
 		float _compressedUpdatePacketSize[PlotValueCount];
@@ -4,7 +4,6 @@
 #if defined(WITH_MULTIPLAYER)
 
 #include "INetworkHandler.h"
-#include "../../nCine/Base/Timer.h"
 
 /*
 // <mmeapi.h> included by "enet.h" still uses `far` macro
@@ -29,10 +28,12 @@ using namespace Death;
 namespace Jazz2::Multiplayer
 {
 	std::int32_t NetworkManager::_initializeCount = 0;
+	std::int32_t NetworkManager::_lastInstanceId = 0;
 
 	NetworkManager::NetworkManager()
-		: _host(nullptr), _state(NetworkState::None), _handler(nullptr)
+		: _host(nullptr), _state(NetworkState::None), _handler(nullptr), _sendQueue(nullptr), _returnedBuffers(nullptr), _wakeSocket(ENET_SOCKET_NULL)
 	{
+		_instanceId = Interlocked::Increment(&_lastInstanceId);
 		InitializeBackend();
 	}
 
@@ -40,6 +41,17 @@ namespace Jazz2::Multiplayer
 	{
 		Dispose();
 		ReleaseBackend();
+
+		for (auto& staging : _stagingAreas) {
+			for (auto& buffers : staging->Buffers) {
+				for (PacketBuffer* buffer : buffers) {
+					delete buffer;
+				}
+			}
+			DeleteBuffers(staging->FreeBuffers);
+		}
+		DeleteBuffers(_sendQueue);
+		DeleteBuffers(_returnedBuffers);
 	}
 
 	bool NetworkManager::CreateClient(INetworkHandler* handler, const StringView& address, std::uint16_t port, std::uint32_t clientData)
@@ -68,6 +80,8 @@ namespace Jazz2::Multiplayer
 
 		_peers.push_back(peer);
 
+		CreateWakeSocket();
+
 		_handler = handler;
 		_thread.Run(NetworkManager::OnClientThread, this);
 		return true;
@@ -88,6 +102,8 @@ namespace Jazz2::Multiplayer
 
 		_discovery = std::make_unique<ServerDiscovery>(handler, port);
 
+		CreateWakeSocket();
+
 		_handler = handler;
 		_state = NetworkState::Listening;
 		_thread.Run(NetworkManager::OnServerThread, this);
@@ -101,6 +117,7 @@ namespace Jazz2::Multiplayer
 		}
 
 		_state = NetworkState::None;
+		Flush();
 		_thread.Join();
 
 		_host = nullptr;
@@ -113,63 +130,54 @@ namespace Jazz2::Multiplayer
 
 	void NetworkManager::SendToPeer(const Peer& peer, NetworkChannel channel, const std::uint8_t* data, std::size_t dataLength)
 	{
-		ENetPeer* target;
-		if (peer == nullptr) {
-			if (_state != NetworkState::Connected || _peers.empty()) {
-				return;
-			}
-
-			target = _peers[0];
-		} else {
-			target = peer._enet;
+		// Messages for unknown peers are dropped, ENet reuses the slot of a disconnected peer for the next client
+		std::size_t peerSlot = GetPeerSlot(peer._enet);
+		std::uint32_t generation = (std::uint32_t)_peerGenerations[peerSlot].load(Atomic32::MemoryModel::ACQUIRE);
+		if ((generation & 1) == 0) {
+			return;
 		}
 
-		enet_uint32 flags;
-		if (channel == NetworkChannel::Main) {
-			flags = ENET_PACKET_FLAG_RELIABLE;
-		} else {
-			flags = ENET_PACKET_FLAG_UNSEQUENCED;
-		}
+		AppendToBatch(GetStagingArea(), peerSlot, generation, channel, data, dataLength);
+	}
 
-		ENetPacket* packet = enet_packet_create(data, dataLength, flags);
+	void NetworkManager::SendToAll(NetworkChannel channel, const std::uint8_t* data, std::size_t dataLength)
+	{
+		StagingArea& staging = GetStagingArea();
 
-		_lock.Lock();
-		if (enet_peer_send(target, (std::uint8_t)channel, packet) < 0) {
-			enet_packet_destroy(packet);
-		} else if (channel == NetworkChannel::UnreliableUpdates) {
-			enet_host_flush(_host);
+		// Message is copied to batches of all peers, so it keeps its order with messages sent to individual peers
+		for (std::size_t i = 0; i < arraySize(_peerGenerations); i++) {
+			std::uint32_t generation = (std::uint32_t)_peerGenerations[i].load(Atomic32::MemoryModel::ACQUIRE);
+			if ((generation & 1) != 0) {
+				AppendToBatch(staging, i, generation, channel, data, dataLength);
+			}
 		}
-		_lock.Unlock();
 	}
 
-	void NetworkManager::SendToAll(NetworkChannel channel, const std::uint8_t* data, std::size_t dataLength)
+	void NetworkManager::Flush()
 	{
-		if (_peers.empty()) {
+		CloseStagedBatches(GetStagingArea());
+
+		if (_sendQueue == nullptr) {
 			return;
 		}
 
-		enet_uint32 flags;
-		if (channel == NetworkChannel::Main) {
-			flags = ENET_PACKET_FLAG_RELIABLE;
-		} else {
-			flags = ENET_PACKET_FLAG_UNSEQUENCED;
+		// Only one wake-up datagram is needed until the network thread processes it
+		if (_wakeSocket == ENET_SOCKET_NULL || !_wakePending.cmpExchange(1, 0)) {
+			return;
 		}
 
-		ENetPacket* packet = enet_packet_create(data, dataLength, flags);
+		std::uint8_t data = 0;
+		ENetBuffer buffer;
+		buffer.data = &data;
+		buffer.dataLength = sizeof(data);
+		enet_socket_send(_wakeSocket, &_wakeAddress, &buffer, 1);
+	}
 
-		_lock.Lock();
-		bool success = false;
-		for (ENetPeer* peer : _peers) {
-			if (enet_peer_send(peer, (std::uint8_t)channel, packet) >= 0) {
-				success = true;
-			}
-		}
-		if (!success) {
-			enet_packet_destroy(packet);
-		} else if (channel == NetworkChannel::UnreliableUpdates) {
-			enet_host_flush(_host);
-		}
-		_lock.Unlock();
+	std::uint32_t NetworkManager::GetReliableSendCapacity(const Peer& peer)
+	{
+		// Hosts are created without bandwidth limits, so ENet always uses the maximum window size
+		std::int32_t pendingSize = _peerPendingReliableSizes[GetPeerSlot(peer._enet)].load(Atomic32::MemoryModel::RELAXED);
+		return (pendingSize < ENET_PROTOCOL_MAXIMUM_WINDOW_SIZE ? (std::uint32_t)(ENET_PROTOCOL_MAXIMUM_WINDOW_SIZE - pendingSize) : 0);
 	}
 
 	void NetworkManager::KickClient(const Peer& peer, Reason reason)
@@ -192,6 +200,301 @@ namespace Jazz2::Multiplayer
 		}
 	}
 
+	std::size_t NetworkManager::GetPeerSlot(_ENetPeer* peer)
+	{
+		// Server connection on the client is always addressed by `nullptr`
+		return (peer != nullptr ? peer->incomingPeerID : ServerPeerSlot);
+	}
+
+	void NetworkManager::SetPeerConnected(_ENetPeer* peer, bool connected)
+	{
+		// Every connection gets a new generation, so batches enqueued for the previous peer in the slot are discarded,
+		// even if the previous peer was kicked without a disconnect event
+		Atomic32& generation = _peerGenerations[GetPeerSlot(peer)];
+		bool wasConnected = ((generation.load(Atomic32::MemoryModel::RELAXED) & 1) != 0);
+		if (wasConnected != connected) {
+			generation.fetchAdd(1, Atomic32::MemoryModel::RELEASE);
+		} else if (connected) {
+			generation.fetchAdd(2, Atomic32::MemoryModel::RELEASE);
+		}
+	}
+
+	void NetworkManager::RemovePeer(_ENetPeer* peer)
+	{
+		for (std::size_t i = 0; i < _peers.size(); i++) {
+			if (_peers[i] == peer) {
+				_peers.eraseUnordered(i);
+				break;
+			}
+		}
+		SetPeerConnected(peer, false);
+	}
+
+	NetworkManager::StagingArea& NetworkManager::GetStagingArea()
+	{
+		static DEATH_THREAD_LOCAL StagingArea* currentStaging = nullptr;
+		static DEATH_THREAD_LOCAL std::int32_t currentInstanceId = 0;
+
+		// Instance ID is never reused, so the pointer can't belong to an already destroyed manager
+		if (currentInstanceId != _instanceId) {
+			auto staging = std::make_unique<StagingArea>();
+			for (auto& buffers : staging->Buffers) {
+				for (PacketBuffer*& buffer : buffers) {
+					buffer = nullptr;
+				}
+			}
+			staging->FreeBuffers = nullptr;
+
+			currentStaging = staging.get();
+			currentInstanceId = _instanceId;
+
+			_stagingLock.Lock();
+			_stagingAreas.push_back(std::move(staging));
+			_stagingLock.Unlock();
+		}
+		return *currentStaging;
+	}
+
+	void NetworkManager::AppendToBatch(StagingArea& staging, std::size_t peerSlot, std::uint32_t generation, NetworkChannel channel, const std::uint8_t* data, std::size_t dataLength)
+	{
+		std::size_t maxBatchSize = (channel == NetworkChannel::UnreliableUpdates ? MaxUnreliableBatchSize : MaxReliableBatchSize);
+		PacketBuffer*& buffer = staging.Buffers[peerSlot][(std::size_t)channel];
+		// Batch of a previous connection in the same slot is closed too, the network thread discards it
+		if (buffer != nullptr && (buffer->Generation != generation || buffer->Data.size() + dataLength + 5 > maxBatchSize)) {
+			CloseBatch(buffer);
+		}
+		if (buffer == nullptr) {
+			buffer = AcquireBuffer(staging);
+			buffer->PeerSlot = (std::uint32_t)peerSlot;
+			buffer->Generation = generation;
+			buffer->Channel = channel;
+		}
+
+		// Every message is prefixed by its length as variable-length integer
+		std::size_t prevSize = buffer->Data.size();
+		std::uint32_t length = (std::uint32_t)dataLength;
+		while (length >= 0x80) {
+			buffer->Data.push_back((std::uint8_t)(length | 0x80));
+			length >>= 7;
+		}
+		buffer->Data.push_back((std::uint8_t)length);
+
+		std::size_t offset = buffer->Data.size();
+		buffer->Data.resize_for_overwrite(offset + dataLength);
+		std::memcpy(buffer->Data.data() + offset, data, dataLength);
+
+		if (channel != NetworkChannel::UnreliableUpdates) {
+			_peerPendingReliableSizes[peerSlot].fetchAdd((std::int32_t)(buffer->Data.size() - prevSize), Atomic32::MemoryModel::RELAXED);
+		}
+	}
+
+	void NetworkManager::CloseBatch(PacketBuffer*& buffer)
+	{
+		PushBuffer(&_sendQueue, buffer);
+		buffer = nullptr;
+	}
+
+	void NetworkManager::CloseStagedBatches(StagingArea& staging)
+	{
+		for (auto& buffers : staging.Buffers) {
+			for (PacketBuffer*& buffer : buffers) {
+				if (buffer != nullptr) {
+					CloseBatch(buffer);
+				}
+			}
+		}
+	}
+
+	NetworkManager::PacketBuffer* NetworkManager::AcquireBuffer(StagingArea& staging)
+	{
+		if (staging.FreeBuffers == nullptr) {
+			// All returned buffers are taken at once, so popping from the shared stack doesn't suffer from ABA problem
+			staging.FreeBuffers = Interlocked::ExchangePointer(&_returnedBuffers, nullptr);
+		}
+
+		PacketBuffer* buffer = staging.FreeBuffers;
+		if (buffer != nullptr) {
+			staging.FreeBuffers = buffer->Next;
+			return buffer;
+		}
+
+		buffer = new PacketBuffer();
+		buffer->Owner = this;
+		return buffer;
+	}
+
+	void NetworkManager::ReleaseBuffer(PacketBuffer* buffer)
+	{
+		// Reliable packets are released only after they are acknowledged, so the pending size includes also data in transit
+		if (buffer->Channel != NetworkChannel::UnreliableUpdates) {
+			_peerPendingReliableSizes[buffer->PeerSlot].fetchSub((std::int32_t)buffer->Data.size(), Atomic32::MemoryModel::RELAXED);
+		}
+
+		// Capacity of the buffer is kept, so no allocation is needed once the pool is warmed up
+		buffer->Data.clear();
+		PushBuffer(&_returnedBuffers, buffer);
+	}
+
+	void NetworkManager::PushBuffer(PacketBuffer* volatile* stack, PacketBuffer* buffer)
+	{
+		PacketBuffer* head;
+		do {
+			head = *stack;
+			buffer->Next = head;
+		} while (Interlocked::CompareExchangePointer(stack, buffer, head) != head);
+	}
+
+	void NetworkManager::DeleteBuffers(PacketBuffer* buffer)
+	{
+		while (buffer != nullptr) {
+			PacketBuffer* next = buffer->Next;
+			delete buffer;
+			buffer = next;
+		}
+	}
+
+	void NetworkManager::ProcessSendQueue(bool discard)
+	{
+		// Messages sent by the handler from the network thread are flushed automatically
+		CloseStagedBatches(GetStagingArea());
+
+		// Whole stack is taken at once and reversed, so batches are sent in the same order as they were closed
+		PacketBuffer* buffer = Interlocked::ExchangePointer(&_sendQueue, nullptr);
+		PacketBuffer* ordered = nullptr;
+		while (buffer != nullptr) {
+			PacketBuffer* next = buffer->Next;
+			buffer->Next = ordered;
+			ordered = buffer;
+			buffer = next;
+		}
+
+		while (ordered != nullptr) {
+			buffer = ordered;
+			ordered = ordered->Next;
+
+			// Batches for peers that disconnected in the meantime are discarded
+			std::uint32_t generation = (std::uint32_t)_peerGenerations[buffer->PeerSlot].load(Atomic32::MemoryModel::RELAXED);
+			if (discard || buffer->Generation != generation) {
+				ReleaseBuffer(buffer);
+				continue;
+			}
+
+			enet_uint32 flags = ENET_PACKET_FLAG_NO_ALLOCATE;
+			if (buffer->Channel == NetworkChannel::UnreliableUpdates) {
+				flags |= ENET_PACKET_FLAG_UNSEQUENCED;
+			} else {
+				flags |= ENET_PACKET_FLAG_RELIABLE;
+			}
+
+			// Data of the packet points directly to the pooled buffer, it's returned to the pool when ENet releases the packet
+			ENetPacket* packet = enet_packet_create(buffer->Data.data(), buffer->Data.size(), flags);
+			if (packet == nullptr) {
+				ReleaseBuffer(buffer);
+				continue;
+			}
+			packet->userData = buffer;
+			packet->freeCallback = OnPacketFreed;
+
+			ENetPeer* target;
+			if (buffer->PeerSlot == ServerPeerSlot) {
+				target = (!_peers.empty() ? _peers[0] : nullptr);
+			} else {
+				target = &_host->peers[buffer->PeerSlot];
+			}
+			if (target == nullptr || enet_peer_send(target, (std::uint8_t)buffer->Channel, packet) < 0) {
+				enet_packet_destroy(packet);
+			}
+		}
+	}
+
+	void NetworkManager::DispatchPacket(_ENetPeer* peer, std::uint8_t channelId, std::uint8_t* data, std::size_t dataLength)
+	{
+		std::size_t offset = 0;
+		while (offset < dataLength) {
+			std::uint32_t length = 0;
+			std::uint32_t shift = 0;
+			while (offset < dataLength && shift < 32) {
+				std::uint8_t byte = data[offset++];
+				length |= (std::uint32_t)(byte & 0x7f) << shift;
+				shift += 7;
+				if ((byte & 0x80) == 0) {
+					break;
+				}
+			}
+
+			if (length > dataLength - offset) {
+				LOGW("Received malformed batch on channel %u", channelId);
+				break;
+			}
+
+			_handler->OnPacketReceived(peer, channelId, data + offset, length);
+			offset += length;
+		}
+	}
+
+	void ENET_CALLBACK NetworkManager::OnPacketFreed(void* packet)
+	{
+		PacketBuffer* buffer = static_cast<PacketBuffer*>(static_cast<ENetPacket*>(packet)->userData);
+		buffer->Owner->ReleaseBuffer(buffer);
+	}
+
+	void NetworkManager::WaitForEvents(_ENetHost* host, std::uint32_t timeoutMs)
+	{
+		ENetSocketSet readSet;
+		ENET_SOCKETSET_EMPTY(readSet);
+		ENET_SOCKETSET_ADD(readSet, host->socket);
+		ENetSocket maxSocket = host->socket;
+		if (_wakeSocket != ENET_SOCKET_NULL) {
+			ENET_SOCKETSET_ADD(readSet, _wakeSocket);
+			if (maxSocket < _wakeSocket) {
+				maxSocket = _wakeSocket;
+			}
+		}
+
+		if (enet_socketset_select(maxSocket, &readSet, nullptr, timeoutMs) > 0 &&
+			_wakeSocket != ENET_SOCKET_NULL && ENET_SOCKETSET_CHECK(readSet, _wakeSocket)) {
+			std::uint8_t data[16];
+			ENetBuffer buffer;
+			buffer.data = data;
+			buffer.dataLength = sizeof(data);
+			while (enet_socket_receive(_wakeSocket, nullptr, &buffer, 1) > 0) {
+				// Drain all pending wake-up datagrams
+			}
+			// Must be reset before the queue is processed, so no wake-up request is lost
+			_wakePending.store(0);
+		}
+	}
+
+	void NetworkManager::CreateWakeSocket()
+	{
+		_wakePending.store(0);
+
+		_wakeSocket = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
+		if (_wakeSocket == ENET_SOCKET_NULL) {
+			LOGW("Failed to create wake-up socket, packets will be sent with higher latency");
+			return;
+		}
+
+		enet_socket_set_option(_wakeSocket, ENET_SOCKOPT_NONBLOCK, 1);
+		enet_socket_set_option(_wakeSocket, ENET_SOCKOPT_IPV6_V6ONLY, 0);
+
+		ENetAddress addr = { };
+		addr.host = enet_v4_localhost;
+		addr.port = ENET_PORT_ANY;
+		if (enet_socket_bind(_wakeSocket, &addr) < 0 || enet_socket_get_address(_wakeSocket, &_wakeAddress) < 0) {
+			LOGW("Failed to bind wake-up socket, packets will be sent with higher latency");
+			DestroyWakeSocket();
+		}
+	}
+
+	void NetworkManager::DestroyWakeSocket()
+	{
+		if (_wakeSocket != ENET_SOCKET_NULL) {
+			enet_socket_destroy(_wakeSocket);
+			_wakeSocket = ENET_SOCKET_NULL;
+		}
+	}
+
 	void NetworkManager::OnClientThread(void* param)
 	{
 		NetworkManager* _this = static_cast<NetworkManager*>(param);
@@ -219,12 +522,14 @@ namespace Jazz2::Multiplayer
 			_this->_state = NetworkState::None;
 			reason = Reason::ConnectionTimedOut;
 		} else {
+			_this->SetPeerConnected(nullptr, true);
 			_this->_state = NetworkState::Connected;
 			handler->OnPeerConnected(ev.peer, ev.data);
 			reason = Reason::Unknown;
 
 			while (_this->_state != NetworkState::None) {
 				_this->_lock.Lock();
+				_this->ProcessSendQueue(false);
 				std::int32_t result = enet_host_service(host, &ev, 0);
 				_this->_lock.Unlock();
 				if (result <= 0) {
@@ -233,13 +538,14 @@ namespace Jazz2::Multiplayer
 						reason = Reason::ConnectionLost;
 						break;
 					}
-					Timer::sleep(ProcessingIntervalMs);
+					// Nothing to process, wait until a packet arrives or the game thread requests a flush
+					_this->WaitForEvents(host, MaxWaitTimeMs);
 					continue;
 				}
 
 				switch (ev.type) {
 					case ENET_EVENT_TYPE_RECEIVE:
-						handler->OnPacketReceived(ev.peer, ev.channelID, ev.packet->data, ev.packet->dataLength);
+						_this->DispatchPacket(ev.peer, ev.channelID, ev.packet->data, ev.packet->dataLength);
 						enet_packet_destroy(ev.packet);
 						break;
 					case ENET_EVENT_TYPE_DISCONNECT:
@@ -260,6 +566,9 @@ namespace Jazz2::Multiplayer
 			enet_peer_disconnect_now(peer, (std::uint32_t)Reason::Disconnected);
 		}
 		_this->_peers.clear();
+		_this->SetPeerConnected(nullptr, false);
+		_this->ProcessSendQueue(true);
+		_this->DestroyWakeSocket();
 
 		enet_host_destroy(_this->_host);
 		_this->_host = nullptr;
@@ -279,6 +588,7 @@ namespace Jazz2::Multiplayer
 		ENetEvent ev;
 		while (_this->_state != NetworkState::None) {
 			_this->_lock.Lock();
+			_this->ProcessSendQueue(false);
 			std::int32_t result = enet_host_service(host, &ev, 0);
 			_this->_lock.Unlock();
 			if (result <= 0) {
@@ -290,6 +600,7 @@ namespace Jazz2::Multiplayer
 
 					for (auto& peer : _this->_peers) {
 						handler->OnPeerDisconnected(peer, Reason::ConnectionLost);
+						_this->SetPeerConnected(peer, false);
 					}
 					_this->_peers.clear();
 
@@ -305,37 +616,46 @@ namespace Jazz2::Multiplayer
 						break;
 					}
 				}
-				Timer::sleep(ProcessingIntervalMs);
+				// Nothing to process, wait until a packet arrives or the game thread requests a flush
+				_this->WaitForEvents(host, MaxWaitTimeMs);
 				continue;
 			}
 
 			switch (ev.type) {
 				case ENET_EVENT_TYPE_CONNECT: {
+					// Peer is known only from now on, so the handler can already send messages to it
+					_this->SetPeerConnected(ev.peer, true);
 					ConnectionResult result = handler->OnPeerConnected(ev.peer, ev.data);
 					if (result.IsSuccessful()) {
 						_this->_peers.push_back(ev.peer);
 					} else {
+						_this->SetPeerConnected(ev.peer, false);
 						enet_peer_disconnect_now(ev.peer, (std::uint32_t)result.FailureReason);
 					}
 					break;
 				}
 				case ENET_EVENT_TYPE_RECEIVE:
-					handler->OnPacketReceived(ev.peer, ev.channelID, ev.packet->data, ev.packet->dataLength);
+					_this->DispatchPacket(ev.peer, ev.channelID, ev.packet->data, ev.packet->dataLength);
 					enet_packet_destroy(ev.packet);
 					break;
 				case ENET_EVENT_TYPE_DISCONNECT:
 					handler->OnPeerDisconnected(ev.peer, (Reason)ev.data);
+					_this->RemovePeer(ev.peer);
 					break;
 				case ENET_EVENT_TYPE_DISCONNECT_TIMEOUT:
 					handler->OnPeerDisconnected(ev.peer, Reason::ConnectionLost);
+					_this->RemovePeer(ev.peer);
 					break;
 			}
 		}
 
 		for (ENetPeer* peer : _this->_peers) {
 			enet_peer_disconnect_now(peer, (std::uint32_t)Reason::ServerStopped);
+			_this->SetPeerConnected(peer, false);
 		}
 		_this->_peers.clear();
+		_this->ProcessSendQueue(true);
+		_this->DestroyWakeSocket();
 
 		enet_host_destroy(_this->_host);
 		_this->_host = nullptr;
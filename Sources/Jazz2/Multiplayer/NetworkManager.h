@@ -6,6 +6,7 @@
 #include "Reason.h"
 #include "ServerDiscovery.h"
 #include "../../Common.h"
+#include "../../nCine/Threading/Atomic.h"
 #include "../../nCine/Threading/Thread.h"
 #include "../../nCine/Threading/ThreadSync.h"
 
@@ -25,6 +26,7 @@ namespace Jazz2::Multiplayer
 	{
 		Main,
 		UnreliableUpdates,
+		Transfer,		// Reliable channel for large transfers, it doesn't block the main channel
 		Count
 	};
 
@@ -53,13 +55,51 @@ namespace Jazz2::Multiplayer
 
 		NetworkState GetState() const;
 
+		/**
+		 * @brief Enqueues a message for sending, it's batched with other messages for the same peer and channel until the next @ref Flush()
+		 *
+		 * Messages for peers that are not connected are dropped. Batches are staged per calling thread, so no lock is taken.
+		 */
 		void SendToPeer(const Peer& peer, NetworkChannel channel, const std::uint8_t* data, std::size_t dataLength);
+		/** @brief Enqueues a message for sending to all connected peers, it's batched until the next @ref Flush() */
 		void SendToAll(NetworkChannel channel, const std::uint8_t* data, std::size_t dataLength);
+		/** @brief Closes all batches of the calling thread and wakes up the network thread to send them, it should be called once per tick */
+		void Flush();
+		/**
+		 * @brief Returns how many bytes can be enqueued for the peer on reliable channels without exceeding its window
+		 *
+		 * Enqueued messages count against the window until they are acknowledged by the peer, so large transfers
+		 * can be paced by the actual throughput of the connection.
+		 */
+		std::uint32_t GetReliableSendCapacity(const Peer& peer);
 		void KickClient(const Peer& peer, Reason reason);
 
 	private:
 		static constexpr std::size_t MaxPeerCount = 64;
-		static constexpr std::uint32_t ProcessingIntervalMs = 4;
+		// ENet still needs to be serviced periodically to handle resends, pings and timeouts
+		static constexpr std::uint32_t MaxWaitTimeMs = 10;
+		// Unreliable batch should fit into a single datagram, because losing any fragment would drop the whole batch
+		static constexpr std::size_t MaxUnreliableBatchSize = 1200;
+		static constexpr std::size_t MaxReliableBatchSize = 32768;
+
+		// The last peer slot is used for the server connection on the client
+		static constexpr std::size_t ServerPeerSlot = MaxPeerCount;
+
+		/** @brief Pooled memory of one batch of messages, every message is prefixed by its length */
+		struct PacketBuffer {
+			NetworkManager* Owner;
+			PacketBuffer* Next;			// Link in the send queue or in the pool
+			std::uint32_t PeerSlot;
+			std::uint32_t Generation;	// Connection of the peer in the slot, the batch is discarded if it doesn't match anymore
+			NetworkChannel Channel;
+			SmallVector<std::uint8_t, 0> Data;
+		};
+
+		/** @brief Open batches of one thread, it's only accessed by the owning thread */
+		struct StagingArea {
+			PacketBuffer* Buffers[MaxPeerCount + 1][(std::size_t)NetworkChannel::Count];
+			PacketBuffer* FreeBuffers;
+		};
 
 		_ENetHost* _host;
 		Thread _thread;
@@ -68,12 +108,41 @@ namespace Jazz2::Multiplayer
 		INetworkHandler* _handler;
 		Mutex _lock;
 		std::unique_ptr<ServerDiscovery> _discovery;
+		std::int32_t _instanceId;
+		Mutex _stagingLock;						// Only taken when a thread sends its first message
+		SmallVector<std::unique_ptr<StagingArea>, 0> _stagingAreas;
+		Atomic32 _peerGenerations[MaxPeerCount + 1];	// Odd if the peer in the slot is connected, changed only by the network thread
+		Atomic32 _peerPendingReliableSizes[MaxPeerCount + 1];	// Bytes enqueued on reliable channels that were not released by ENet yet
+		PacketBuffer* volatile _sendQueue;		// Lock-free stack of closed batches in reverse order, drained by the network thread
+		PacketBuffer* volatile _returnedBuffers;	// Lock-free stack of buffers released by ENet, taken all at once by staging areas
+		ENetSocket _wakeSocket;				// Loopback socket used to wake up the network thread
+		ENetAddress _wakeAddress;
+		Atomic32 _wakePending;
 
 		static std::int32_t _initializeCount;
+		static std::int32_t _lastInstanceId;
 
 		static void InitializeBackend();
 		static void ReleaseBackend();
 
+		static std::size_t GetPeerSlot(_ENetPeer* peer);
+		void SetPeerConnected(_ENetPeer* peer, bool connected);
+		void RemovePeer(_ENetPeer* peer);
+		StagingArea& GetStagingArea();
+		void AppendToBatch(StagingArea& staging, std::size_t peerSlot, std::uint32_t generation, NetworkChannel channel, const std::uint8_t* data, std::size_t dataLength);
+		void CloseBatch(PacketBuffer*& buffer);
+		void CloseStagedBatches(StagingArea& staging);
+		PacketBuffer* AcquireBuffer(StagingArea& staging);
+		void ReleaseBuffer(PacketBuffer* buffer);
+		static void PushBuffer(PacketBuffer* volatile* stack, PacketBuffer* buffer);
+		static void DeleteBuffers(PacketBuffer* buffer);
+		void ProcessSendQueue(bool discard);
+		void DispatchPacket(_ENetPeer* peer, std::uint8_t channelId, std::uint8_t* data, std::size_t dataLength);
+		void WaitForEvents(_ENetHost* host, std::uint32_t timeoutMs);
+		void CreateWakeSocket();
+		void DestroyWakeSocket();
+
+		static void ENET_CALLBACK OnPacketFreed(void* packet);
 		static void OnClientThread(void* param);
 		static void OnServerThread(void* param);
 	};
@@ -14,12 +14,10 @@ namespace Jazz2
 		_renderCommandsCount = 0;
 		_emittedLightsCache.clear();
 
-		// Collect all active light emitters
-		auto actors = _owner->_levelHandler->GetActors();
-		std::size_t actorsCount = actors.size();
-		for (std::size_t i = 0; i < actorsCount; i++) {
-			actors[i]->OnEmitLights(_emittedLightsCache);
-		}
+		// Collect only lights that affect the view, all commands share the same material, so they are batched together
+		Vector2i viewSize = _owner->_view->size();
+		Rectf viewBounds = Rectf(_owner->_cameraPos.X - viewSize.X * 0.5f, _owner->_cameraPos.Y - viewSize.Y * 0.5f, (float)viewSize.X, (float)viewSize.Y);
+		_owner->_levelHandler->QueryVisibleLights(viewBounds, _emittedLightsCache);
 
 		for (auto& light : _emittedLightsCache) {
 			auto command = RentRenderCommand();
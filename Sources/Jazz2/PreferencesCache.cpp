@@ -377,7 +377,7 @@ namespace Jazz2
 				UI::ControlScheme::Reset();
 			}
 #	if defined(WITH_MULTIPLAYER)
-			else if (InitialState.empty() && (arg == "/server"_s || arg.hasPrefix("/connect:"_s))) {
+			else if (InitialState.empty() && (arg == "/server"_s || arg.hasPrefix("/server:"_s) || arg.hasPrefix("/connect:"_s))) {
 				InitialState = arg;
 			}
 #	endif
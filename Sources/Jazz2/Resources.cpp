@@ -3,10 +3,91 @@
 namespace Jazz2
 {
 	GenericGraphicResource::GenericGraphicResource() noexcept
-		: Flags(GenericGraphicResourceFlags::None)
+		: Flags(GenericGraphicResourceFlags::None), MaskStride(0)
 	{
 	}
 
+	void GenericGraphicResource::CreateMask(const std::uint32_t* pixels, std::int32_t width)
+	{
+		InitializeMask();
+
+		std::int32_t height = FrameDimensions.Y * FrameConfiguration.Y;
+		for (std::int32_t y = 0; y < height; y++) {
+			UpdateMaskRow(pixels + y * width, y);
+		}
+	}
+
+	void GenericGraphicResource::InitializeMask()
+	{
+		std::int32_t frameCount = FrameConfiguration.X * FrameConfiguration.Y;
+		MaskStride = (FrameDimensions.X + 63) / 64;
+		Mask = std::make_unique<std::uint64_t[]>(frameCount * FrameDimensions.Y * MaskStride * 2);
+	}
+
+	void GenericGraphicResource::UpdateMaskRow(const std::uint32_t* row, std::int32_t y)
+	{
+		std::int32_t frameWidth = FrameDimensions.X;
+		std::int32_t frameHeight = FrameDimensions.Y;
+		std::int32_t frameCount = FrameConfiguration.X * FrameConfiguration.Y;
+		std::int32_t frameRow = y / frameHeight;
+		if (frameRow >= FrameConfiguration.Y) {
+			return;
+		}
+
+		std::int32_t frameSize = frameHeight * MaskStride;
+		std::int32_t rowOffset = (y % frameHeight) * MaskStride;
+
+		for (std::int32_t fx = 0; fx < FrameConfiguration.X; fx++) {
+			std::int32_t frame = frameRow * FrameConfiguration.X + fx;
+			const std::uint32_t* src = row + fx * frameWidth;
+			std::uint64_t* dst = &Mask[frame * frameSize + rowOffset];
+			std::uint64_t* dstMirrored = &Mask[(frameCount + frame) * frameSize + rowOffset];
+
+			// Whole words are built at once without branches, so the loops can be vectorized
+			for (std::int32_t x = 0; x < frameWidth; x += 64) {
+				std::int32_t count = std::min(64, frameWidth - x);
+				std::uint64_t bits = 0;
+				std::uint64_t bitsMirrored = 0;
+				for (std::int32_t i = 0; i < count; i++) {
+					bits |= std::uint64_t(((src[x + i] >> 24) & 0xff) > AlphaThreshold) << i;
+					bitsMirrored |= std::uint64_t(((src[frameWidth - 1 - (x + i)] >> 24) & 0xff) > AlphaThreshold) << i;
+				}
+				dst[x / 64] = bits;
+				dstMirrored[x / 64] = bitsMirrored;
+			}
+		}
+	}
+
+	std::uint64_t GenericGraphicResource::GetMaskBits(std::int32_t frame, std::int32_t x, std::int32_t y, bool mirrored) const noexcept
+	{
+		if (y < 0 || y >= FrameDimensions.Y || x >= FrameDimensions.X || x <= -64) {
+			return 0;
+		}
+
+		if (mirrored) {
+			frame += FrameConfiguration.X * FrameConfiguration.Y;
+		}
+
+		const std::uint64_t* row = &Mask[(frame * FrameDimensions.Y + y) * MaskStride];
+		if (x < 0) {
+			return (row[0] << -x);
+		}
+
+		std::int32_t word = x / 64;
+		std::int32_t shift = x % 64;
+		std::uint64_t bits = (row[word] >> shift);
+		if (shift != 0 && word + 1 < MaskStride) {
+			bits |= (row[word + 1] << (64 - shift));
+		}
+		return bits;
+	}
+
+	bool GenericGraphicResource::IsMaskPixelSet(std::int32_t frame, std::int32_t x, std::int32_t y) const noexcept
+	{
+		const std::uint64_t* row = &Mask[(frame * FrameDimensions.Y + y) * MaskStride];
+		return ((row[x / 64] >> (x % 64)) & 1) != 0;
+	}
+
 	GraphicResource::GraphicResource() noexcept
 	{
 	}
@@ -31,10 +31,14 @@ namespace Jazz2
 
 	struct GenericGraphicResource
 	{
+		/** @brief Minimum alpha value of a pixel to be considered solid in collision mask */
+		static constexpr std::uint8_t AlphaThreshold = 40;
+
 		GenericGraphicResourceFlags Flags;
 		std::unique_ptr<Texture> TextureDiffuse;
 		//std::unique_ptr<Texture> TextureNormal;
-		std::unique_ptr<uint8_t[]> Mask;
+		std::unique_ptr<std::uint64_t[]> Mask;	// 1 bit per pixel, row-major per frame, followed by horizontally mirrored frames
+		std::int32_t MaskStride;				// Number of 64-bit words per row of a frame
 		Vector2i FrameDimensions;
 		Vector2i FrameConfiguration;
 		float AnimDuration;
@@ -44,6 +48,17 @@ namespace Jazz2
 		Vector2i Gunspot;
 
 		GenericGraphicResource() noexcept;
+
+		/** @brief Creates bit-packed collision mask from alpha channel, @ref FrameDimensions and @ref FrameConfiguration must be already set */
+		void CreateMask(const std::uint32_t* pixels, std::int32_t width);
+		/** @brief Allocates empty collision mask, it can be then filled row by row using @ref UpdateMaskRow() */
+		void InitializeMask();
+		/** @brief Updates collision mask of all frames that intersect a given row of the whole image */
+		void UpdateMaskRow(const std::uint32_t* row, std::int32_t y);
+		/** @brief Returns 64 mask bits of a frame row starting at a given pixel, pixels outside of the frame are always empty */
+		std::uint64_t GetMaskBits(std::int32_t frame, std::int32_t x, std::int32_t y, bool mirrored) const noexcept;
+		/** @brief Returns `true` if a given pixel of a frame is solid */
+		bool IsMaskPixelSet(std::int32_t frame, std::int32_t x, std::int32_t y) const noexcept;
 	};
 
 	struct GraphicResource
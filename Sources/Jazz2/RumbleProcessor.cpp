@@ -61,12 +61,12 @@ namespace Jazz2
 			return;
 		}
 
-		auto& inputManager = theApplication().GetInputManager();
-
 		if (_activeRumble.empty()) {
 			return;
 		}
 
+		auto& inputManager = theApplication().GetInputManager();
+
 		for (std::int32_t j = 0; j < UI::ControlScheme::MaxConnectedGamepads; j++) {
 			if (!inputManager.isJoyPresent(j)) {
 				// Allow rumble only for connected gamepads
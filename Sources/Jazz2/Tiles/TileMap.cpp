@@ -3,12 +3,27 @@
 #include "../PreferencesCache.h"
 
 #include "../../nCine/tracy.h"
+#include "../../nCine/ServiceLocator.h"
 #include "../../nCine/Base/Random.h"
 #include "../../nCine/Graphics/RenderQueue.h"
 #include "../../nCine/Graphics/RenderResources.h"
 
 namespace Jazz2::Tiles
 {
+	struct TileMap::LayerRenderContext
+	{
+		LayerRenderContext()
+			: RenderCommandsCount(0), ChunkRenderCommandsCount(0)
+		{
+		}
+
+		RenderQueue Queue;
+		SmallVector<std::unique_ptr<RenderCommand>, 0> RenderCommands;
+		std::int32_t RenderCommandsCount;
+		SmallVector<std::unique_ptr<RenderCommand>, 0> ChunkRenderCommands;
+		std::int32_t ChunkRenderCommandsCount;
+	};
+
 	TileMap::TileMap(const StringView tileSetPath, std::uint16_t captionTileId, bool applyPalette)
 		: _owner(nullptr), _sprLayerIndex(-1), _pitType(PitType::FallForever), _renderCommandsCount(0), _collapsingTimer(0.0f),
 			_triggerState(ValueInit, TriggerCount), _texturedBackgroundLayer(-1), _texturedBackgroundPass(this)
@@ -26,6 +41,7 @@ namespace Jazz2::Tiles
 	TileMap::~TileMap()
 	{
 		TracyPlot("TileMap Render Commands", 0LL);
+		TracyPlot("TileMap Chunk Render Commands", 0LL);
 	}
 
 	bool TileMap::IsValid() const
@@ -165,6 +181,10 @@ namespace Jazz2::Tiles
 		// The command cache must be reset every frame,
 		// OnDraw() is called multiple times if multiple viewports are active
 		_renderCommandsCount = 0;
+		for (auto& context : _layerContexts) {
+			context->RenderCommandsCount = 0;
+			context->ChunkRenderCommandsCount = 0;
+		}
 	}
 
 	bool TileMap::OnDraw(RenderQueue& renderQueue)
@@ -175,13 +195,33 @@ namespace Jazz2::Tiles
 		Rectf cullingRect = viewport->cullingRect();
 		Vector2f viewCenter = cullingRect.Center();
 
-		for (auto& layer : _layers) {
-			DrawLayer(renderQueue, layer, cullingRect, viewCenter);
+		while (_layerContexts.size() < _layers.size()) {
+			_layerContexts.emplace_back(std::make_unique<LayerRenderContext>());
+		}
+
+		// Each layer is prepared on a worker thread into its own queue and command arena, including culling of tiles,
+		// packing of uniform blocks and calculation of sort keys. Shader programs are shared, but assigning them to
+		// materials only reads them, because their default attributes are set up already when they are linked.
+		theServiceLocator().GetThreadPool().ParallelFor(0, (std::int32_t)_layers.size(), 1, [this, &cullingRect, &viewCenter](std::int32_t begin, std::int32_t end) {
+			for (std::int32_t i = begin; i < end; i++) {
+				DrawLayer(*_layerContexts[i], _layers[i], cullingRect, viewCenter);
+			}
+		});
+
+		// Commands are merged in the layer order, so the result doesn't depend on scheduling
+		std::int32_t renderCommandsCount = 0;
+		std::int32_t chunkRenderCommandsCount = 0;
+		for (std::size_t i = 0; i < _layers.size(); i++) {
+			LayerRenderContext& context = *_layerContexts[i];
+			renderQueue.appendCommands(context.Queue);
+			renderCommandsCount += context.RenderCommandsCount;
+			chunkRenderCommandsCount += context.ChunkRenderCommandsCount;
 		}
 
 		DrawDebris(renderQueue);
 
-		TracyPlot("TileMap Render Commands", static_cast<std::int64_t>(_renderCommandsCount));
+		TracyPlot("TileMap Render Commands", static_cast<std::int64_t>(renderCommandsCount + _renderCommandsCount));
+		TracyPlot("TileMap Chunk Render Commands", static_cast<std::int64_t>(chunkRenderCommandsCount));
 
 		return true;
 	}
@@ -321,15 +361,13 @@ namespace Jazz2::Tiles
 						bottom = (TileSet::DefaultTileSize - 1 - top2);
 					}
 
-					top *= TileSet::DefaultTileSize;
-					bottom *= TileSet::DefaultTileSize;
+					// Each mask row is one 32-bit word, so the whole span can be tested at once
+					std::uint32_t span = (~0u >> (TileSet::DefaultTileSize - 1 - (right - left))) << left;
 
-					std::uint8_t* mask = tileSet->GetTileMask(tileId);
-					for (std::int32_t ry = top; ry <= bottom; ry += TileSet::DefaultTileSize) {
-						for (std::int32_t rx = left; rx <= right; rx++) {
-							if (mask[ry | rx]) {
-								return false;
-							}
+					const std::uint32_t* mask = tileSet->GetTileMask(tileId);
+					for (std::int32_t ry = top; ry <= bottom; ry++) {
+						if (mask[ry] & span) {
+							return false;
 						}
 					}
 				}
@@ -434,15 +472,13 @@ namespace Jazz2::Tiles
 						bottom = (TileSet::DefaultTileSize - 1 - top2);
 					}
 
-					top *= TileSet::DefaultTileSize;
-					bottom *= TileSet::DefaultTileSize;
+					// Each mask row is one 32-bit word, so the whole span can be tested at once
+					std::uint32_t span = (~0u >> (TileSet::DefaultTileSize - 1 - (right - left))) << left;
 
-					std::uint8_t* mask = tileSet->GetTileMask(tileId);
-					for (std::int32_t ry = top; ry <= bottom; ry += TileSet::DefaultTileSize) {
-						for (std::int32_t rx = left; rx <= right; rx++) {
-							if (mask[ry | rx]) {
-								return false;
-							}
+					const std::uint32_t* mask = tileSet->GetTileMask(tileId);
+					for (std::int32_t ry = top; ry <= bottom; ry++) {
+						if (mask[ry] & span) {
+							return false;
 						}
 					}
 				}
@@ -506,7 +542,7 @@ namespace Jazz2::Tiles
 			return SuspendType::None;
 		}
 
-		std::uint8_t* mask = tileSet->GetTileMask(tileId);
+		const std::uint32_t* mask = tileSet->GetTileMask(tileId);
 
 		std::int32_t rx = (std::int32_t)x & 31;
 		std::int32_t ry = (std::int32_t)y & 31;
@@ -518,11 +554,12 @@ namespace Jazz2::Tiles
 			ry = (TileSet::DefaultTileSize - 1 - ry);
 		}
 
-		std::int32_t top = std::max(ry - Tolerance, 0) << 5;
-		std::int32_t bottom = std::min(ry + Tolerance, TileSet::DefaultTileSize - 1) << 5;
+		std::int32_t top = std::max(ry - Tolerance, 0);
+		std::int32_t bottom = std::min(ry + Tolerance, TileSet::DefaultTileSize - 1);
+		std::uint32_t bit = (1u << rx);
 
-		for (std::int32_t ti = bottom | rx; ti >= top; ti -= TileSet::DefaultTileSize) {
-			if (mask[ti]) {
+		for (std::int32_t ti = bottom; ti >= top; ti--) {
+			if (mask[ti] & bit) {
 				return tile.HasSuspendType;
 			}
 		}
@@ -584,6 +621,7 @@ namespace Jazz2::Tiles
 				std::int32_t amount = 1;
 				if (!AdvanceDestructibleTileAnimation(tile, tilePos.X, tilePos.Y, amount, "SceneryCollapse"_s)) {
 					tile.DestructType = TileDestructType::None;
+					InvalidateLayerChunk(_layers[_sprLayerIndex], tilePos.X, tilePos.Y);
 					it = _activeCollapsingTiles.eraseUnordered(it);
 					continue;
 				} else {
@@ -596,7 +634,7 @@ namespace Jazz2::Tiles
 		}
 	}
 
-	void TileMap::DrawLayer(RenderQueue& renderQueue, TileMapLayer& layer, const Rectf& cullingRect, const Vector2f& viewCenter)
+	void TileMap::DrawLayer(LayerRenderContext& context, TileMapLayer& layer, const Rectf& cullingRect, const Vector2f& viewCenter)
 	{
 		ZoneScopedNC("Layer", 0xA09359);
 
@@ -617,7 +655,7 @@ namespace Jazz2::Tiles
 		if (layer.Description.RendererType >= LayerRendererType::Sky && layer.Description.RendererType <= LayerRendererType::Circle && tileCount.Y == 8 && tileCount.X == 8) {
 			constexpr float PerspectiveSpeedX = 0.4f;
 			constexpr float PerspectiveSpeedY = 0.16f;
-			RenderTexturedBackground(renderQueue, cullingRect, viewCenter, layer, x1 * PerspectiveSpeedX + loX, y1 * PerspectiveSpeedY + loY);
+			RenderTexturedBackground(context, cullingRect, viewCenter, layer, x1 * PerspectiveSpeedX + loX, y1 * PerspectiveSpeedY + loY);
 		} else {
 			float xt, yt;
 			switch (layer.Description.SpeedModelX) {
@@ -718,6 +756,14 @@ namespace Jazz2::Tiles
 			float x3 = x1 + (TileSet::DefaultTileSize * 2) + cullingRect.W;
 			float y3 = y1 + (TileSet::DefaultTileSize * 2) + cullingRect.H;
 
+			if (layer.Description.RendererType == LayerRendererType::Default) {
+				// Static tiles are prebaked into chunk meshes, so only a few commands are needed for the whole layer
+				std::int32_t tileCountX = (std::int32_t)((x3 - x1) / TileSet::DefaultTileSize) + 1;
+				std::int32_t tileCountY = (std::int32_t)((y3 - y1) / TileSet::DefaultTileSize) + 1;
+				DrawLayerChunks(context, layer, x1, y1, tileAbsX + 1, tileAbsY + 1, tileCountX, tileCountY);
+				return;
+			}
+
 			std::int32_t tile_xo = -1;
 			for (float x2 = x1; x2 <= x3; x2 += TileSet::DefaultTileSize) {
 				tileX = (tileX + 1) % tileCount.X;
@@ -743,58 +789,255 @@ namespace Jazz2::Tiles
 						}
 					}
 
-					std::int32_t tileId = ResolveTileID(tile);
-					if (tileId == 0 || tile.Alpha == 0) {
-						continue;
-					}
-					TileSet* tileSet = ResolveTileSet(tileId);
-					if (tileSet == nullptr) {
-						continue;
-					}
+					DrawTile(context, layer, tile, x2, y2);
+				}
+			}
+		}
+	}
+
+	void TileMap::DrawLayerChunks(LayerRenderContext& context, TileMapLayer& layer, float x1, float y1, std::int32_t firstTileX, std::int32_t firstTileY, std::int32_t tileCountX, std::int32_t tileCountY)
+	{
+		Vector2i layoutSize = layer.LayoutSize;
+		Vector2i chunkCount = (layoutSize + (ChunkSize - 1)) / ChunkSize;
+
+		if (layer.Chunks == nullptr) {
+			std::int32_t totalCount = chunkCount.X * chunkCount.Y;
+			layer.Chunks = std::make_unique<TileMapChunk[]>(totalCount);
+			for (std::int32_t i = 0; i < totalCount; i++) {
+				layer.Chunks[i].IsDirty = true;
+			}
+		}
+
+		// Tile coordinates are absolute (not wrapped), the last ones are inclusive
+		std::int32_t lastTileX = firstTileX + tileCountX - 1;
+		std::int32_t lastTileY = firstTileY + tileCountY - 1;
+		if (!layer.Description.RepeatX) {
+			firstTileX = std::max(firstTileX, 0);
+			lastTileX = std::min(lastTileX, layoutSize.X - 1);
+		}
+		if (!layer.Description.RepeatY) {
+			firstTileY = std::max(firstTileY, 0);
+			lastTileY = std::min(lastTileY, layoutSize.Y - 1);
+		}
+		if (firstTileX > lastTileX || firstTileY > lastTileY) {
+			return;
+		}
+
+		// Position of the absolute tile (0, 0), the first visible tile is placed at (x1, y1)
+		float originX = x1 - firstTileX * TileSet::DefaultTileSize;
+		float originY = y1 - firstTileY * TileSet::DefaultTileSize;
+
+		std::int32_t tileX = firstTileX;
+		while (tileX <= lastTileX) {
+			std::int32_t layoutX = tileX % layoutSize.X;
+			if (layoutX < 0) {
+				layoutX += layoutSize.X;
+			}
+			std::int32_t cx = layoutX / ChunkSize;
+			std::int32_t chunkTileX = tileX - (layoutX - cx * ChunkSize);
+			std::int32_t chunkWidth = std::min(ChunkSize, layoutSize.X - cx * ChunkSize);
+
+			std::int32_t tileY = firstTileY;
+			while (tileY <= lastTileY) {
+				std::int32_t layoutY = tileY % layoutSize.Y;
+				if (layoutY < 0) {
+					layoutY += layoutSize.Y;
+				}
+				std::int32_t cy = layoutY / ChunkSize;
+				std::int32_t chunkTileY = tileY - (layoutY - cy * ChunkSize);
+				std::int32_t chunkHeight = std::min(ChunkSize, layoutSize.Y - cy * ChunkSize);
+
+				TileMapChunk& chunk = layer.Chunks[cx + cy * chunkCount.X];
+				if (chunk.IsDirty) {
+					RebuildLayerChunk(layer, cx, cy);
+				}
+
+				float x2 = originX + chunkTileX * TileSet::DefaultTileSize;
+				float y2 = originY + chunkTileY * TileSet::DefaultTileSize;
+				if (!PreferencesCache::UnalignedViewport) {
+					x2 = std::floor(x2); y2 = std::floor(y2);
+				}
 
-					auto command = RentRenderCommand(layer.Description.RendererType);
+				for (auto& mesh : chunk.Meshes) {
+					auto command = RentChunkRenderCommand(context);
 					command->setType(RenderCommand::Type::TileMap);
 					command->material().setBlendingFactors(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-					Vector2i texSize = tileSet->TextureDiffuse->size();
-					float texScaleX = TileSet::DefaultTileSize / float(texSize.X);
-					float texBiasX = ((tileId % tileSet->TilesPerRow) * (TileSet::DefaultTileSize + 2.0f) + 1.0f) / float(texSize.X);
-					float texScaleY = TileSet::DefaultTileSize / float(texSize.Y);
-					float texBiasY = ((tileId / tileSet->TilesPerRow) * (TileSet::DefaultTileSize + 2.0f) + 1.0f) / float(texSize.Y);
+					auto instanceBlock = command->material().uniformBlock(Material::InstanceBlockName);
+					instanceBlock->uniform(Material::TexRectUniformName)->setFloatValue(1.0f, 0.0f, 1.0f, 0.0f);
+					instanceBlock->uniform(Material::SpriteSizeUniformName)->setFloatValue(1.0f, 1.0f);
+					instanceBlock->uniform(Material::ColorUniformName)->setFloatVector(layer.Description.Color.Data());
 
-					// ToDo: Flip normal map somehow
-					if ((tile.Flags & LayerTileFlags::FlipX) == LayerTileFlags::FlipX) {
-						texBiasX += texScaleX;
-						texScaleX *= -1;
-					}
-					if ((tile.Flags & LayerTileFlags::FlipY) == LayerTileFlags::FlipY) {
-						texBiasY += texScaleY;
-						texScaleY *= -1;
-					}
+					command->geometry().setDrawParameters(GL_TRIANGLE_STRIP, 0, (GLsizei)(mesh.Vertices.size() / 4));
+					command->geometry().setHostVertexPointer(mesh.Vertices.data());
 
-					auto instanceBlock = command->material().uniformBlock(Material::InstanceBlockName);
-					instanceBlock->uniform(Material::TexRectUniformName)->setFloatValue(texScaleX, texBiasX, texScaleY, texBiasY);
-					instanceBlock->uniform(Material::SpriteSizeUniformName)->setFloatValue(TileSet::DefaultTileSize, TileSet::DefaultTileSize);
+					command->setTransformation(Matrix4x4f::Translation(x2, y2, 0.0f));
+					command->setLayer(layer.Description.Depth);
+					command->material().setTexture(*mesh.TileSetData->TextureDiffuse);
 
-					Vector4f color = layer.Description.Color;
-					color.W *= tile.Alpha / 255.0f;
-					instanceBlock->uniform(Material::ColorUniformName)->setFloatVector(color.Data());
+					context.Queue.addCommand(command);
+				}
 
-					float x2r = x2, y2r = y2;
-					if (!PreferencesCache::UnalignedViewport) {
-						x2r = std::floor(x2r); y2r = std::floor(y2r);
+				for (std::int32_t tileIdx : chunk.DynamicTiles) {
+					std::int32_t tx = chunkTileX + (tileIdx % layoutSize.X) - cx * ChunkSize;
+					std::int32_t ty = chunkTileY + (tileIdx / layoutSize.X) - cy * ChunkSize;
+					if (tx < firstTileX || tx > lastTileX || ty < firstTileY || ty > lastTileY) {
+						continue;
 					}
 
-					command->setTransformation(Matrix4x4f::Translation(x2r, y2r, 0.0f));
-					command->setLayer(layer.Description.Depth);
-					command->material().setTexture(*tileSet->TextureDiffuse);
+					DrawTile(context, layer, layer.Layout[tileIdx], originX + tx * TileSet::DefaultTileSize, originY + ty * TileSet::DefaultTileSize);
+				}
+
+				tileY = chunkTileY + chunkHeight;
+			}
+
+			tileX = chunkTileX + chunkWidth;
+		}
+	}
+
+	void TileMap::DrawTile(LayerRenderContext& context, TileMapLayer& layer, LayerTile& tile, float x, float y)
+	{
+		std::int32_t tileId = ResolveTileID(tile);
+		if (tileId == 0 || tile.Alpha == 0) {
+			return;
+		}
+		TileSet* tileSet = ResolveTileSet(tileId);
+		if (tileSet == nullptr) {
+			return;
+		}
+
+		auto command = RentRenderCommand(context.RenderCommands, context.RenderCommandsCount, layer.Description.RendererType);
+		command->setType(RenderCommand::Type::TileMap);
+		command->material().setBlendingFactors(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-					renderQueue.addCommand(command);
+		Vector2i texSize = tileSet->TextureDiffuse->size();
+		float texScaleX = TileSet::DefaultTileSize / float(texSize.X);
+		float texBiasX = ((tileId % tileSet->TilesPerRow) * (TileSet::DefaultTileSize + 2.0f) + 1.0f) / float(texSize.X);
+		float texScaleY = TileSet::DefaultTileSize / float(texSize.Y);
+		float texBiasY = ((tileId / tileSet->TilesPerRow) * (TileSet::DefaultTileSize + 2.0f) + 1.0f) / float(texSize.Y);
+
+		// ToDo: Flip normal map somehow
+		if ((tile.Flags & LayerTileFlags::FlipX) == LayerTileFlags::FlipX) {
+			texBiasX += texScaleX;
+			texScaleX *= -1;
+		}
+		if ((tile.Flags & LayerTileFlags::FlipY) == LayerTileFlags::FlipY) {
+			texBiasY += texScaleY;
+			texScaleY *= -1;
+		}
+
+		auto instanceBlock = command->material().uniformBlock(Material::InstanceBlockName);
+		instanceBlock->uniform(Material::TexRectUniformName)->setFloatValue(texScaleX, texBiasX, texScaleY, texBiasY);
+		instanceBlock->uniform(Material::SpriteSizeUniformName)->setFloatValue(TileSet::DefaultTileSize, TileSet::DefaultTileSize);
+
+		Vector4f color = layer.Description.Color;
+		color.W *= tile.Alpha / 255.0f;
+		instanceBlock->uniform(Material::ColorUniformName)->setFloatVector(color.Data());
+
+		if (!PreferencesCache::UnalignedViewport) {
+			x = std::floor(x); y = std::floor(y);
+		}
+
+		command->setTransformation(Matrix4x4f::Translation(x, y, 0.0f));
+		command->setLayer(layer.Description.Depth);
+		command->material().setTexture(*tileSet->TextureDiffuse);
+
+		context.Queue.addCommand(command);
+	}
+
+	void TileMap::RebuildLayerChunk(TileMapLayer& layer, std::int32_t cx, std::int32_t cy)
+	{
+		ZoneScopedC(0xA09359);
+
+		Vector2i layoutSize = layer.LayoutSize;
+		std::int32_t chunkCountX = (layoutSize.X + ChunkSize - 1) / ChunkSize;
+		TileMapChunk& chunk = layer.Chunks[cx + cy * chunkCountX];
+		chunk.Meshes.clear();
+		chunk.DynamicTiles.clear();
+		chunk.IsDirty = false;
+
+		std::int32_t x1 = cx * ChunkSize;
+		std::int32_t y1 = cy * ChunkSize;
+		std::int32_t x2 = std::min(x1 + ChunkSize, layoutSize.X);
+		std::int32_t y2 = std::min(y1 + ChunkSize, layoutSize.Y);
+
+		for (std::int32_t y = y1; y < y2; y++) {
+			for (std::int32_t x = x1; x < x2; x++) {
+				std::int32_t tileIdx = x + y * layoutSize.X;
+				LayerTile& tile = layer.Layout[tileIdx];
+				if (tile.Alpha == 0) {
+					continue;
+				}
+
+				// Tiles that can change over time or need their own color are still drawn one by one
+				if ((tile.Flags & LayerTileFlags::Animated) == LayerTileFlags::Animated || tile.DestructType != TileDestructType::None || tile.Alpha != 255) {
+					chunk.DynamicTiles.push_back(tileIdx);
+					continue;
+				}
+
+				std::int32_t tileId = tile.TileID;
+				if (tileId == 0) {
+					continue;
+				}
+				TileSet* tileSet = ResolveTileSet(tileId);
+				if (tileSet == nullptr) {
+					continue;
 				}
+
+				TileMapChunkMesh* mesh = nullptr;
+				for (auto& item : chunk.Meshes) {
+					if (item.TileSetData == tileSet) {
+						mesh = &item;
+						break;
+					}
+				}
+				if (mesh == nullptr) {
+					mesh = &chunk.Meshes.emplace_back();
+					mesh->TileSetData = tileSet;
+					mesh->Vertices.reserve(ChunkSize * ChunkSize * 6 * 4);
+				}
+
+				Vector2i texSize = tileSet->TextureDiffuse->size();
+				float u1 = ((tileId % tileSet->TilesPerRow) * (TileSet::DefaultTileSize + 2.0f) + 1.0f) / float(texSize.X);
+				float v1 = ((tileId / tileSet->TilesPerRow) * (TileSet::DefaultTileSize + 2.0f) + 1.0f) / float(texSize.Y);
+				float u2 = u1 + TileSet::DefaultTileSize / float(texSize.X);
+				float v2 = v1 + TileSet::DefaultTileSize / float(texSize.Y);
+				if ((tile.Flags & LayerTileFlags::FlipX) == LayerTileFlags::FlipX) {
+					std::swap(u1, u2);
+				}
+				if ((tile.Flags & LayerTileFlags::FlipY) == LayerTileFlags::FlipY) {
+					std::swap(v1, v2);
+				}
+
+				float px1 = (float)((x - x1) * TileSet::DefaultTileSize);
+				float py1 = (float)((y - y1) * TileSet::DefaultTileSize);
+				float px2 = px1 + TileSet::DefaultTileSize;
+				float py2 = py1 + TileSet::DefaultTileSize;
+
+				// The first and the last vertex are duplicated to create degenerate triangles between adjacent tiles
+				const float vertices[] = {
+					px2, py1, u2, v1,
+					px2, py1, u2, v1,
+					px2, py2, u2, v2,
+					px1, py1, u1, v1,
+					px1, py2, u1, v2,
+					px1, py2, u1, v2
+				};
+				mesh->Vertices.append(vertices, vertices + arraySize(vertices));
 			}
 		}
 	}
 
+	void TileMap::InvalidateLayerChunk(TileMapLayer& layer, std::int32_t tx, std::int32_t ty)
+	{
+		if (layer.Chunks == nullptr) {
+			return;
+		}
+
+		std::int32_t chunkCountX = (layer.LayoutSize.X + ChunkSize - 1) / ChunkSize;
+		layer.Chunks[(tx / ChunkSize) + (ty / ChunkSize) * chunkCountX].IsDirty = true;
+	}
+
 	float TileMap::TranslateCoordinate(float coordinate, float speed, float offset, std::int32_t viewSize, bool isY)
 	{
 		std::int32_t alignment = ((isY ? (viewSize - 200) : (viewSize - 320)) / 2) + HardcodedOffset;
@@ -802,14 +1045,19 @@ namespace Jazz2::Tiles
 	}
 
 	RenderCommand* TileMap::RentRenderCommand(LayerRendererType type)
+	{
+		return RentRenderCommand(_renderCommands, _renderCommandsCount, type);
+	}
+
+	RenderCommand* TileMap::RentRenderCommand(SmallVectorImpl<std::unique_ptr<RenderCommand>>& renderCommands, std::int32_t& renderCommandsCount, LayerRendererType type)
 	{
 		RenderCommand* command;
-		if (_renderCommandsCount < _renderCommands.size()) {
-			command = _renderCommands[_renderCommandsCount].get();
-			_renderCommandsCount++;
+		if (renderCommandsCount < renderCommands.size()) {
+			command = renderCommands[renderCommandsCount].get();
+			renderCommandsCount++;
 		} else {
-			command = _renderCommands.emplace_back(std::make_unique<RenderCommand>()).get();
-			_renderCommandsCount++;
+			command = renderCommands.emplace_back(std::make_unique<RenderCommand>()).get();
+			renderCommandsCount++;
 			command->material().setBlendingEnabled(true);
 		}
 
@@ -833,6 +1081,29 @@ namespace Jazz2::Tiles
 		return command;
 	}
 
+	RenderCommand* TileMap::RentChunkRenderCommand(LayerRenderContext& context)
+	{
+		RenderCommand* command;
+		if (context.ChunkRenderCommandsCount < context.ChunkRenderCommands.size()) {
+			command = context.ChunkRenderCommands[context.ChunkRenderCommandsCount].get();
+			context.ChunkRenderCommandsCount++;
+		} else {
+			command = context.ChunkRenderCommands.emplace_back(std::make_unique<RenderCommand>()).get();
+			context.ChunkRenderCommandsCount++;
+			command->material().setBlendingEnabled(true);
+			command->material().setShaderProgramType(Material::ShaderProgramType::MeshSprite);
+			command->material().reserveUniformsDataMemory();
+			command->geometry().setNumElementsPerVertex(4);
+
+			GLUniformCache* textureUniform = command->material().uniform(Material::TextureUniformName);
+			if (textureUniform && textureUniform->intValue(0) != 0) {
+				textureUniform->setIntValue(0); // GL_TEXTURE0
+			}
+		}
+
+		return command;
+	}
+
 	void TileMap::AddTileSet(const StringView tileSetPath, std::uint16_t offset, std::uint16_t count, const std::uint8_t* paletteRemapping)
 	{
 		auto& tileSetPart = _tileSets.emplace_back();
@@ -1383,14 +1654,14 @@ namespace Jazz2::Tiles
 		dest.Write(_triggerState.data(), _triggerState.sizeInBytes());
 	}
 
-	void TileMap::RenderTexturedBackground(RenderQueue& renderQueue, const Rectf& cullingRect, const Vector2f& viewCenter, TileMapLayer& layer, float x, float y)
+	void TileMap::RenderTexturedBackground(LayerRenderContext& context, const Rectf& cullingRect, const Vector2f& viewCenter, TileMapLayer& layer, float x, float y)
 	{
 		auto target = _texturedBackgroundPass._target.get();
 		if (target == nullptr) {
 			return;
 		}
 
-		auto* command = RentRenderCommand(layer.Description.RendererType);
+		auto* command = RentRenderCommand(context.RenderCommands, context.RenderCommandsCount, layer.Description.RendererType);
 
 		auto* instanceBlock = command->material().uniformBlock(Material::InstanceBlockName);
 		instanceBlock->uniform(Material::TexRectUniformName)->setFloatValue(1.0f, 0.0f, 1.0f, 0.0f);
@@ -1406,7 +1677,7 @@ namespace Jazz2::Tiles
 		command->setLayer(layer.Description.Depth);
 		command->material().setTexture(*target);
 
-		renderQueue.addCommand(command);
+		context.Queue.addCommand(command);
 	}
 
 	void TileMap::OnInitializeViewport()
@@ -78,11 +78,23 @@ namespace Jazz2::Tiles
 											// Collapsible: Delay ("wait" parameter); Trigger: Trigger ID
 	};
 
+	struct TileMapChunkMesh {
+		TileSet* TileSetData;
+		SmallVector<float, 0> Vertices;		// Triangle strip with degenerate vertices between tiles (x, y, u, v)
+	};
+
+	struct TileMapChunk {
+		SmallVector<TileMapChunkMesh, 1> Meshes;	// Static tiles baked into one mesh per tile set
+		SmallVector<std::int32_t, 0> DynamicTiles;	// Animated, destructible or translucent tiles that are drawn separately
+		bool IsDirty;
+	};
+
 	struct TileMapLayer {
 		std::unique_ptr<LayerTile[]> Layout;
 		Vector2i LayoutSize;
 		LayerDescription Description;
 		bool Visible;
+		std::unique_ptr<TileMapChunk[]> Chunks;		// Lazily created for layers with default renderer only
 	};
 
 	struct AnimatedTileFrame {
@@ -107,6 +119,7 @@ namespace Jazz2::Tiles
 		static constexpr std::int32_t TriggerCount = 32;
 		static constexpr std::int32_t AnimatedTileMask = 0x80000000;
 		static constexpr std::int32_t HardcodedOffset = 70;
+		static constexpr std::int32_t ChunkSize = 16;
 
 		enum class DebrisFlags {
 			None = 0x00,
@@ -238,16 +251,26 @@ namespace Jazz2::Tiles
 		float _collapsingTimer;
 		BitArray _triggerState;
 
+		/// Render queue and commands owned by a single layer, so layers can be prepared on worker threads
+		struct LayerRenderContext;
+
 		SmallVector<DestructibleDebris, 0> _debrisList;
 		SmallVector<std::unique_ptr<RenderCommand>, 0> _renderCommands;
 		std::int32_t _renderCommandsCount;
+		SmallVector<std::unique_ptr<LayerRenderContext>, 0> _layerContexts;
 
 		std::int32_t _texturedBackgroundLayer;
 		TexturedBackgroundPass _texturedBackgroundPass;
 
-		void DrawLayer(RenderQueue& renderQueue, TileMapLayer& layer, const Rectf& cullingRect, const Vector2f& viewCenter);
+		void DrawLayer(LayerRenderContext& context, TileMapLayer& layer, const Rectf& cullingRect, const Vector2f& viewCenter);
+		void DrawLayerChunks(LayerRenderContext& context, TileMapLayer& layer, float x1, float y1, std::int32_t firstTileX, std::int32_t firstTileY, std::int32_t tileCountX, std::int32_t tileCountY);
+		void DrawTile(LayerRenderContext& context, TileMapLayer& layer, LayerTile& tile, float x, float y);
+		void RebuildLayerChunk(TileMapLayer& layer, std::int32_t cx, std::int32_t cy);
+		void InvalidateLayerChunk(TileMapLayer& layer, std::int32_t tx, std::int32_t ty);
 		static float TranslateCoordinate(float coordinate, float speed, float offset, std::int32_t viewSize, bool isY);
 		RenderCommand* RentRenderCommand(LayerRendererType type);
+		static RenderCommand* RentRenderCommand(SmallVectorImpl<std::unique_ptr<RenderCommand>>& renderCommands, std::int32_t& renderCommandsCount, LayerRendererType type);
+		static RenderCommand* RentChunkRenderCommand(LayerRenderContext& context);
 
 		bool AdvanceDestructibleTileAnimation(LayerTile& tile, std::int32_t tx, std::int32_t ty, std::int32_t& amount, const StringView soundName);
 		void AdvanceCollapsingTileTimers(float timeMult);
@@ -256,7 +279,7 @@ namespace Jazz2::Tiles
 		void UpdateDebris(float timeMult);
 		void DrawDebris(RenderQueue& renderQueue);
 
-		void RenderTexturedBackground(RenderQueue& renderQueue, const Rectf& cullingRect, const Vector2f& viewCenter, TileMapLayer& layer, float x, float y);
+		void RenderTexturedBackground(LayerRenderContext& context, const Rectf& cullingRect, const Vector2f& viewCenter, TileMapLayer& layer, float x, float y);
 
 		TileSet* ResolveTileSet(std::int32_t& tileId);
 		std::int32_t ResolveTileID(LayerTile& tile);
@@ -2,7 +2,7 @@
 
 namespace Jazz2::Tiles
 {
-	TileSet::TileSet(std::uint16_t tileCount, std::unique_ptr<Texture> textureDiffuse, std::unique_ptr<uint8_t[]> mask, std::uint32_t maskSize, std::unique_ptr<Color[]> captionTile)
+	TileSet::TileSet(std::uint16_t tileCount, std::unique_ptr<Texture> textureDiffuse, std::unique_ptr<std::uint32_t[]> mask, std::uint32_t maskSize, std::unique_ptr<Color[]> captionTile)
 		: TextureDiffuse(std::move(textureDiffuse)), _mask(std::move(mask)), _captionTile(std::move(captionTile)),
 			_isMaskEmpty(), _isMaskFilled(), _isTileFilled()
 	{
@@ -19,18 +19,18 @@ namespace Jazz2::Tiles
 		_isMaskFilled.resize(ValueInit, TileCount);
 		_isTileFilled.resize(ValueInit, TileCount);
 
-		std::uint32_t maskMaxTiles = maskSize / (DefaultTileSize * DefaultTileSize);
+		// Mask size is specified in rows, one row per 32-bit word
+		std::uint32_t maskMaxTiles = maskSize / DefaultTileSize;
 
 		for (std::uint32_t i = 0; i < tileCount; i++) {
 			bool maskEmpty = true;
 			bool maskFilled = true;
 
 			if (i < maskMaxTiles) {
-				auto maskOffset = &_mask[i * DefaultTileSize * DefaultTileSize];
-				for (std::int32_t x = 0; x < DefaultTileSize * DefaultTileSize; x++) {
-					bool masked = (maskOffset[x] > 0);
-					maskEmpty &= !masked;
-					maskFilled &= masked;
+				auto maskOffset = &_mask[i * DefaultTileSize];
+				for (std::int32_t y = 0; y < DefaultTileSize; y++) {
+					maskEmpty &= (maskOffset[y] == 0);
+					maskFilled &= (maskOffset[y] == ~0u);
 				}
 			}
 
@@ -10,19 +10,20 @@ namespace Jazz2::Tiles
 	public:
 		static constexpr std::int32_t DefaultTileSize = 32;
 
-		TileSet(std::uint16_t tileCount, std::unique_ptr<Texture> textureDiffuse, std::unique_ptr<std::uint8_t[]> mask, std::uint32_t maskSize, std::unique_ptr<Color[]> captionTile);
+		TileSet(std::uint16_t tileCount, std::unique_ptr<Texture> textureDiffuse, std::unique_ptr<std::uint32_t[]> mask, std::uint32_t maskSize, std::unique_ptr<Color[]> captionTile);
 
 		std::unique_ptr<Texture> TextureDiffuse;
 		std::int32_t TileCount;
 		std::int32_t TilesPerRow;
 
-		std::uint8_t* GetTileMask(std::int32_t tileId) const
+		/** @brief Returns collision mask of the tile as @ref DefaultTileSize rows, bit `x` of each row is set if pixel `x` is solid */
+		const std::uint32_t* GetTileMask(std::int32_t tileId) const
 		{
 			if (tileId >= TileCount) {
 				return nullptr;
 			}
 
-			return &_mask[tileId * DefaultTileSize * DefaultTileSize];
+			return &_mask[tileId * DefaultTileSize];
 		}
 
 		bool IsTileMaskEmpty(std::int32_t tileId) const
@@ -58,7 +59,7 @@ namespace Jazz2::Tiles
 		}
 
 	private:
-		std::unique_ptr<uint8_t[]> _mask;
+		std::unique_ptr<std::uint32_t[]> _mask;
 		std::unique_ptr<Color[]> _captionTile;
 		BitArray _isMaskEmpty;
 		BitArray _isMaskFilled;
@@ -15,6 +15,7 @@
 #include "nCine/IAppEventHandler.h"
 #include "nCine/tracy.h"
 #include "nCine/Base/Timer.h"
+#include "nCine/Base/TimeStamp.h"
 #include "nCine/Graphics/BinaryShaderCache.h"
 #include "nCine/Graphics/RenderResources.h"
 #include "nCine/Input/IInputEventHandler.h"
@@ -59,6 +60,7 @@ using namespace Jazz2::Multiplayer;
 #	include <cstdlib> // for `__argc` and `__argv`
 #endif
 
+#include <Containers/StaticArray.h>
 #include <Containers/StringConcatenable.h>
 #include <Cpu.h>
 #include <Environment.h>
@@ -89,6 +91,10 @@ public:
 #if defined(WITH_MULTIPLAYER)
 	static constexpr std::uint16_t MultiplayerDefaultPort = 7438;
 	static constexpr std::uint32_t MultiplayerProtocolVersion = 1;
+	// First level of the first episode, it's used if no level is specified for dedicated server
+	static constexpr char DedicatedServerDefaultLevel[] = "prince/01_castle1";
+	// Tick time percentiles of dedicated server are reported every 10 seconds
+	static constexpr std::size_t TickTimeSampleCount = 600;
 #endif
 
 	void OnPreInitialize(AppConfiguration& config) override;
@@ -142,6 +148,9 @@ private:
 	char _newestVersion[20];
 #if defined(WITH_MULTIPLAYER)
 	std::unique_ptr<NetworkManager> _networkManager;
+	bool _isDedicatedServer = false;
+	TimeStamp _tickStartTime;
+	SmallVector<float, 0> _tickTimes;
 #endif
 
 	void OnBeforeInitialize();
@@ -153,6 +162,10 @@ private:
 #endif
 	bool SetLevelHandler(const LevelInitialization& levelInit);
 	void RemoveResumableStateIfAny();
+#if defined(WITH_MULTIPLAYER)
+	void StartDedicatedServer();
+	void RecordTickTime(float milliseconds);
+#endif
 #if defined(DEATH_TARGET_ANDROID)
 	void ApplyActivityIcon();
 #endif
@@ -212,6 +225,25 @@ void GameEventHandler::OnPreInitialize(AppConfiguration& config)
 #if defined(WITH_IMGUI)
 	config.withDebugOverlay = true;
 #endif
+
+#if defined(WITH_MULTIPLAYER)
+	if (PreferencesCache::InitialState == "/server"_s || PreferencesCache::InitialState.hasPrefix("/server:"_s)) {
+		// Dedicated server only simulates the level at fixed tick rate, it doesn't draw anything and doesn't play any sounds,
+		// so only metadata and collision masks of sprites are needed
+		_isDedicatedServer = true;
+		ContentResolver::Get().SetHeadless(true);
+
+		config.windowTitle = NCINE_APP_NAME " (Dedicated Server)";
+		config.fullscreen = false;
+		config.withAudio = false;
+		config.withRendering = false;
+		config.withVSync = false;
+		config.frameLimit = (unsigned int)FrameTimer::FramesPerSecond;
+#	if defined(WITH_IMGUI)
+		config.withDebugOverlay = false;
+#	endif
+	}
+#endif
 }
 
 void GameEventHandler::OnInitialize()
@@ -248,17 +280,11 @@ void GameEventHandler::OnInitialize()
 	}, this);
 
 #	if defined(WITH_MULTIPLAYER)
-	// TODO: Multiplayer
-	/*if (PreferencesCache::InitialState == "/server"_s) {
+	if (_isDedicatedServer) {
 		thread.Join();
-
-		auto mainMenu = std::make_unique<Menu::MainMenu>(this, false);
-		mainMenu->SwitchToSection<Menu::LoadingSection>(_("Creating server..."));
-		SetStateHandler(std::move(mainMenu));
-
-		// TODO: Hardcoded port
-		CreateServer(MultiplayerDefaultPort);
-	} else*/ if (PreferencesCache::InitialState.hasPrefix("/connect:"_s)) {
+		StartDedicatedServer();
+		return;
+	} else if (PreferencesCache::InitialState.hasPrefix("/connect:"_s)) {
 		thread.Join();
 
 		String address; std::uint16_t port;
@@ -306,15 +332,9 @@ void GameEventHandler::OnInitialize()
 #	endif
 
 #	if defined(WITH_MULTIPLAYER)
-	if (PreferencesCache::InitialState == "/server"_s) {
-		LOGI("Starting server on port %u...", MultiplayerDefaultPort);
-
-		auto mainMenu = std::make_unique<Menu::MainMenu>(this, false);
-		mainMenu->SwitchToSection<Menu::LoadingSection>(_("Creating server..."));
-		SetStateHandler(std::move(mainMenu));
-
-		// TODO: Hardcoded port
-		CreateServer(MultiplayerDefaultPort);
+	if (_isDedicatedServer) {
+		StartDedicatedServer();
+		return;
 	} else if (PreferencesCache::InitialState.hasPrefix("/connect:"_s)) {
 		String address; std::uint16_t port;
 		if (TryParseAddressAndPort(PreferencesCache::InitialState.exceptPrefix(9), address, port)) {
@@ -344,6 +364,12 @@ void GameEventHandler::OnInitialize()
 
 void GameEventHandler::OnBeginFrame()
 {
+#if defined(WITH_MULTIPLAYER)
+	if (_isDedicatedServer) {
+		_tickStartTime = TimeStamp::now();
+	}
+#endif
+
 	if (!_pendingCallbacks.empty()) {
 		ZoneScopedNC("Pending callbacks", 0x888888);
 
@@ -360,6 +386,16 @@ void GameEventHandler::OnBeginFrame()
 void GameEventHandler::OnPostUpdate()
 {
 	_currentHandler->OnEndFrame();
+
+#if defined(WITH_MULTIPLAYER)
+	if (_networkManager != nullptr) {
+		// All packets enqueued during this frame are sent at once
+		_networkManager->Flush();
+	}
+	if (_isDedicatedServer) {
+		RecordTickTime(_tickStartTime.millisecondsSince());
+	}
+#endif
 }
 
 void GameEventHandler::OnResizeWindow(std::int32_t width, std::int32_t height)
@@ -693,6 +729,67 @@ bool GameEventHandler::CreateServer(LevelInitialization&& levelInit, std::uint16
 	return true;
 }
 
+void GameEventHandler::StartDedicatedServer()
+{
+	// Application shouldn't be suspended when the window is not focused
+	theApplication().SetAutoSuspension(false);
+
+	// Expected format is `/server[:<port>][:<episode>/<level>]`
+	std::uint32_t port = MultiplayerDefaultPort;
+	StringView levelPath = DedicatedServerDefaultLevel;
+	if (PreferencesCache::InitialState.hasPrefix("/server:"_s)) {
+		StringView params = PreferencesCache::InitialState.exceptPrefix(8);
+		auto portSep = params.find(':');
+		StringView portString = (portSep != nullptr ? params.prefix(portSep.begin()) : params);
+		if (!portString.empty() && portString.find('/') == nullptr) {
+			port = stou32(portString.data(), portString.size());
+			params = (portSep != nullptr ? params.suffix(portSep.end()) : StringView());
+		}
+		if (!params.empty()) {
+			levelPath = params;
+		}
+	}
+
+	auto levelParts = levelPath.partition('/');
+	if (port == 0 || port > UINT16_MAX || levelParts[0].empty() || levelParts[2].empty()) {
+		LOGE("Invalid parameters \"%s\" specified, expected \"/server[:<port>][:<episode>/<level>]\"", PreferencesCache::InitialState.data());
+		theApplication().Quit();
+		return;
+	}
+
+	LOGI("Starting dedicated server on port %u with level \"%s\"...", port, String::nullTerminatedView(levelPath).data());
+
+	// No local players are spawned on dedicated server
+	LevelInitialization levelInit(levelParts[0], levelParts[2], GameDifficulty::Multiplayer, PreferencesCache::EnableReforgedGameplay);
+	if (!CreateServer(std::move(levelInit), (std::uint16_t)port)) {
+		LOGE("Failed to create server on port %u", port);
+		theApplication().Quit();
+	}
+}
+
+void GameEventHandler::RecordTickTime(float milliseconds)
+{
+	_tickTimes.push_back(milliseconds);
+	if (_tickTimes.size() < TickTimeSampleCount) {
+		return;
+	}
+
+	auto percentile = [this](float fraction) {
+		auto nth = _tickTimes.begin() + (std::size_t)(fraction * (_tickTimes.size() - 1));
+		std::nth_element(_tickTimes.begin(), nth, _tickTimes.end());
+		return *nth;
+	};
+
+	float p50 = percentile(0.50f);
+	float p95 = percentile(0.95f);
+	float p99 = percentile(0.99f);
+	float max = *std::max_element(_tickTimes.begin(), _tickTimes.end());
+	LOGI("Tick time: p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms (budget %.2f ms)",
+		p50, p95, p99, max, FrameTimer::SecondsPerFrame * 1000.0f);
+
+	_tickTimes.clear();
+}
+
 ConnectionResult GameEventHandler::OnPeerConnected(const Peer& peer, std::uint32_t clientData)
 {
 	LOGI("Peer connected");
@@ -836,6 +933,13 @@ void GameEventHandler::OnBeforeInitialize()
 
 	auto& resolver = ContentResolver::Get();
 
+#if defined(WITH_MULTIPLAYER)
+	if (_isDedicatedServer) {
+		// Dedicated server has no window and no input devices, and shaders are not needed without rendering
+		return;
+	}
+#endif
+
 #if defined(DEATH_TARGET_ANDROID)
 	theApplication().SetAutoSuspension(true);
 
@@ -1014,6 +1118,7 @@ RecreateCache:
 
 	// Create .pak file
 	{
+		TimeStamp pakStartTime = TimeStamp::now();
 		std::int32_t t = 1;
 		std::unique_ptr<PakWriter> pakWriter = std::make_unique<PakWriter>(fs::CombinePath(resolver.GetCachePath(), "Source.pak"_s));
 		while (!pakWriter->IsValid()) {
@@ -1040,6 +1145,9 @@ RecreateCache:
 		if (data.Open(fs::CombinePath(resolver.GetSourcePath(), "Data.j2d"_s), false)) {
 			data.Convert(*pakWriter, version);
 		}
+
+		pakWriter->Finalize();
+		LOGI("Source.pak was created in %.1f ms", pakStartTime.millisecondsSince());
 	}
 
 	RefreshCacheLevels();
@@ -12,12 +12,12 @@ namespace Death { namespace IO {
 	AAssetManager* AndroidAssetStream::_assetManager = nullptr;
 	const char* AndroidAssetStream::_internalDataPath = nullptr;
 
-	AndroidAssetStream::AndroidAssetStream(const Containers::StringView path, FileAccess mode)
-		: AndroidAssetStream(Containers::String{path}, mode)
+	AndroidAssetStream::AndroidAssetStream(const Containers::StringView path, FileAccess mode, std::int32_t bufferSize)
+		: AndroidAssetStream(Containers::String{path}, mode, bufferSize)
 	{
 	}
 
-	AndroidAssetStream::AndroidAssetStream(Containers::String&& path, FileAccess mode)
+	AndroidAssetStream::AndroidAssetStream(Containers::String&& path, FileAccess mode, std::int32_t bufferSize)
 		: _path(std::move(path)), _size(Stream::Invalid),
 #if defined(DEATH_USE_FILE_DESCRIPTORS)
 			_fileDescriptor(-1), _startOffset(0L)
@@ -25,7 +25,7 @@ namespace Death { namespace IO {
 			_asset(nullptr)
 #endif
 	{
-		Open(mode);
+		Open(mode, bufferSize);
 	}
 
 	AndroidAssetStream::~AndroidAssetStream()
@@ -44,18 +44,56 @@ namespace Death { namespace IO {
 			} else {
 				LOGI("File \"%s\" closed", _path.data());
 				_fileDescriptor = -1;
+				InitializeReadBuffer(0, 0);
 			}
 		}
 #else
 		if (_asset != nullptr) {
 			AAsset_close(_asset);
 			_asset = nullptr;
+			InitializeReadBuffer(0, 0);
 			LOGI("File \"%s\" closed", _path.data());
 		}
 #endif
 	}
 
 	std::int64_t AndroidAssetStream::Seek(std::int64_t offset, SeekOrigin origin)
+	{
+		if (_readBuffer == nullptr) {
+			return SeekDirect(offset, origin);
+		}
+
+		if (TrySeekInReadBuffer(offset, origin, _size)) {
+			return offset;
+		}
+
+		std::int64_t newPos = SeekDirect(offset, origin);
+		if (newPos >= 0) {
+			DiscardReadBuffer(newPos);
+		}
+		return newPos;
+	}
+
+	std::int64_t AndroidAssetStream::GetPosition() const
+	{
+		if (_readBuffer != nullptr) {
+			return GetReadBufferPosition();
+		}
+		return GetPositionDirect();
+	}
+
+	std::int32_t AndroidAssetStream::Read(void* buffer, std::int32_t bytes)
+	{
+		DEATH_ASSERT(buffer != nullptr, 0, "buffer is nullptr");
+
+		if (bytes <= 0) {
+			return 0;
+		}
+
+		return (_readBuffer != nullptr ? ReadBuffered(buffer, bytes) : ReadDirect(buffer, bytes));
+	}
+
+	std::int64_t AndroidAssetStream::SeekDirect(std::int64_t offset, SeekOrigin origin)
 	{
 		std::int64_t newPos = Stream::Invalid;
 #if defined(DEATH_USE_FILE_DESCRIPTORS)
@@ -83,7 +121,7 @@ namespace Death { namespace IO {
 		return newPos;
 	}
 
-	std::int64_t AndroidAssetStream::GetPosition() const
+	std::int64_t AndroidAssetStream::GetPositionDirect() const
 	{
 		std::int64_t pos = Stream::Invalid;
 #if defined(DEATH_USE_FILE_DESCRIPTORS)
@@ -98,14 +136,8 @@ namespace Death { namespace IO {
 		return pos;
 	}
 
-	std::int32_t AndroidAssetStream::Read(void* buffer, std::int32_t bytes)
+	std::int32_t AndroidAssetStream::ReadDirect(void* buffer, std::int32_t bytes)
 	{
-		DEATH_ASSERT(buffer != nullptr, 0, "buffer is nullptr");
-
-		if (bytes <= 0) {
-			return 0;
-		}
-
 		std::int32_t bytesRead = 0;
 #if defined(DEATH_USE_FILE_DESCRIPTORS)
 		if (_fileDescriptor >= 0) {
@@ -259,7 +291,7 @@ namespace Death { namespace IO {
 		return AAssetDir_getNextFileName(assetDir);
 	}
 
-	void AndroidAssetStream::Open(FileAccess mode)
+	void AndroidAssetStream::Open(FileAccess mode, std::int32_t bufferSize)
 	{
 		FileAccess maskedMode = mode & ~FileAccess::Exclusive;
 		if (maskedMode != FileAccess::Read) {
@@ -304,6 +336,10 @@ namespace Death { namespace IO {
 		// Calculating file size
 		_size = AAsset_getLength64(_asset);
 #endif
+
+		if (bufferSize > 0) {
+			InitializeReadBuffer(bufferSize, 0);
+		}
 	}
 
 }}
@@ -25,8 +25,8 @@ namespace Death { namespace IO {
 	public:
 		static constexpr Containers::StringView Prefix = "asset:"_s;
 
-		AndroidAssetStream(const Containers::StringView path, FileAccess mode);
-		AndroidAssetStream(Containers::String&& path, FileAccess mode);
+		AndroidAssetStream(const Containers::StringView path, FileAccess mode, std::int32_t bufferSize = 0);
+		AndroidAssetStream(Containers::String&& path, FileAccess mode, std::int32_t bufferSize = 0);
 		~AndroidAssetStream() override;
 
 		AndroidAssetStream(const AndroidAssetStream&) = delete;
@@ -76,6 +76,9 @@ namespace Death { namespace IO {
 		static void RewindDirectory(AAssetDir* assetDir);
 		static const char* GetNextFileName(AAssetDir* assetDir);
 
+	protected:
+		std::int32_t ReadDirect(void* buffer, std::int32_t bytes) override;
+
 	private:
 		static AAssetManager* _assetManager;
 		static const char* _internalDataPath;
@@ -89,7 +92,9 @@ namespace Death { namespace IO {
 		AAsset* _asset;
 #endif
 
-		void Open(FileAccess mode);
+		void Open(FileAccess mode, std::int32_t bufferSize);
+		std::int64_t SeekDirect(std::int64_t offset, SeekOrigin origin);
+		std::int64_t GetPositionDirect() const;
 	};
 }}
 
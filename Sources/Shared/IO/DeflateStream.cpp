@@ -158,6 +158,25 @@ namespace Death { namespace IO {
 		_strm.total_out = 0;
 	}
 
+	void DeflateStream::Open(const void* inputBuffer, std::int32_t inputSize, bool rawInflate)
+	{
+		Dispose();
+
+		// Whole input is available at once, so it doesn't have to be copied to the internal buffer
+		_inputStream = nullptr;
+		_inputSize = 0;
+		_state = State::Created;
+		_rawInflate = rawInflate;
+		_size = Stream::NotSeekable;
+
+		_strm.zalloc = Z_NULL;
+		_strm.zfree = Z_NULL;
+		_strm.opaque = Z_NULL;
+		_strm.next_in = static_cast<unsigned char*>(const_cast<void*>(inputBuffer));
+		_strm.avail_in = static_cast<std::uint32_t>(inputSize);
+		_strm.total_out = 0;
+	}
+
 	void DeflateStream::Dispose()
 	{
 		CeaseReading();
@@ -192,6 +211,11 @@ namespace Death { namespace IO {
 		}
 
 		if (_strm.avail_in == 0) {
+			if (_inputStream == nullptr) {
+				// Input from memory is already depleted
+				return 0;
+			}
+
 			std::int32_t bytesRead = _inputSize;
 			if (bytesRead < 0 || bytesRead > sizeof(_buffer)) {
 				bytesRead = sizeof(_buffer);
@@ -233,7 +257,9 @@ namespace Death { namespace IO {
 			return true;
 		}
 
-		_inputStream->Seek(_inputSize >= 0 ? _inputSize : -static_cast<std::int32_t>(_strm.avail_in), SeekOrigin::Current);
+		if (_inputStream != nullptr) {
+			_inputStream->Seek(_inputSize >= 0 ? _inputSize : -static_cast<std::int32_t>(_strm.avail_in), SeekOrigin::Current);
+		}
 
 		std::int32_t error = inflateEnd((z_stream*)&_strm);
 		if (error != Z_OK) {
@@ -35,6 +35,8 @@ namespace Death { namespace IO {
 		DeflateStream& operator=(DeflateStream&& other) noexcept;
 
 		void Open(Stream& inputStream, std::int32_t inputSize = -1, bool rawInflate = true);
+		/** @brief Opens compressed data directly from memory, the buffer must stay valid while the stream is used */
+		void Open(const void* inputBuffer, std::int32_t inputSize, bool rawInflate = true);
 
 		void Dispose() override;
 		std::int64_t Seek(std::int64_t offset, SeekOrigin origin) override;
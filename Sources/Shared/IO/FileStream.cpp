@@ -41,12 +41,12 @@ namespace Death { namespace IO {
 	}
 #endif
 
-	FileStream::FileStream(const Containers::StringView path, FileAccess mode)
-		: FileStream(Containers::String{path}, mode)
+	FileStream::FileStream(const Containers::StringView path, FileAccess mode, std::int32_t bufferSize)
+		: FileStream(Containers::String{path}, mode, bufferSize)
 	{
 	}
 
-	FileStream::FileStream(Containers::String&& path, FileAccess mode)
+	FileStream::FileStream(Containers::String&& path, FileAccess mode, std::int32_t bufferSize)
 		: _path(std::move(path)), _size(Stream::Invalid),
 #if defined(DEATH_USE_FILE_DESCRIPTORS)
 			_fileDescriptor(-1)
@@ -54,7 +54,7 @@ namespace Death { namespace IO {
 			_handle(nullptr)
 #endif
 	{
-		Open(mode);
+		Open(mode, bufferSize);
 	}
 
 	FileStream::~FileStream()
@@ -72,6 +72,7 @@ namespace Death { namespace IO {
 			} else {
 				LOGI("File \"%s\" closed", _path.data());
 				_fileDescriptor = -1;
+				InitializeReadBuffer(0, 0);
 			}
 		}
 #else
@@ -82,12 +83,49 @@ namespace Death { namespace IO {
 			} else {
 				LOGI("File \"%s\" closed", _path.data());
 				_handle = nullptr;
+				InitializeReadBuffer(0, 0);
 			}
 		}
 #endif
 	}
 
 	std::int64_t FileStream::Seek(std::int64_t offset, SeekOrigin origin)
+	{
+		if (_readBuffer == nullptr) {
+			return SeekDirect(offset, origin);
+		}
+
+		if (TrySeekInReadBuffer(offset, origin, _size)) {
+			return offset;
+		}
+
+		std::int64_t newPos = SeekDirect(offset, origin);
+		if (newPos >= 0) {
+			DiscardReadBuffer(newPos);
+		}
+		return newPos;
+	}
+
+	std::int64_t FileStream::GetPosition() const
+	{
+		if (_readBuffer != nullptr) {
+			return GetReadBufferPosition();
+		}
+		return GetPositionDirect();
+	}
+
+	std::int32_t FileStream::Read(void* buffer, std::int32_t bytes)
+	{
+		DEATH_ASSERT(buffer != nullptr, 0, "buffer is nullptr");
+
+		if (bytes <= 0) {
+			return 0;
+		}
+
+		return (_readBuffer != nullptr ? ReadBuffered(buffer, bytes) : ReadDirect(buffer, bytes));
+	}
+
+	std::int64_t FileStream::SeekDirect(std::int64_t offset, SeekOrigin origin)
 	{
 		std::int64_t newPos = Stream::Invalid;
 #if defined(DEATH_USE_FILE_DESCRIPTORS)
@@ -120,7 +158,7 @@ namespace Death { namespace IO {
 		return newPos;
 	}
 
-	std::int64_t FileStream::GetPosition() const
+	std::int64_t FileStream::GetPositionDirect() const
 	{
 		std::int64_t pos = Stream::Invalid;
 #if defined(DEATH_USE_FILE_DESCRIPTORS)
@@ -143,14 +181,8 @@ namespace Death { namespace IO {
 		return pos;
 	}
 
-	std::int32_t FileStream::Read(void* buffer, std::int32_t bytes)
+	std::int32_t FileStream::ReadDirect(void* buffer, std::int32_t bytes)
 	{
-		DEATH_ASSERT(buffer != nullptr, 0, "buffer is nullptr");
-
-		if (bytes <= 0) {
-			return 0;
-		}
-
 		std::int32_t bytesRead = 0;
 #if defined(DEATH_USE_FILE_DESCRIPTORS)
 		if (_fileDescriptor >= 0) {
@@ -233,7 +265,7 @@ namespace Death { namespace IO {
 		return _path;
 	}
 
-	void FileStream::Open(FileAccess mode)
+	void FileStream::Open(FileAccess mode, std::int32_t bufferSize)
 	{
 #if defined(DEATH_USE_FILE_DESCRIPTORS)
 		std::int32_t openFlag;
@@ -349,6 +381,11 @@ namespace Death { namespace IO {
 		}
 #	endif
 
+		if (bufferSize > 0 && (mode & ~FileAccess::Exclusive) == FileAccess::Read) {
+			// Reads are buffered by the stream itself, so the internal buffer of the C runtime would only add another copy
+			::setvbuf(_handle, nullptr, _IONBF, 0);
+		}
+
 		switch (mode & ~FileAccess::Exclusive) {
 			default: LOGI("File \"%s\" opened", _path.data()); break;
 			case FileAccess::Write: LOGI("File \"%s\" opened for write", _path.data()); break;
@@ -372,6 +409,10 @@ namespace Death { namespace IO {
 		::fseeko(_handle, 0, SEEK_SET);
 #	endif
 #endif
+
+		if (bufferSize > 0 && (mode & ~FileAccess::Exclusive) == FileAccess::Read) {
+			InitializeReadBuffer(bufferSize, 0);
+		}
 	}
 
 }}
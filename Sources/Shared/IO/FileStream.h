@@ -9,12 +9,15 @@ namespace Death { namespace IO {
 
 	/**
 		@brief Streaming from/to a file on a local filesystem
+
+		If @p bufferSize is specified and the file is opened only for reading, the stream reads ahead
+		in blocks of the given size, so many small reads don't result in many system calls.
 	*/
 	class FileStream : public Stream
 	{
 	public:
-		FileStream(const Containers::StringView path, FileAccess mode);
-		FileStream(Containers::String&& path, FileAccess mode);
+		FileStream(const Containers::StringView path, FileAccess mode, std::int32_t bufferSize = 0);
+		FileStream(Containers::String&& path, FileAccess mode, std::int32_t bufferSize = 0);
 		~FileStream() override;
 
 		FileStream(const FileStream&) = delete;
@@ -44,6 +47,9 @@ namespace Death { namespace IO {
 		}
 #endif
 
+	protected:
+		std::int32_t ReadDirect(void* buffer, std::int32_t bytes) override;
+
 	private:
 		Containers::String _path;
 		std::int64_t _size;
@@ -53,6 +59,8 @@ namespace Death { namespace IO {
 		FILE* _handle;
 #endif
 
-		void Open(FileAccess mode);
+		void Open(FileAccess mode, std::int32_t bufferSize);
+		std::int64_t SeekDirect(std::int64_t offset, SeekOrigin origin);
+		std::int64_t GetPositionDirect() const;
 	};
 }}
\ No newline at end of file
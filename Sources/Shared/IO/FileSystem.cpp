@@ -2379,15 +2379,15 @@ namespace Death { namespace IO {
 	}
 #endif
 
-	std::unique_ptr<Stream> FileSystem::Open(const String& path, FileAccess mode)
+	std::unique_ptr<Stream> FileSystem::Open(const String& path, FileAccess mode, std::int32_t bufferSize)
 	{
 #if defined(DEATH_TARGET_ANDROID)
 		StringView assetName = AndroidAssetStream::TryGetAssetPath(String::nullTerminatedView(path).data());
 		if (!assetName.empty()) {
-			return std::make_unique<AndroidAssetStream>(assetName, mode);
+			return std::make_unique<AndroidAssetStream>(assetName, mode, bufferSize);
 		}
 #endif
-		return std::make_unique<FileStream>(path, mode);
+		return std::make_unique<FileStream>(path, mode, bufferSize);
 	}
 
 #if defined(DEATH_TARGET_UNIX) || (defined(DEATH_TARGET_WINDOWS) && !defined(DEATH_TARGET_WINDOWS_RT))
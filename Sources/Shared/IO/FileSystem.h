@@ -261,7 +261,11 @@ namespace Death { namespace IO {
 #endif
 
 		/** @brief Opens file stream with specified access mode */
-		static std::unique_ptr<Stream> Open(const Containers::String& path, FileAccess mode);
+		/*!
+			Files opened only for reading use a read-ahead buffer of @p bufferSize bytes, specify zero
+			to read directly from the file instead.
+		*/
+		static std::unique_ptr<Stream> Open(const Containers::String& path, FileAccess mode, std::int32_t bufferSize = Stream::DefaultReadBufferSize);
 
 #if defined(DEATH_TARGET_UNIX) || (defined(DEATH_TARGET_WINDOWS) && !defined(DEATH_TARGET_WINDOWS_RT))
 		/**
@@ -1,12 +1,14 @@
 #include "PakFile.h"
 #include "DeflateStream.h"
 #include "FileSystem.h"
+#include "MemoryStream.h"
 #include "../Containers/GrowableArray.h"
 #include "../Containers/StringConcatenable.h"
 
 #include <algorithm>
 
 using namespace Death::Containers;
+using namespace Death::Containers::Literals;
 
 namespace Death { namespace IO {
 //###==##====#=====--==~--~=~- --- -- -  -  -   -
@@ -14,7 +16,7 @@ namespace Death { namespace IO {
 	class BoundedStream : public Stream
 	{
 	public:
-		BoundedStream(const String& path, std::uint64_t offset, std::uint32_t size);
+		BoundedStream(const String& path, std::uint64_t offset, std::uint32_t size, std::int32_t bufferSize = 0);
 
 		BoundedStream(const BoundedStream&) = delete;
 		BoundedStream& operator=(const BoundedStream&) = delete;
@@ -28,6 +30,9 @@ namespace Death { namespace IO {
 		bool IsValid() override;
 		std::int64_t GetSize() const override;
 
+	protected:
+		std::int32_t ReadDirect(void* buffer, std::int32_t bytes) override;
+
 	private:
 		FileStream _underlyingStream;
 		std::uint64_t _offset;
@@ -35,19 +40,28 @@ namespace Death { namespace IO {
 		std::int64_t _pos;
 	};
 
-	BoundedStream::BoundedStream(const String& path, std::uint64_t offset, std::uint32_t size)
+	BoundedStream::BoundedStream(const String& path, std::uint64_t offset, std::uint32_t size, std::int32_t bufferSize)
 		: _underlyingStream(path, FileAccess::Read), _offset(offset), _size(size), _pos(0)
 	{
 		_underlyingStream.Seek(static_cast<std::int64_t>(offset), SeekOrigin::Begin);
+		if (bufferSize > 0 && _underlyingStream.IsValid()) {
+			// Read-ahead never crosses the end of the entry, because all reads are bounded by ReadDirect()
+			InitializeReadBuffer(bufferSize, 0);
+		}
 	}
 
 	void BoundedStream::Dispose()
 	{
 		_underlyingStream.Dispose();
+		InitializeReadBuffer(0, 0);
 	}
 
 	std::int64_t BoundedStream::Seek(std::int64_t offset, SeekOrigin origin)
 	{
+		if (_readBuffer != nullptr && TrySeekInReadBuffer(offset, origin, static_cast<std::int64_t>(_size))) {
+			return offset;
+		}
+
 		std::int64_t newPos;
 		switch (origin) {
 			case SeekOrigin::Begin: newPos = _offset + offset; break;
@@ -63,6 +77,9 @@ namespace Death { namespace IO {
 			if (newPos >= static_cast<std::int64_t>(_offset)) {
 				newPos -= _offset;
 				_pos = newPos;
+				if (_readBuffer != nullptr) {
+					DiscardReadBuffer(_pos);
+				}
 			}
 		}
 		return static_cast<std::int64_t>(newPos);
@@ -70,7 +87,7 @@ namespace Death { namespace IO {
 
 	std::int64_t BoundedStream::GetPosition() const
 	{
-		return _pos;
+		return (_readBuffer != nullptr ? GetReadBufferPosition() : _pos);
 	}
 
 	std::int32_t BoundedStream::Read(void* buffer, std::int32_t bytes)
@@ -81,6 +98,11 @@ namespace Death { namespace IO {
 			return 0;
 		}
 
+		return (_readBuffer != nullptr ? ReadBuffered(buffer, bytes) : ReadDirect(buffer, bytes));
+	}
+
+	std::int32_t BoundedStream::ReadDirect(void* buffer, std::int32_t bytes)
+	{
 		if (bytes > _size - _pos) {
 			bytes = static_cast<std::int32_t>(_size - _pos);
 		}
@@ -187,11 +209,116 @@ namespace Death { namespace IO {
 		return _uncompressedSize;
 	}
 
+#endif
+
+#if defined(DEATH_TARGET_UNIX) || (defined(DEATH_TARGET_WINDOWS) && !defined(DEATH_TARGET_WINDOWS_RT))
+
+	class MappedStream : public MemoryStream
+	{
+	public:
+		MappedStream(std::shared_ptr<Array<char, FileSystem::MapDeleter>> mappedFile, std::uint64_t offset, std::uint32_t size);
+
+	private:
+		std::shared_ptr<Array<char, FileSystem::MapDeleter>> _mappedFile;
+	};
+
+	MappedStream::MappedStream(std::shared_ptr<Array<char, FileSystem::MapDeleter>> mappedFile, std::uint64_t offset, std::uint32_t size)
+		: MemoryStream(reinterpret_cast<const std::uint8_t*>(mappedFile->data() + offset), size), _mappedFile(std::move(mappedFile))
+	{
+	}
+
+#	if defined(WITH_ZLIB)
+
+	class MappedZlibCompressedStream : public Stream
+	{
+	public:
+		MappedZlibCompressedStream(std::shared_ptr<Array<char, FileSystem::MapDeleter>> mappedFile, std::uint64_t offset, std::uint32_t uncompressedSize, std::uint32_t compressedSize);
+
+		MappedZlibCompressedStream(const MappedZlibCompressedStream&) = delete;
+		MappedZlibCompressedStream& operator=(const MappedZlibCompressedStream&) = delete;
+
+		void Dispose() override;
+		std::int64_t Seek(std::int64_t offset, SeekOrigin origin) override;
+		std::int64_t GetPosition() const override;
+		std::int32_t Read(void* buffer, std::int32_t bytes) override;
+		std::int32_t Write(const void* buffer, std::int32_t bytes) override;
+		bool Flush() override;
+		bool IsValid() override;
+		std::int64_t GetSize() const override;
+
+	private:
+		std::shared_ptr<Array<char, FileSystem::MapDeleter>> _mappedFile;
+		DeflateStream _deflateStream;
+		std::int64_t _uncompressedSize;
+	};
+
+	MappedZlibCompressedStream::MappedZlibCompressedStream(std::shared_ptr<Array<char, FileSystem::MapDeleter>> mappedFile, std::uint64_t offset, std::uint32_t uncompressedSize, std::uint32_t compressedSize)
+		: _mappedFile(std::move(mappedFile)), _uncompressedSize(uncompressedSize)
+	{
+		// Data are inflated directly from the mapped memory
+		_deflateStream.Open(_mappedFile->data() + offset, static_cast<std::int32_t>(compressedSize));
+	}
+
+	void MappedZlibCompressedStream::Dispose()
+	{
+		_deflateStream.Dispose();
+		_mappedFile = nullptr;
+	}
+
+	std::int64_t MappedZlibCompressedStream::Seek(std::int64_t offset, SeekOrigin origin)
+	{
+		return _deflateStream.Seek(offset, origin);
+	}
+
+	std::int64_t MappedZlibCompressedStream::GetPosition() const
+	{
+		return _deflateStream.GetPosition();
+	}
+
+	std::int32_t MappedZlibCompressedStream::Read(void* buffer, std::int32_t bytes)
+	{
+		return _deflateStream.Read(buffer, bytes);
+	}
+
+	std::int32_t MappedZlibCompressedStream::Write(const void* buffer, std::int32_t bytes)
+	{
+		// Not supported
+		return Stream::Invalid;
+	}
+
+	bool MappedZlibCompressedStream::Flush()
+	{
+		// Not supported
+		return true;
+	}
+
+	bool MappedZlibCompressedStream::IsValid()
+	{
+		return _mappedFile != nullptr && _deflateStream.IsValid();
+	}
+
+	std::int64_t MappedZlibCompressedStream::GetSize() const
+	{
+		return _uncompressedSize;
+	}
+
+#	endif
 #endif
 
 	PakFile::PakFile(const StringView path)
 	{
-		std::unique_ptr<Stream> s = std::make_unique<FileStream>(path, FileAccess::Read);
+		std::unique_ptr<Stream> s;
+#if defined(DEATH_TARGET_UNIX) || (defined(DEATH_TARGET_WINDOWS) && !defined(DEATH_TARGET_WINDOWS_RT))
+		// Map the whole file once, so opened files don't need any additional file handles or syscalls
+		auto mappedFile = FileSystem::OpenAsMemoryMapped(path, FileAccess::Read);
+		if (mappedFile && mappedFile->data() != nullptr) {
+			_mappedFile = std::make_shared<Array<char, FileSystem::MapDeleter>>(std::move(*mappedFile));
+			s = std::make_unique<MemoryStream>(reinterpret_cast<const std::uint8_t*>(_mappedFile->data()), static_cast<std::int64_t>(_mappedFile->size()));
+		} else
+#endif
+		{
+			s = std::make_unique<FileStream>(path, FileAccess::Read);
+		}
 		DEATH_ASSERT(s->GetSize() > 24, , "Invalid .pak file");
 
 		// Header size is 18 bytes
@@ -306,8 +433,23 @@ namespace Death { namespace IO {
 			return nullptr;
 		}
 
+#if defined(DEATH_TARGET_UNIX) || (defined(DEATH_TARGET_WINDOWS) && !defined(DEATH_TARGET_WINDOWS_RT))
+		if (_mappedFile != nullptr) {
+			std::uint32_t storedSize = ((foundItem->Flags & ItemFlags::ZlibCompressed) == ItemFlags::ZlibCompressed ? foundItem->Size : foundItem->UncompressedSize);
+			if (foundItem->Offset + storedSize > _mappedFile->size()) {
+				LOGE("File \"%s\" is out of bounds of .pak file", String::nullTerminatedView(path).data());
+				return nullptr;
+			}
+		}
+#endif
+
 		if ((foundItem->Flags & ItemFlags::ZlibCompressed) == ItemFlags::ZlibCompressed) {
 #if defined(WITH_ZLIB)
+#	if defined(DEATH_TARGET_UNIX) || (defined(DEATH_TARGET_WINDOWS) && !defined(DEATH_TARGET_WINDOWS_RT))
+			if (_mappedFile != nullptr) {
+				return std::make_unique<MappedZlibCompressedStream>(_mappedFile, foundItem->Offset, foundItem->UncompressedSize, foundItem->Size);
+			}
+#	endif
 			return std::make_unique<ZlibCompressedBoundedStream>(_path, foundItem->Offset, foundItem->UncompressedSize, foundItem->Size);
 #else
 			LOGE("File \"%s\" was compressed using an unsupported compression method", String::nullTerminatedView(path).data());
@@ -315,7 +457,13 @@ namespace Death { namespace IO {
 #endif
 		}
 
-		return std::make_unique<BoundedStream>(_path, foundItem->Offset, foundItem->UncompressedSize);
+#if defined(DEATH_TARGET_UNIX) || (defined(DEATH_TARGET_WINDOWS) && !defined(DEATH_TARGET_WINDOWS_RT))
+		if (_mappedFile != nullptr) {
+			// Uncompressed files are served directly from the mapped memory
+			return std::make_unique<MappedStream>(_mappedFile, foundItem->Offset, foundItem->UncompressedSize);
+		}
+#endif
+		return std::make_unique<BoundedStream>(_path, foundItem->Offset, foundItem->UncompressedSize, Stream::DefaultReadBufferSize);
 	}
 
 	PakFile::Item* PakFile::FindItem(StringView path)
@@ -542,58 +690,120 @@ namespace Death { namespace IO {
 		return _outputStream->IsValid();
 	}
 
-	bool PakWriter::AddFile(Stream& stream, StringView path, bool compress)
+	bool PakWriter::AddFile(Stream& stream, StringView path, PakPreferredCompression compression)
 	{
 		DEATH_ASSERT(_outputStream->IsValid(), false, "Invalid output stream specified");
-		DEATH_ASSERT(!path.empty() && path[path.size() - 1] != '/' && path[path.size() - 1] != '\\', false, "\"%s\" is not valid file path", String::nullTerminatedView(path).data());
 
-		PakFile::Item* parentItem = FindOrCreateParentItem(path);
-		Array<PakFile::Item>* items;
-		if (parentItem != nullptr) {
-			items = &parentItem->ChildItems;
-		} else {
-			items = &_rootItems;
+#if defined(WITH_ZLIB)
+		if (compression != PakPreferredCompression::None) {
+			// Compressed size must be known in advance to decide whether to store the file compressed or not
+			PreparedFile file;
+			return PrepareFile(file, stream, compression) && AddPreparedFile(file, path);
 		}
+#endif
 
-		for (PakFile::Item& item : *items) {
-			if (item.Name == path) {
-				// File already exists in the .pak file
-				return false;
-			}
+		Array<PakFile::Item>* items = FindItemsForNewFile(path);
+		if (items == nullptr) {
+			return false;
 		}
 
-		PakFile::ItemFlags flags = PakFile::ItemFlags::None;
 		std::int64_t offset = _outputStream->GetPosition();
-		std::int64_t uncompressedSize, size;
-
-#if defined(WITH_ZLIB)
-		if (compress) {
-			DeflateWriter dw(*_outputStream);
-			uncompressedSize = stream.CopyTo(dw);
-			dw.Dispose();
-			size = _outputStream->GetPosition() - offset;
-			flags |= PakFile::ItemFlags::ZlibCompressed;
-		} else
-#endif
-		{
-			uncompressedSize = stream.CopyTo(*_outputStream);
-			size = 0;
-		}
+		std::int64_t uncompressedSize = stream.CopyTo(*_outputStream);
 
 		DEATH_ASSERT(uncompressedSize > 0, false, "Failed to copy stream to .pak file");
 		// NOTE: Files inside .pak are limited to 4GBs only for now
-		DEATH_ASSERT(uncompressedSize < UINT32_MAX && size < UINT32_MAX, false, "File size in .pak file exceeded the allowed range");
+		DEATH_ASSERT(uncompressedSize < UINT32_MAX, false, "File size in .pak file exceeded the allowed range");
 
 		PakFile::Item* newItem = &arrayAppend(*items, PakFile::Item());
 		newItem->Name = path;
-		newItem->Flags = flags;
+		newItem->Flags = PakFile::ItemFlags::None;
 		newItem->Offset = offset;
 		newItem->UncompressedSize = static_cast<std::uint32_t>(uncompressedSize);
-		newItem->Size = static_cast<std::uint32_t>(size);
+		newItem->Size = 0;
 
 		return true;
 	}
 
+	bool PakWriter::AddPreparedFile(const PreparedFile& file, StringView path)
+	{
+		DEATH_ASSERT(_outputStream->IsValid(), false, "Invalid output stream specified");
+		DEATH_ASSERT(file.UncompressedSize > 0, false, "File \"%s\" wasn't prepared successfully", String::nullTerminatedView(path).data());
+
+		Array<PakFile::Item>* items = FindItemsForNewFile(path);
+		if (items == nullptr) {
+			return false;
+		}
+
+		std::int64_t offset = _outputStream->GetPosition();
+		std::int32_t bytesWritten = _outputStream->Write(file.Data.data(), static_cast<std::int32_t>(file.Size));
+		DEATH_ASSERT(bytesWritten == static_cast<std::int32_t>(file.Size), false, "Failed to copy stream to .pak file");
+
+		PakFile::Item* newItem = &arrayAppend(*items, PakFile::Item());
+		newItem->Name = path;
+		newItem->Flags = (file.IsCompressed ? PakFile::ItemFlags::ZlibCompressed : PakFile::ItemFlags::None);
+		newItem->Offset = offset;
+		newItem->UncompressedSize = file.UncompressedSize;
+		newItem->Size = (file.IsCompressed ? file.Size : 0);
+
+		return true;
+	}
+
+	bool PakWriter::PrepareFile(PreparedFile& file, Stream& stream, PakPreferredCompression compression)
+	{
+		Array<std::uint8_t> data;
+		std::int64_t uncompressedSize = 0;
+
+		std::int64_t size = stream.GetSize();
+		std::int64_t pos = stream.GetPosition();
+		if (size >= 0 && pos >= 0 && size - pos < INT32_MAX) {
+			// Read the rest of the stream directly if its size is known
+			data = Array<std::uint8_t>(NoInit, static_cast<std::size_t>(size - pos));
+			while (uncompressedSize < static_cast<std::int64_t>(data.size())) {
+				std::int32_t bytesRead = stream.Read(&data[uncompressedSize], static_cast<std::int32_t>(data.size() - uncompressedSize));
+				if (bytesRead <= 0) {
+					break;
+				}
+				uncompressedSize += bytesRead;
+			}
+		} else {
+			MemoryStream ms(16384);
+			uncompressedSize = stream.CopyTo(ms);
+			if (uncompressedSize > 0 && uncompressedSize < INT32_MAX) {
+				data = Array<std::uint8_t>(NoInit, static_cast<std::size_t>(uncompressedSize));
+				std::memcpy(data.data(), ms.GetBuffer(), static_cast<std::size_t>(uncompressedSize));
+			}
+		}
+
+		DEATH_ASSERT(uncompressedSize > 0, false, "Failed to copy stream to .pak file");
+		// NOTE: Prepared files are written at once, so they are limited to 2GBs
+		DEATH_ASSERT(uncompressedSize < INT32_MAX, false, "File size in .pak file exceeded the allowed range");
+
+		file.UncompressedSize = static_cast<std::uint32_t>(uncompressedSize);
+		file.Size = static_cast<std::uint32_t>(uncompressedSize);
+		file.IsCompressed = false;
+
+#if defined(WITH_ZLIB)
+		if (compression != PakPreferredCompression::None) {
+			MemoryStream ms(DeflateWriter::GetMaxDeflatedSize(uncompressedSize));
+			DeflateWriter dw(ms, compression == PakPreferredCompression::DeflateFast ? 1 : 9);
+			dw.Write(data.data(), static_cast<std::int32_t>(uncompressedSize));
+			dw.Dispose();
+
+			// Keep the file uncompressed if the compression saves less than 1/16 of the size, it's not worth the decompression
+			std::int64_t compressedSize = ms.GetSize();
+			if (compressedSize > 0 && compressedSize < uncompressedSize - uncompressedSize / 16) {
+				data = Array<std::uint8_t>(NoInit, static_cast<std::size_t>(compressedSize));
+				std::memcpy(data.data(), ms.GetBuffer(), static_cast<std::size_t>(compressedSize));
+				file.Size = static_cast<std::uint32_t>(compressedSize);
+				file.IsCompressed = true;
+			}
+		}
+#endif
+
+		file.Data = std::move(data);
+		return true;
+	}
+
 	void PakWriter::Finalize()
 	{
 		if (_finalized) {
@@ -618,13 +828,30 @@ namespace Death { namespace IO {
 			return;
 		}
 
+		Array<String> directoryPaths;
+		for (PakFile::Item* item : queuedDirectories) {
+			arrayAppend(directoryPaths, item->Name);
+		}
+
 		for (std::int32_t i = 0; i < queuedDirectories.size(); i++) {
 			PakFile::Item& item = *queuedDirectories[i];
+			std::uint32_t fileCount = 0;
+			std::uint64_t uncompressedSize = 0, storedSize = 0;
 			for (PakFile::Item& child : item.ChildItems) {
 				if ((child.Flags & PakFile::ItemFlags::Directory) == PakFile::ItemFlags::Directory) {
 					arrayAppend(queuedDirectories, &child);
+					arrayAppend(directoryPaths, directoryPaths[i] + "/"_s + child.Name);
+				} else {
+					fileCount++;
+					uncompressedSize += child.UncompressedSize;
+					storedSize += ((child.Flags & PakFile::ItemFlags::ZlibCompressed) == PakFile::ItemFlags::ZlibCompressed ? child.Size : child.UncompressedSize);
 				}
 			}
+
+			if (fileCount > 0) {
+				LOGI("Directory \"%s\" contains %u files with %llu bytes stored as %llu bytes (%.1f%%)", directoryPaths[i].data(),
+					fileCount, uncompressedSize, storedSize, storedSize * 100.0 / uncompressedSize);
+			}
 		}
 
 		std::size_t i = queuedDirectories.size() - 1;
@@ -671,6 +898,28 @@ namespace Death { namespace IO {
 		_outputStream = nullptr;
 	}
 
+	Array<PakFile::Item>* PakWriter::FindItemsForNewFile(StringView& path)
+	{
+		DEATH_ASSERT(!path.empty() && path[path.size() - 1] != '/' && path[path.size() - 1] != '\\', nullptr, "\"%s\" is not valid file path", String::nullTerminatedView(path).data());
+
+		PakFile::Item* parentItem = FindOrCreateParentItem(path);
+		Array<PakFile::Item>* items;
+		if (parentItem != nullptr) {
+			items = &parentItem->ChildItems;
+		} else {
+			items = &_rootItems;
+		}
+
+		for (PakFile::Item& item : *items) {
+			if (item.Name == path) {
+				// File already exists in the .pak file
+				return nullptr;
+			}
+		}
+
+		return items;
+	}
+
 	PakFile::Item* PakWriter::FindOrCreateParentItem(StringView& path)
 	{
 		path = path.trimmedPrefix("/\\");
@@ -113,15 +113,41 @@ namespace Death { namespace IO {
 		Containers::String _path;
 		Containers::String _mountPoint;
 		Containers::Array<Item> _rootItems;
+#if defined(DEATH_TARGET_UNIX) || (defined(DEATH_TARGET_WINDOWS) && !defined(DEATH_TARGET_WINDOWS_RT))
+		/** @brief Whole .pak file mapped to memory, it's shared with all opened streams, so it outlives the @ref PakFile */
+		std::shared_ptr<Containers::Array<char, FileSystem::MapDeleter>> _mappedFile;
+#endif
 
 		void ReadIndex(std::unique_ptr<Stream>& s, Item* parentItem);
 
 		Item* FindItem(Containers::StringView path);
 	};
 
+	/**
+		@brief Preferred compression method of a file added to @ref PakWriter
+
+		Compressed files are stored uncompressed if the compression doesn't save enough space.
+	*/
+	enum class PakPreferredCompression {
+		/** @brief Store the file uncompressed */
+		None,
+		/** @brief Deflate with the best compression ratio */
+		Deflate,
+		/** @brief Deflate with the fastest compression level, suitable for large files like textures */
+		DeflateFast
+	};
+
 	class PakWriter
 	{
 	public:
+		/** @brief File that was read and compressed in advance, see @ref PrepareFile() */
+		struct PreparedFile {
+			Containers::Array<std::uint8_t> Data;
+			std::uint32_t UncompressedSize = 0;
+			std::uint32_t Size = 0;
+			bool IsCompressed = false;
+		};
+
 		Containers::String MountPoint;
 
 		explicit PakWriter(const Containers::StringView path);
@@ -132,15 +158,21 @@ namespace Death { namespace IO {
 
 		bool IsValid() const;
 
-		bool AddFile(Stream& stream, Containers::StringView path, bool compress = false);
+		bool AddFile(Stream& stream, Containers::StringView path, PakPreferredCompression compression = PakPreferredCompression::None);
+		/** @brief Adds a file prepared by @ref PrepareFile(), files are written in call order, so the output is deterministic */
+		bool AddPreparedFile(const PreparedFile& file, Containers::StringView path);
 		void Finalize();
 
+		/** @brief Reads the stream to memory and compresses it, it doesn't access any writer, so it can be called from multiple threads at once */
+		static bool PrepareFile(PreparedFile& file, Stream& stream, PakPreferredCompression compression);
+
 	private:
 		std::unique_ptr<FileStream> _outputStream;
 		Containers::Array<PakFile::Item> _rootItems;
 		bool _finalized;
 
 		PakFile::Item* FindOrCreateParentItem(Containers::StringView& path);
+		Containers::Array<PakFile::Item>* FindItemsForNewFile(Containers::StringView& path);
 		void WriteItemDescription(PakFile::Item& item);
 	};
 
@@ -1,9 +1,12 @@
 #include "Stream.h"
 
+#include <algorithm>
+
 namespace Death { namespace IO {
 //###==##====#=====--==~--~=~- --- -- -  -  -   -
 
 	Stream::Stream()
+		: _readBufferOffset(0), _readBufferSize(0), _readBufferPos(0), _readBufferLength(0)
 	{
 	}
 
@@ -52,7 +55,9 @@ namespace Death { namespace IO {
 		std::uint32_t shift = 0;
 		while (true) {
 			std::uint8_t byte;
-			if (Read(&byte, 1) == 0) {
+			if (_readBufferPos < _readBufferLength) {
+				byte = _readBuffer[_readBufferPos++];
+			} else if (Read(&byte, 1) == 0) {
 				break;
 			}
 
@@ -71,7 +76,9 @@ namespace Death { namespace IO {
 		std::uint64_t shift = 0;
 		while (true) {
 			std::uint8_t byte;
-			if (Read(&byte, 1) == 0) {
+			if (_readBufferPos < _readBufferLength) {
+				byte = _readBuffer[_readBufferPos++];
+			} else if (Read(&byte, 1) == 0) {
 				break;
 			}
 
@@ -122,4 +129,89 @@ namespace Death { namespace IO {
 		return bytesWritten;
 	}
 
+	void Stream::InitializeReadBuffer(std::int32_t size, std::int64_t position)
+	{
+		if (size > 0) {
+			_readBuffer = std::make_unique<std::uint8_t[]>(size);
+			_readBufferSize = size;
+		} else {
+			_readBuffer = nullptr;
+			_readBufferSize = 0;
+		}
+		DiscardReadBuffer(position);
+	}
+
+	std::int32_t Stream::ReadBuffered(void* buffer, std::int32_t bytes)
+	{
+		std::uint8_t* dst = static_cast<std::uint8_t*>(buffer);
+		std::int32_t bytesRead = std::min(_readBufferLength - _readBufferPos, bytes);
+		if (bytesRead > 0) {
+			std::memcpy(dst, &_readBuffer[_readBufferPos], bytesRead);
+			_readBufferPos += bytesRead;
+			if (bytesRead == bytes) {
+				return bytesRead;
+			}
+		}
+
+		// The buffer is exhausted, the underlying source is now positioned right after it
+		_readBufferOffset += _readBufferLength;
+		_readBufferPos = 0;
+		_readBufferLength = 0;
+
+		std::int32_t bytesLeft = bytes - bytesRead;
+		if (bytesLeft >= _readBufferSize) {
+			// Large reads bypass the buffer to avoid unnecessary copying
+			std::int32_t bytesReadDirect = ReadDirect(dst + bytesRead, bytesLeft);
+			if (bytesReadDirect > 0) {
+				_readBufferOffset += bytesReadDirect;
+				bytesRead += bytesReadDirect;
+			}
+			return bytesRead;
+		}
+
+		std::int32_t bytesFilled = ReadDirect(_readBuffer.get(), _readBufferSize);
+		if (bytesFilled > 0) {
+			_readBufferLength = bytesFilled;
+			std::int32_t bytesToCopy = std::min(bytesFilled, bytesLeft);
+			std::memcpy(dst + bytesRead, _readBuffer.get(), bytesToCopy);
+			_readBufferPos = bytesToCopy;
+			bytesRead += bytesToCopy;
+		}
+		return bytesRead;
+	}
+
+	std::int32_t Stream::ReadDirect(void* buffer, std::int32_t bytes)
+	{
+		// Not supported
+		return Stream::Invalid;
+	}
+
+	bool Stream::TrySeekInReadBuffer(std::int64_t& offset, SeekOrigin& origin, std::int64_t size)
+	{
+		std::int64_t newPos;
+		switch (origin) {
+			case SeekOrigin::Begin: newPos = offset; break;
+			case SeekOrigin::Current: newPos = GetReadBufferPosition() + offset; break;
+			case SeekOrigin::End: newPos = size + offset; break;
+			default: return false;
+		}
+
+		if (newPos >= _readBufferOffset && newPos <= _readBufferOffset + _readBufferLength) {
+			_readBufferPos = static_cast<std::int32_t>(newPos - _readBufferOffset);
+			offset = newPos;
+			return true;
+		}
+
+		offset = newPos;
+		origin = SeekOrigin::Begin;
+		return false;
+	}
+
+	void Stream::DiscardReadBuffer(std::int64_t position)
+	{
+		_readBufferOffset = position;
+		_readBufferPos = 0;
+		_readBufferLength = 0;
+	}
+
 }}
\ No newline at end of file
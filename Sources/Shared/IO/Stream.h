@@ -15,6 +15,7 @@
 #include "../Base/IDisposable.h"
 
 #include <cstdio>		// For FILE
+#include <cstring>
 #include <memory>
 
 namespace Death { namespace IO {
@@ -44,6 +45,9 @@ namespace Death { namespace IO {
 			NotSeekable = -3
 		};
 
+		/** @brief Default block size of the read-ahead buffer for streams that support buffered reading */
+		static constexpr std::int32_t DefaultReadBufferSize = 16384;
+
 		Stream();
 
 		/** @brief Closes the stream and releases all assigned resources */
@@ -67,11 +71,22 @@ namespace Death { namespace IO {
 		/** @brief Reads the bytes from the current stream and writes them to the target stream */
 		std::int64_t CopyTo(Stream& targetStream);
 
+		/** @brief Returns size of the read-ahead buffer, or zero if the stream is not buffered */
+		std::int32_t GetReadBufferSize() const {
+			return _readBufferSize;
+		}
+
 		template<typename T, class = typename std::enable_if<std::is_trivially_constructible<T>::value>::type>
 		DEATH_ALWAYS_INLINE T ReadValue()
 		{
 			T buffer = { };
-			Read(&buffer, sizeof(T));
+			// Copy directly from the read-ahead buffer if possible, otherwise fall back to virtual Read()
+			if (_readBufferPos + static_cast<std::int32_t>(sizeof(T)) <= _readBufferLength) {
+				std::memcpy(&buffer, &_readBuffer[_readBufferPos], sizeof(T));
+				_readBufferPos += static_cast<std::int32_t>(sizeof(T));
+			} else {
+				Read(&buffer, sizeof(T));
+			}
 			return buffer;
 		}
 
@@ -146,6 +161,36 @@ namespace Death { namespace IO {
 				((value << 8) & 0x000000FF00000000ULL) | ((value >> 8) & 0x00000000FF000000ULL) |
 				((value >> 24) & 0x0000000000FF0000ULL) | ((value >> 40) & 0x000000000000FF00ULL) | (value << 56);
 		}
+
+	protected:
+		/** @brief Read-ahead buffer, it's allocated only if the stream supports buffered reading */
+		std::unique_ptr<std::uint8_t[]> _readBuffer;
+		/** @brief Absolute position of the first byte in the read-ahead buffer */
+		std::int64_t _readBufferOffset;
+		std::int32_t _readBufferSize;
+		std::int32_t _readBufferPos;
+		std::int32_t _readBufferLength;
+
+		/** @brief Enables buffered reading with a given block size, the next read will start at a given absolute position */
+		void InitializeReadBuffer(std::int32_t size, std::int64_t position);
+		/** @brief Reads through the read-ahead buffer, reads at buffer boundaries and large reads are forwarded to @ref ReadDirect() */
+		std::int32_t ReadBuffered(void* buffer, std::int32_t bytes);
+		/** @brief Reads directly from the underlying source, streams that support buffered reading must override it */
+		virtual std::int32_t ReadDirect(void* buffer, std::int32_t bytes);
+		/** @brief Handles a seek request inside the read-ahead buffer if possible */
+		/*!
+			Returns `true` and the new position in `offset` if the target position is already buffered.
+			Otherwise, the request is converted to an absolute position from @ref SeekOrigin::Begin and
+			the underlying source must be seeked, followed by @ref DiscardReadBuffer() on success.
+		*/
+		bool TrySeekInReadBuffer(std::int64_t& offset, SeekOrigin& origin, std::int64_t size);
+		/** @brief Discards all buffered bytes, the next read will start at a given absolute position */
+		void DiscardReadBuffer(std::int64_t position);
+
+		/** @brief Returns absolute position of the next byte that will be read from the stream */
+		DEATH_ALWAYS_INLINE std::int64_t GetReadBufferPosition() const {
+			return _readBufferOffset + _readBufferPos;
+		}
 	};
 
 }}
\ No newline at end of file
@@ -44,6 +44,7 @@ namespace nCine
 		withAudio(true),
 		withThreads(false),
 		withScenegraph(true),
+		withRendering(true),
 		withVSync(true),
 		withGlDebugContext(false),
 
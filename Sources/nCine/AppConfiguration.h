@@ -74,6 +74,8 @@ namespace nCine
 		bool withThreads;
 		/// The flag is `true` if the scenegraph based rendering is enabled
 		bool withScenegraph;
+		/// The flag is `true` if the scenegraph is drawn, otherwise no window or graphics device is created and nodes are only updated (e.g., for dedicated servers)
+		bool withRendering;
 		/// The flag is `true` if the vertical synchronization is enabled
 		bool withVSync;
 		/// The flag is `true` if the OpenGL debug context is enabled
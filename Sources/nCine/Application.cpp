@@ -512,7 +512,7 @@ void DEATH_TRACE(TraceLevel level, const char* fmt, ...)
 namespace nCine
 {
 	Application::Application()
-		: isSuspended_(false), autoSuspension_(false), hasFocus_(true), shouldQuit_(false)
+		: isSuspended_(false), autoSuspension_(false), hasFocus_(true), shouldQuit_(false), fixedStepTime_(0.0f)
 	{
 	}
 
@@ -537,7 +537,8 @@ namespace nCine
 
 	float Application::GetTimeMult() const
 	{
-		return frameTimer_->GetTimeMult();
+		// Without rendering, the simulation is always stepped at fixed rate
+		return (appCfg_.withRendering ? frameTimer_->GetTimeMult() : 1.0f);
 	}
 
 	const FrameTimer& Application::GetFrameTimer() const
@@ -612,55 +613,62 @@ namespace nCine
 		}
 #endif
 
-		theServiceLocator().RegisterGfxCapabilities(std::make_unique<GfxCapabilities>());
-		const auto& gfxCapabilities = theServiceLocator().GetGfxCapabilities();
-		GLDebug::init(gfxCapabilities);
+		if (appCfg_.withRendering) {
+			theServiceLocator().RegisterGfxCapabilities(std::make_unique<GfxCapabilities>());
+			const auto& gfxCapabilities = theServiceLocator().GetGfxCapabilities();
+			GLDebug::init(gfxCapabilities);
 
 #if defined(DEATH_TARGET_ANDROID) && !(defined(WITH_FIXED_BATCH_SIZE) && WITH_FIXED_BATCH_SIZE > 0)
-		const StringView vendor = gfxCapabilities.glInfoStrings().vendor;
-		const StringView renderer = gfxCapabilities.glInfoStrings().renderer;
-		// Some GPUs doesn't work with dynamic batch size, so disable it for now
-		if (vendor == "Imagination Technologies"_s && (renderer == "PowerVR Rogue GE8300"_s || renderer == "PowerVR Rogue GE8320"_s)) {
-			const StringView vendorPrefix = vendor.findOr(' ', vendor.end());
-			if (renderer.hasPrefix(vendor.prefix(vendorPrefix.begin()))) {
-				LOGW("Detected %s: Using fixed batch size", renderer.data());
-			} else {
-				LOGW("Detected %s %s: Using fixed batch size", vendor.data(), renderer.data());
+			const StringView vendor = gfxCapabilities.glInfoStrings().vendor;
+			const StringView renderer = gfxCapabilities.glInfoStrings().renderer;
+			// Some GPUs doesn't work with dynamic batch size, so disable it for now
+			if (vendor == "Imagination Technologies"_s && (renderer == "PowerVR Rogue GE8300"_s || renderer == "PowerVR Rogue GE8320"_s)) {
+				const StringView vendorPrefix = vendor.findOr(' ', vendor.end());
+				if (renderer.hasPrefix(vendor.prefix(vendorPrefix.begin()))) {
+					LOGW("Detected %s: Using fixed batch size", renderer.data());
+				} else {
+					LOGW("Detected %s %s: Using fixed batch size", vendor.data(), renderer.data());
+				}
+				appCfg_.fixedBatchSize = 10;
 			}
-			appCfg_.fixedBatchSize = 10;
-		}
 #endif
 
 #if defined(WITH_RENDERDOC)
-		RenderDocCapture::init();
+			RenderDocCapture::init();
 #endif
+		}
 
 		frameTimer_ = std::make_unique<FrameTimer>(appCfg_.frameTimerLogInterval, 0.2f);
 #if 0 //defined(DEATH_TARGET_WINDOWS)
 		_waitableTimer = ::CreateWaitableTimerW(NULL, TRUE, NULL);
 #endif
 
-		LOGI("Creating rendering resources...");
+		if (appCfg_.withRendering) {
+			LOGI("Creating rendering resources...");
 
-		// Create a minimal set of render resources before compiling the first shader
-		RenderResources::createMinimal(); // they are required for rendering even without a scenegraph
-	
-		if (appCfg_.withScenegraph) {
-			gfxDevice_->setupGL();
-			RenderResources::create();
-			rootNode_ = std::make_unique<SceneNode>();
-			screenViewport_ = std::make_unique<ScreenViewport>();
-			screenViewport_->setRootNode(rootNode_.get());
-		}
+			// Create a minimal set of render resources before compiling the first shader
+			RenderResources::createMinimal(); // they are required for rendering even without a scenegraph
+
+			if (appCfg_.withScenegraph) {
+				gfxDevice_->setupGL();
+				RenderResources::create();
+				rootNode_ = std::make_unique<SceneNode>();
+				screenViewport_ = std::make_unique<ScreenViewport>();
+				screenViewport_->setRootNode(rootNode_.get());
+			}
 
 #if defined(WITH_IMGUI)
-		imguiDrawing_ = std::make_unique<ImGuiDrawing>(appCfg_.withScenegraph);
+			imguiDrawing_ = std::make_unique<ImGuiDrawing>(appCfg_.withScenegraph);
 
-		// Debug overlay is available even when scenegraph is not
-		if (appCfg_.withDebugOverlay) {
-			debugOverlay_ = std::make_unique<ImGuiDebugOverlay>(0.5f);	// 2 updates per second
-		}
+			// Debug overlay is available even when scenegraph is not
+			if (appCfg_.withDebugOverlay) {
+				debugOverlay_ = std::make_unique<ImGuiDebugOverlay>(0.5f);	// 2 updates per second
+			}
 #endif
+		} else if (appCfg_.withScenegraph) {
+			// Scenegraph is still updated without rendering, but there is no screen viewport to draw it to
+			rootNode_ = std::make_unique<SceneNode>();
+		}
 
 		// Initialization of the static random generator seeds
 		Random().Initialize(TimeStamp::now().ticks(), profileStartTime_.ticks());
@@ -681,12 +689,14 @@ namespace nCine
 			LOGI("IAppEventHandler::OnInitialize() invoked");
 		}
 
+		if (appCfg_.withRendering) {
 #if defined(WITH_IMGUI)
-		imguiDrawing_->buildFonts();
+			imguiDrawing_->buildFonts();
 #endif
 
-		// Swapping frame now for a cleaner API trace capture when debugging
-		gfxDevice_->update();
+			// Swapping frame now for a cleaner API trace capture when debugging
+			gfxDevice_->update();
+		}
 		FrameMark;
 		TracyGpuCollect;
 	}
@@ -695,6 +705,12 @@ namespace nCine
 	{
 		frameTimer_->AddFrame();
 
+		if (!appCfg_.withRendering) {
+			StepWithoutRendering();
+			LimitFrameRate();
+			return;
+		}
+
 #if defined(WITH_IMGUI)
 		{
 			ZoneScopedN("ImGui newFrame");
@@ -828,29 +844,82 @@ namespace nCine
 		FrameMark;
 		TracyGpuCollect;
 
-		if (appCfg_.frameLimit > 0) {
-			FrameMarkStart("Frame limiting");
-#if 0 //defined(DEATH_TARGET_WINDOWS)
-			// TODO: This code sometimes doesn't work properly
-			const std::uint64_t clockFreq = static_cast<std::uint64_t>(clock().frequency());
-			const std::uint64_t frameTimeDuration = (clockFreq / static_cast<std::uint64_t>(appCfg_.frameLimit));
-			const std::int64_t remainingTime = (std::int64_t)frameTimeDuration - (std::int64_t)frameTimer_->frameDurationAsTicks();
-			if (remainingTime > 0) {
-				LARGE_INTEGER dueTime;
-				dueTime.QuadPart = -(LONGLONG)((10000000ULL * remainingTime) / clockFreq);
-
-				::SetWaitableTimer(_waitableTimer, &dueTime, 0, 0, 0, FALSE);
-				::WaitForSingleObject(_waitableTimer, 1000);
-				::CancelWaitableTimer(_waitableTimer);
+		LimitFrameRate();
+	}
+
+	void Application::StepWithoutRendering()
+	{
+		// Simulation is stepped with constant time multiplier, so it's deterministic regardless of the actual frame duration
+		fixedStepTime_ += frameTimer_->GetLastFrameDuration();
+		std::int32_t stepCount = (std::int32_t)(fixedStepTime_ / FrameTimer::SecondsPerFrame);
+		if (stepCount > MaxFixedStepsPerFrame) {
+			// Simulation can't keep up, so the remaining time is dropped instead of falling further behind
+			stepCount = MaxFixedStepsPerFrame;
+			fixedStepTime_ = 0.0f;
+		} else {
+			fixedStepTime_ -= stepCount * FrameTimer::SecondsPerFrame;
+		}
+
+		for (std::int32_t i = 0; i < stepCount; i++) {
+			{
+				ZoneScopedNC("OnBeginFrame", 0x81A861);
+				appEventHandler_->OnBeginFrame();
+			}
+
+			if (appCfg_.withScenegraph) {
+				ZoneScopedNC("SceneGraph", 0x81A861);
+				{
+					ZoneScopedNC("Update", 0x81A861);
+					rootNode_->OnUpdate(GetTimeMult());
+				}
+				{
+					ZoneScopedNC("OnPostUpdate", 0x81A861);
+					appEventHandler_->OnPostUpdate();
+				}
 			}
+
+			{
+				ZoneScopedNC("OnFrameEnd", 0x81A861);
+				appEventHandler_->OnEndFrame();
+			}
+		}
+
+		FrameMark;
+	}
+
+	void Application::LimitFrameRate()
+	{
+		if (appCfg_.frameLimit <= 0) {
+			return;
+		}
+
+		FrameMarkStart("Frame limiting");
+#if 0 //defined(DEATH_TARGET_WINDOWS)
+		// TODO: This code sometimes doesn't work properly
+		const std::uint64_t clockFreq = static_cast<std::uint64_t>(clock().frequency());
+		const std::uint64_t frameTimeDuration = (clockFreq / static_cast<std::uint64_t>(appCfg_.frameLimit));
+		const std::int64_t remainingTime = (std::int64_t)frameTimeDuration - (std::int64_t)frameTimer_->frameDurationAsTicks();
+		if (remainingTime > 0) {
+			LARGE_INTEGER dueTime;
+			dueTime.QuadPart = -(LONGLONG)((10000000ULL * remainingTime) / clockFreq);
+
+			::SetWaitableTimer(_waitableTimer, &dueTime, 0, 0, 0, FALSE);
+			::WaitForSingleObject(_waitableTimer, 1000);
+			::CancelWaitableTimer(_waitableTimer);
+		}
 #else
-			const float frameDuration = 1.0f / static_cast<float>(appCfg_.frameLimit);
-			while (frameTimer_->GetFrameDuration() < frameDuration) {
-				Timer::sleep(0);
+		// Sleep for most of the remaining time and yield only for the last millisecond, so the frame pacing
+		// is still precise, but the thread doesn't keep the CPU busy (important when many instances are running)
+		const float frameDuration = 1.0f / static_cast<float>(appCfg_.frameLimit);
+		while (true) {
+			const float remainingTime = frameDuration - frameTimer_->GetFrameDuration();
+			if (remainingTime <= 0.0f) {
+				break;
 			}
-#endif
-			FrameMarkEnd("Frame limiting");
+			Timer::sleep(remainingTime > 0.002f ? (std::uint32_t)((remainingTime - 0.001f) * 1000.0f) : 0);
 		}
+#endif
+		FrameMarkEnd("Frame limiting");
 	}
 
 	void Application::ShutdownCommon()
@@ -36,17 +36,22 @@ namespace nCine
 		struct RenderingSettings
 		{
 			RenderingSettings()
-				: batchingEnabled(true), batchingWithIndices(false), cullingEnabled(true), minBatchSize(4), maxBatchSize(585) { }
+				: batchingEnabled(true), batchingWithIndices(false), instancingEnabled(true), cullingEnabled(true), reuseSortOrder(true), minBatchSize(4), maxBatchSize(585) { }
 
 			/// True if batching is enabled
 			bool batchingEnabled;
 			/// True if using indices for vertex batching
 			bool batchingWithIndices;
+			/// True if batches of sprites are drawn with per-instance vertex attributes instead of uniform blocks
+			bool instancingEnabled;
 			/// True if node culling is enabled
 			bool cullingEnabled;
+			/// True if render queues start sorting from the order of the last frame
+			bool reuseSortOrder;
 			/// Minimum size for a batch to be collected
 			unsigned int minBatchSize;
 			/// Maximum size for a batch before a forced split
+			/*! \note Instanced batches are only limited by the size of the common VBO */
 			unsigned int maxBatchSize;
 		};
 
@@ -131,12 +136,12 @@ namespace nCine
 		/// Returns the frame timer interface
 		const FrameTimer& GetFrameTimer() const;
 
-		/// Returns the drawable screen width as an integer number
-		inline std::int32_t GetWidth() const { return gfxDevice_->drawableWidth(); }
-		/// Returns the drawable screen height as an integer number
-		inline std::int32_t GetHeight() const { return gfxDevice_->drawableHeight(); }
-		/// Returns the drawable screen resolution as a `Vector2i` object
-		inline Vector2i GetResolution() const { return gfxDevice_->drawableResolution(); }
+		/// Returns the drawable screen width as an integer number (or the configured width without rendering)
+		inline std::int32_t GetWidth() const { return (gfxDevice_ != nullptr ? gfxDevice_->drawableWidth() : appCfg_.resolution.X); }
+		/// Returns the drawable screen height as an integer number (or the configured height without rendering)
+		inline std::int32_t GetHeight() const { return (gfxDevice_ != nullptr ? gfxDevice_->drawableHeight() : appCfg_.resolution.Y); }
+		/// Returns the drawable screen resolution as a `Vector2i` object (or the configured resolution without rendering)
+		inline Vector2i GetResolution() const { return (gfxDevice_ != nullptr ? gfxDevice_->drawableResolution() : appCfg_.resolution); }
 
 		/// Resizes the screen viewport, if exists
 		void ResizeScreenViewport(std::int32_t width, std::int32_t height);
@@ -174,6 +179,9 @@ namespace nCine
 		virtual void AttachTraceTarget(Containers::StringView targetPath);
 
 	protected:
+		/// Maximum number of simulation steps in one frame if rendering is disabled
+		static constexpr std::int32_t MaxFixedStepsPerFrame = 4;
+
 		AppConfiguration appCfg_;
 		RenderingSettings renderingSettings_;
 		bool isSuspended_;
@@ -193,6 +201,8 @@ namespace nCine
 
 		TimeStamp profileStartTime_;
 		std::unique_ptr<FrameTimer> frameTimer_;
+		/// Time that wasn't simulated yet if rendering is disabled
+		float fixedStepTime_;
 		std::unique_ptr<IGfxDevice> gfxDevice_;
 		std::unique_ptr<SceneNode> rootNode_;
 		std::unique_ptr<ScreenViewport> screenViewport_;
@@ -211,6 +221,10 @@ namespace nCine
 		void InitCommon();
 		/// A single step of the game loop made to render a frame
 		void Step();
+		/// Runs all pending simulation steps with constant time multiplier if rendering is disabled
+		void StepWithoutRendering();
+		/// Waits until the next frame according to the frame limit
+		void LimitFrameRate();
 		/// Must be called before exiting to shut down the application
 		void ShutdownCommon();
 
@@ -308,6 +308,8 @@ namespace nCine
 			discoverUniformBlocks(discover);
 			discoverAttributes();
 			initVertexFormat();
+			// Default attribute parameters are set only once here, so assigning the program to a material doesn't modify it
+			RenderResources::setDefaultAttributesParameters(*this);
 			status_ = Status::LinkedWithIntrospection;
 		}
 	}
@@ -7,7 +7,7 @@
 namespace nCine
 {
 	GLVertexFormat::Attribute::Attribute()
-		: enabled_(false), vbo_(nullptr), index_(0), size_(-1), type_(GL_FLOAT), stride_(0), pointer_(nullptr), baseOffset_(0)
+		: enabled_(false), vbo_(nullptr), index_(0), size_(-1), type_(GL_FLOAT), stride_(0), pointer_(nullptr), baseOffset_(0), divisor_(0)
 	{
 	}
 
@@ -27,7 +27,8 @@ namespace nCine
 					other.normalized_ == normalized_ &&
 					other.stride_ == stride_ &&
 					other.pointer_ == pointer_ &&
-					other.baseOffset_ == baseOffset_));
+					other.baseOffset_ == baseOffset_ &&
+					other.divisor_ == divisor_));
 	}
 
 	bool GLVertexFormat::Attribute::operator!=(const Attribute& other) const
@@ -46,6 +47,7 @@ namespace nCine
 		stride_ = 0;
 		pointer_ = nullptr;
 		baseOffset_ = 0;
+		divisor_ = 0;
 	}
 
 	void GLVertexFormat::Attribute::setVboParameters(GLsizei stride, const GLvoid* pointer)
@@ -70,11 +72,12 @@ namespace nCine
 				attributes_[i].vbo_->bind();
 				glEnableVertexAttribArray(attributes_[i].index_);
 
-#if (defined(WITH_OPENGLES) && !GL_ES_VERSION_3_2) || defined(DEATH_TARGET_EMSCRIPTEN)
 				const GLubyte* initialPointer = reinterpret_cast<const GLubyte*>(attributes_[i].pointer_);
+#if (defined(WITH_OPENGLES) && !GL_ES_VERSION_3_2) || defined(DEATH_TARGET_EMSCRIPTEN)
 				const GLvoid* pointer = reinterpret_cast<const GLvoid*>(initialPointer + attributes_[i].baseOffset_);
 #else
-				const GLvoid* pointer = attributes_[i].pointer_;
+				// Per-instance attributes are not affected by the first vertex, so the base offset is always applied to them
+				const GLvoid* pointer = (attributes_[i].divisor_ > 0 ? reinterpret_cast<const GLvoid*>(initialPointer + attributes_[i].baseOffset_) : attributes_[i].pointer_);
 #endif
 
 				switch (attributes_[i].type_) {
@@ -94,6 +97,8 @@ namespace nCine
 						glVertexAttribPointer(attributes_[i].index_, attributes_[i].size_, attributes_[i].type_, attributes_[i].normalized_, attributes_[i].stride_, pointer);
 						break;
 				}
+				// The divisor is part of the VAO state, it has to be reset when a VAO is reused for a different format
+				glVertexAttribDivisor(attributes_[i].index_, attributes_[i].divisor_);
 			}
 		}
 
@@ -50,6 +50,15 @@ namespace nCine
 		inline void setNumElementsPerVertex(unsigned int numElements) {
 			numElementsPerVertex_ = numElements;
 		}
+		/// Returns true if the VBO contains only per-instance attributes and vertices are generated by the shader
+		inline bool hasInstancedVbo() const {
+			return instancedVbo_;
+		}
+		/// Sets whether the VBO contains only per-instance attributes
+		/*! The VBO offset is then applied to attribute pointers instead of being added to the first vertex */
+		inline void setInstancedVbo(bool instancedVbo) {
+			instancedVbo_ = instancedVbo;
+		}
 		/// Creates a custom VBO that is unique to this `Geometry` object
 		void createCustomVbo(unsigned int numFloats, GLenum usage);
 		/// Retrieves a pointer that can be used to write vertex data from a custom VBO owned by this object
@@ -127,6 +136,7 @@ namespace nCine
 
 		bool hasDirtyVertices_;
 		bool hasDirtyIndices_;
+		bool instancedVbo_;
 
 		void bind();
 		void draw(GLsizei numInstances);
@@ -111,7 +111,7 @@ namespace nCine
 		}
 
 		const char* ExtensionNames[] = {
-			"GL_KHR_debug", "GL_ARB_texture_storage", "GL_ARB_get_program_binary",
+			"GL_KHR_debug", "GL_ARB_texture_storage", "GL_ARB_get_program_binary", "GL_ARB_buffer_storage",
 #if defined(WITH_OPENGLES) && !defined(DEATH_TARGET_EMSCRIPTEN) && !defined(DEATH_TARGET_SWITCH) && !defined(DEATH_TARGET_UNIX)
 			"GL_OES_get_program_binary",
 #endif
@@ -195,6 +195,7 @@ namespace nCine
 		LOGI("GL_KHR_debug: %d", glExtensions_[(int)GLExtensions::KHR_DEBUG]);
 		LOGI("GL_ARB_texture_storage: %d", glExtensions_[(int)GLExtensions::ARB_TEXTURE_STORAGE]);
 		LOGI("GL_ARB_get_program_binary: %d", glExtensions_[(int)GLExtensions::ARB_GET_PROGRAM_BINARY]);
+		LOGI("GL_ARB_buffer_storage: %d", glExtensions_[(int)GLExtensions::ARB_BUFFER_STORAGE]);
 #if defined(WITH_OPENGLES) && !defined(DEATH_TARGET_EMSCRIPTEN) && !defined(DEATH_TARGET_SWITCH) && !defined(DEATH_TARGET_UNIX)
 		LOGI("GL_OES_get_program_binary: %d", glExtensions_[(int)GLExtensions::OES_GET_PROGRAM_BINARY]);
 #endif
@@ -57,6 +57,7 @@ namespace nCine
 			KHR_DEBUG = 0,
 			ARB_TEXTURE_STORAGE,
 			ARB_GET_PROGRAM_BINARY,
+			ARB_BUFFER_STORAGE,
 #if defined(WITH_OPENGLES) && !defined(DEATH_TARGET_EMSCRIPTEN) && !defined(DEATH_TARGET_SWITCH) && !defined(DEATH_TARGET_UNIX)
 			OES_GET_PROGRAM_BINARY,
 #endif
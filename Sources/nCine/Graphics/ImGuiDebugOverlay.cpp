@@ -23,6 +23,8 @@
 #endif
 
 #include "RenderStatistics.h"
+#include "RenderResources.h"
+#include "RenderBuffersManager.h"
 #if defined(WITH_LUA)
 #	include "LuaStatistics.h"
 #endif
@@ -556,6 +558,7 @@ namespace nCine
 			ImGui::Text("GL_KHR_debug: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::KHR_DEBUG));
 			ImGui::Text("GL_ARB_texture_storage: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::ARB_TEXTURE_STORAGE));
 			ImGui::Text("GL_ARB_get_program_binary: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::ARB_GET_PROGRAM_BINARY));
+			ImGui::Text("GL_ARB_buffer_storage: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::ARB_BUFFER_STORAGE));
 #if defined(WITH_OPENGLES) && !defined(DEATH_TARGET_EMSCRIPTEN) && !defined(DEATH_TARGET_SWITCH) && !defined(DEATH_TARGET_UNIX)
 			ImGui::Text("GL_OES_get_program_binary: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::OES_GET_PROGRAM_BINARY));
 #endif
@@ -641,7 +644,11 @@ namespace nCine
 			ImGui::SameLine();
 			ImGui::Checkbox("Batching with indices", &settings.batchingWithIndices);
 			ImGui::SameLine();
+			ImGui::Checkbox("Instancing", &settings.instancingEnabled);
+			ImGui::SameLine();
 			ImGui::Checkbox("Culling", &settings.cullingEnabled);
+			ImGui::SameLine();
+			ImGui::Checkbox("Reuse sort order", &settings.reuseSortOrder);
 			ImGui::DragIntRange2("Batch size", &minBatchSize, &maxBatchSize, 1.0f, 0, 512);
 
 			settings.minBatchSize = minBatchSize;
@@ -1397,6 +1404,10 @@ namespace nCine
 			ImGui::PlotLines("", plotValues_[ValuesType::UboUsed].get(), numValues_, index_, nullptr, 0.0f, uboBuffers.size / 1024.0f);
 		}
 
+		const RenderStatistics::Streaming& streaming = RenderStatistics::streaming();
+		ImGui::Text("%.2f kB uploaded, %.2f ms stalled (%s)", streaming.uploadedBytes / 1024.0f, streaming.stallTime,
+			RenderResources::buffersManager().usesPersistentMapping() ? "persistent" : "remapped");
+
 		ImGui::Text("Viewport chain length: %u", Viewport::chain().size());
 
 		ImGui::End();
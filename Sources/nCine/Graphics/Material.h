@@ -52,6 +52,8 @@ namespace nCine
 			//BatchedTextNodesAlpha,
 			/// Shader program for a batch of TextNode classes with grayscale font texture
 			//BatchedTextNodesRed,
+			/// Shader program for a batch of Sprite classes with per-instance vertex attributes
+			InstancedSprites,
 			/// A custom shader program
 			Custom
 		};
@@ -77,6 +79,9 @@ namespace nCine
 		static constexpr char TexCoordsAttributeName[] = "aTexCoords";
 		static constexpr char MeshIndexAttributeName[] = "aMeshIndex";
 		static constexpr char ColorAttributeName[] = "aColor";
+		static constexpr char ModelMatrixAttributeNames[4][14] = { "aModelMatrix0", "aModelMatrix1", "aModelMatrix2", "aModelMatrix3" }; // for instanced shaders
+		static constexpr char TexRectAttributeName[] = "aTexRect";
+		static constexpr char SpriteSizeAttributeName[] = "aSpriteSize";
 
 		/// Default constructor
 		Material();
@@ -38,6 +38,8 @@ namespace nCine
 		ASSERT(minBatchSize > 1);
 		ASSERT(maxBatchSize >= minBatchSize);
 
+		const bool instancingEnabled = theApplication().GetRenderingSettings().instancingEnabled;
+
 		unsigned int lastSplit = 0;
 
 		for (unsigned int i = 1; i < srcQueue.size(); i++) {
@@ -56,8 +58,19 @@ namespace nCine
 
 			// Split point if last command or split condition
 			if (i == srcQueue.size() - 1 || shouldSplit) {
+				const GLShaderProgram* instancedShader = (instancingEnabled ? RenderResources::instancedShader(prevCommand->material().shaderProgram()) : nullptr);
 				const GLShaderProgram* batchedShader = RenderResources::batchedShader(prevCommand->material().shaderProgram());
-				if (batchedShader && (endSplit - lastSplit) >= minBatchSize) {
+				if (instancedShader && (endSplit - lastSplit) >= minBatchSize) {
+					// Instanced batches are only split when the common VBO cannot hold all the instances
+					while (endSplit - lastSplit >= minBatchSize) {
+						SmallVectorImpl<RenderCommand*>::const_iterator start = srcQueue.begin() + lastSplit;
+						SmallVectorImpl<RenderCommand*>::const_iterator end = srcQueue.begin() + endSplit;
+
+						RenderCommand* batchCommand = collectInstancedCommands(start, end, start);
+						destQueue.push_back(batchCommand);
+						lastSplit = (unsigned int)(start - srcQueue.begin());
+					}
+				} else if (batchedShader && (endSplit - lastSplit) >= minBatchSize) {
 					// Split point for the maximum batch size
 					while (lastSplit < endSplit) {
 						unsigned int currentMaxBatchSize = maxBatchSize;
@@ -195,20 +208,7 @@ namespace nCine
 			batchBlock->setUsedSize(uniformBlockCache.usedSize());
 		}
 
-		// Setting sampler uniforms for GL_TEXTURE* units
-		const GLShaderUniforms::UniformHashMapType allUniforms = refCommand->material().allUniforms();
-		for (const GLUniformCache& uniformCache : allUniforms) {
-			if (uniformCache.uniform()->type() == GL_SAMPLER_2D) {
-				GLUniformCache* batchUniformCache = batchCommand->material().uniform(uniformCache.uniform()->name());
-				const int refValue = uniformCache.intValue(0);
-				const int batchValue = batchUniformCache->intValue(0);
-				// Also checking if the command has just been added, as the memory at the
-				// uniforms data pointer is not cleared and might contain the reference value
-				if (batchValue != refValue || commandAdded) {
-					batchUniformCache->setIntValue(refValue);
-				}
-			}
-		}
+		copySamplerUniforms(refCommand, batchCommand, commandAdded);
 
 		const unsigned long maxVertexDataSize = RenderResources::buffersManager().specs(RenderBuffersManager::BufferTypes::Array).maxSize;
 		const unsigned long maxIndexDataSize = RenderResources::buffersManager().specs(RenderBuffersManager::BufferTypes::ElementArray).maxSize;
@@ -372,6 +372,86 @@ namespace nCine
 		return batchCommand;
 	}
 
+	RenderCommand* RenderBatcher::collectInstancedCommands(
+		SmallVectorImpl<RenderCommand*>::const_iterator start,
+		SmallVectorImpl<RenderCommand*>::const_iterator end,
+		SmallVectorImpl<RenderCommand*>::const_iterator& nextStart)
+	{
+		ASSERT(end > start);
+
+		const RenderCommand* refCommand = *start;
+		GLShaderProgram* instancedShader = RenderResources::instancedShader(refCommand->material().shaderProgram());
+		// The following check should never fail as it is already checked by the calling function
+		FATAL_ASSERT_MSG(instancedShader != nullptr, "Unsupported shader for instanced batch element");
+		bool commandAdded = false;
+		RenderCommand* batchCommand = RenderResources::renderCommandPool().retrieveOrAdd(instancedShader, commandAdded);
+
+#if defined(NCINE_PROFILING)
+		batchCommand->setType(refCommand->type());
+#endif
+
+		// Don't request more bytes than a common VBO can hold
+		constexpr unsigned int SizeInstance = sizeof(RenderResources::VertexFormatSpriteInstance);
+		const unsigned long maxVertexDataSize = RenderResources::buffersManager().specs(RenderBuffersManager::BufferTypes::Array).maxSize;
+		const unsigned int maxInstances = (unsigned int)(maxVertexDataSize / SizeInstance);
+		const unsigned int numInstances = std::min((unsigned int)(end - start), maxInstances);
+		nextStart = start + numInstances;
+
+		batchCommand->material().setUniformsDataPointer(acquireMemory(batchCommand->material().shaderProgram()->uniformsSize()));
+		copySamplerUniforms(refCommand, batchCommand, commandAdded);
+
+		GLfloat* destVtx = batchCommand->geometry().acquireVertexPointer(numInstances * SizeInstance / sizeof(GLfloat));
+		SmallVectorImpl<RenderCommand*>::const_iterator it = start;
+		while (it != nextStart) {
+			RenderCommand* command = *it;
+			command->commitNodeTransformation();
+
+			// The instance block of a sprite has the same layout as the per-instance vertex format
+			const GLUniformBlockCache* singleInstanceBlock = command->material().uniformBlock(Material::InstanceBlockName);
+			ASSERT(singleInstanceBlock->size() - singleInstanceBlock->alignAmount() >= SizeInstance);
+			memcpy(destVtx, singleInstanceBlock->dataPointer(), SizeInstance);
+			destVtx += SizeInstance / sizeof(GLfloat);
+			++it;
+		}
+		batchCommand->geometry().releaseVertexPointer();
+
+		for (unsigned int i = 0; i < GLTexture::MaxTextureUnits; i++) {
+			batchCommand->material().setTexture(i, refCommand->material().texture(i));
+		}
+		batchCommand->material().setBlendingEnabled(refCommand->material().isBlendingEnabled());
+		batchCommand->material().setBlendingFactors(refCommand->material().srcBlendingFactor(), refCommand->material().destBlendingFactor());
+		batchCommand->setBatchSize((int)numInstances);
+		batchCommand->setNumInstances((int)numInstances);
+		batchCommand->setLayer(refCommand->layer());
+		batchCommand->setVisitOrder(refCommand->visitOrder());
+
+		// Every instance is a quad generated from the vertex ID, like a single sprite
+		batchCommand->geometry().setDrawParameters(GL_TRIANGLE_STRIP, 0, 4);
+		batchCommand->geometry().setNumElementsPerVertex(SizeInstance / sizeof(GLfloat));
+		batchCommand->geometry().setNumIndices(0);
+		batchCommand->geometry().setInstancedVbo(true);
+
+		return batchCommand;
+	}
+
+	void RenderBatcher::copySamplerUniforms(const RenderCommand* refCommand, RenderCommand* batchCommand, bool commandAdded)
+	{
+		// Setting sampler uniforms for GL_TEXTURE* units
+		const GLShaderUniforms::UniformHashMapType allUniforms = refCommand->material().allUniforms();
+		for (const GLUniformCache& uniformCache : allUniforms) {
+			if (uniformCache.uniform()->type() == GL_SAMPLER_2D) {
+				GLUniformCache* batchUniformCache = batchCommand->material().uniform(uniformCache.uniform()->name());
+				const int refValue = uniformCache.intValue(0);
+				const int batchValue = batchUniformCache->intValue(0);
+				// Also checking if the command has just been added, as the memory at the
+				// uniforms data pointer is not cleared and might contain the reference value
+				if (batchValue != refValue || commandAdded) {
+					batchUniformCache->setIntValue(refValue);
+				}
+			}
+		}
+	}
+
 	unsigned char* RenderBatcher::acquireMemory(unsigned int bytes)
 	{
 		FATAL_ASSERT(bytes <= UboMaxSize);
@@ -38,6 +38,10 @@ namespace nCine
 		SmallVector<ManagedBuffer, 0> buffers_;
 
 		RenderCommand* collectCommands(SmallVectorImpl<RenderCommand*>::const_iterator start, SmallVectorImpl<RenderCommand*>::const_iterator end, SmallVectorImpl<RenderCommand*>::const_iterator& nextStart);
+		/// Collects sprite commands into a single draw with per-instance vertex attributes streamed from the common VBO
+		RenderCommand* collectInstancedCommands(SmallVectorImpl<RenderCommand*>::const_iterator start, SmallVectorImpl<RenderCommand*>::const_iterator end, SmallVectorImpl<RenderCommand*>::const_iterator& nextStart);
+		/// Copies the texture unit of every sampler uniform from the reference command to the batch command
+		void copySamplerUniforms(const RenderCommand* refCommand, RenderCommand* batchCommand, bool commandAdded);
 
 		unsigned char* acquireMemory(unsigned int bytes);
 		void createBuffer(unsigned int size);
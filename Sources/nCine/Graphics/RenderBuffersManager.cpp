@@ -3,15 +3,41 @@
 #include "GL/GLDebug.h"
 #include "../ServiceLocator.h"
 #include "IGfxCapabilities.h"
+#include "../Base/TimeStamp.h"
 #include "../../Common.h"
 #include "../tracy.h"
 
 namespace nCine
 {
+	namespace
+	{
+#if !defined(WITH_OPENGLES) && !(defined(DEATH_TARGET_APPLE) && defined(DEATH_TARGET_ARM))
+		/// Flags used both for the immutable storage and for the persistent mapping
+		constexpr GLbitfield PersistentMapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_FLUSH_EXPLICIT_BIT;
+#endif
+		/// Timeout of a single wait for a ring region to become available
+		constexpr GLuint64 FenceWaitTimeout = 1000000; // 1 ms
+	}
+
 	RenderBuffersManager::RenderBuffersManager(bool useBufferMapping, unsigned long vboMaxSize, unsigned long iboMaxSize)
+		: usePersistentMapping_(false), frameIndex_(0)
 	{
 		buffers_.reserve(4);
 
+		for (unsigned int i = 0; i < FramesInFlight; i++) {
+			fences_[i] = nullptr;
+		}
+#if defined(NCINE_PROFILING)
+		stallTime_ = 0.0f;
+#endif
+
+		const IGfxCapabilities& gfxCaps = theServiceLocator().GetGfxCapabilities();
+#if !defined(WITH_OPENGLES) && !(defined(DEATH_TARGET_APPLE) && defined(DEATH_TARGET_ARM))
+		// Persistent mapping requires immutable buffer storage, the classic path is used on OpenGL ES and WebGL
+		const int glVersion = gfxCaps.glVersion(IGfxCapabilities::GLVersion::Major) * 100 + gfxCaps.glVersion(IGfxCapabilities::GLVersion::Minor);
+		usePersistentMapping_ = (glVersion >= 404 || gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::ARB_BUFFER_STORAGE));
+#endif
+
 		BufferSpecifications& vboSpecs = specs_[(int)BufferTypes::Array];
 		vboSpecs.type = BufferTypes::Array;
 		vboSpecs.target = GL_ARRAY_BUFFER;
@@ -28,7 +54,6 @@ namespace nCine
 		iboSpecs.maxSize = iboMaxSize;
 		iboSpecs.alignment = sizeof(GLushort);
 
-		const IGfxCapabilities& gfxCaps = theServiceLocator().GetGfxCapabilities();
 		const int offsetAlignment = gfxCaps.value(IGfxCapabilities::GLIntValues::UNIFORM_BUFFER_OFFSET_ALIGNMENT);
 		const int uboMaxSize = gfxCaps.value(IGfxCapabilities::GLIntValues::MAX_UNIFORM_BLOCK_SIZE_NORMALIZED);
 
@@ -46,6 +71,15 @@ namespace nCine
 		}
 	}
 
+	RenderBuffersManager::~RenderBuffersManager()
+	{
+		for (unsigned int i = 0; i < FramesInFlight; i++) {
+			if (fences_[i] != nullptr) {
+				glDeleteSync(fences_[i]);
+			}
+		}
+	}
+
 	namespace
 	{
 		const char* bufferTypeToString(RenderBuffersManager::BufferTypes type)
@@ -73,7 +107,7 @@ namespace nCine
 
 		for (ManagedBuffer& buffer : buffers_) {
 			if (buffer.type == type) {
-				const unsigned long offset = buffer.size - buffer.freeSpace;
+				const unsigned long offset = regionOffset(buffer) + buffer.size - buffer.freeSpace;
 				const unsigned int alignAmount = (alignment - offset % alignment) % alignment;
 
 				if (buffer.freeSpace >= bytes + alignAmount) {
@@ -90,7 +124,7 @@ namespace nCine
 		if (params.object == nullptr) {
 			createBuffer(specs_[(int)type]);
 			params.object = buffers_.back().object.get();
-			params.offset = 0;
+			params.offset = regionOffset(buffers_.back());
 			params.size = bytes;
 			buffers_.back().freeSpace -= bytes;
 			params.mapBase = buffers_.back().mapBase;
@@ -104,6 +138,9 @@ namespace nCine
 		ZoneScopedC(0x81A861);
 		GLDebug::ScopedGroup scoped("RenderBuffersManager::flushUnmap()");
 
+#if defined(NCINE_PROFILING)
+		unsigned long uploadedBytes = 0;
+#endif
 		for (ManagedBuffer& buffer : buffers_) {
 #if defined(NCINE_PROFILING)
 			RenderStatistics::gatherStatistics(buffer);
@@ -111,8 +148,17 @@ namespace nCine
 			const unsigned long usedSize = buffer.size - buffer.freeSpace;
 			FATAL_ASSERT(usedSize <= specs_[(int)buffer.type].maxSize);
 			buffer.freeSpace = buffer.size;
+#if defined(NCINE_PROFILING)
+			uploadedBytes += usedSize;
+#endif
 
-			if (specs_[(int)buffer.type].mapFlags == 0) {
+			if (usePersistentMapping_) {
+				// The buffer stays mapped, only the written part of the current region has to be made visible to the GPU
+				if (usedSize > 0) {
+					buffer.object->flushMappedBufferRange(regionOffset(buffer), usedSize);
+				}
+				continue;
+			} else if (specs_[(int)buffer.type].mapFlags == 0) {
 				if (usedSize > 0) {
 					buffer.object->bufferSubData(0, usedSize, buffer.hostBuffer.get());
 				}
@@ -125,6 +171,11 @@ namespace nCine
 
 			buffer.mapBase = nullptr;
 		}
+
+#if defined(NCINE_PROFILING)
+		RenderStatistics::gatherStreamingStatistics(uploadedBytes, stallTime_);
+		stallTime_ = 0.0f;
+#endif
 	}
 
 	void RenderBuffersManager::remap()
@@ -132,6 +183,20 @@ namespace nCine
 		ZoneScopedC(0x81A861);
 		GLDebug::ScopedGroup scoped("RenderBuffersManager::remap()");
 
+		if (usePersistentMapping_) {
+			// Commands reading the current region have all been submitted, the next frame writes into the following one
+			if (fences_[frameIndex_] != nullptr) {
+				glDeleteSync(fences_[frameIndex_]);
+			}
+			fences_[frameIndex_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			frameIndex_ = (frameIndex_ + 1) % FramesInFlight;
+			waitForRegion(frameIndex_);
+			return;
+		}
+
+#if defined(NCINE_PROFILING)
+		const TimeStamp startTime = TimeStamp::now();
+#endif
 		for (ManagedBuffer& buffer : buffers_) {
 			ASSERT(buffer.freeSpace == buffer.size);
 			ASSERT(buffer.mapBase == nullptr);
@@ -144,6 +209,38 @@ namespace nCine
 			}
 			FATAL_ASSERT(buffer.mapBase != nullptr);
 		}
+#if defined(NCINE_PROFILING)
+		// Orphaning or mapping can block inside the driver when it runs out of buffer renaming space
+		stallTime_ += startTime.millisecondsSince();
+#endif
+	}
+
+	void RenderBuffersManager::waitForRegion(unsigned int index)
+	{
+		GLsync fence = fences_[index];
+		if (fence == nullptr) {
+			return;
+		}
+
+		ZoneScopedC(0x81A861);
+#if defined(NCINE_PROFILING)
+		const TimeStamp startTime = TimeStamp::now();
+#endif
+		// Commands have to be flushed with the first wait only, otherwise the fence might never be signaled
+		GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		while (true) {
+			const GLenum result = glClientWaitSync(fence, waitFlags, FenceWaitTimeout);
+			if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED) {
+				break;
+			}
+			waitFlags = 0;
+		}
+#if defined(NCINE_PROFILING)
+		stallTime_ += startTime.millisecondsSince();
+#endif
+
+		glDeleteSync(fence);
+		fences_[index] = nullptr;
 	}
 
 	void RenderBuffersManager::createBuffer(const BufferSpecifications& specs)
@@ -153,7 +250,14 @@ namespace nCine
 		managedBuffer.type = specs.type;
 		managedBuffer.size = specs.maxSize;
 		managedBuffer.object = std::make_unique<GLBufferObject>(specs.target);
-		managedBuffer.object->bufferData(managedBuffer.size, nullptr, specs.usageFlags);
+#if !defined(WITH_OPENGLES) && !(defined(DEATH_TARGET_APPLE) && defined(DEATH_TARGET_ARM))
+		if (usePersistentMapping_) {
+			managedBuffer.object->bufferStorage(managedBuffer.size * FramesInFlight, nullptr, PersistentMapFlags);
+		} else
+#endif
+		{
+			managedBuffer.object->bufferData(managedBuffer.size, nullptr, specs.usageFlags);
+		}
 		managedBuffer.freeSpace = managedBuffer.size;
 
 		switch (managedBuffer.type) {
@@ -169,6 +273,12 @@ namespace nCine
 				break;
 		}
 
+#if !defined(WITH_OPENGLES) && !(defined(DEATH_TARGET_APPLE) && defined(DEATH_TARGET_ARM))
+		if (usePersistentMapping_) {
+			// The whole ring is mapped only once, the mapping base is shared by all regions
+			managedBuffer.mapBase = static_cast<GLubyte*>(managedBuffer.object->mapBufferRange(0, managedBuffer.size * FramesInFlight, PersistentMapFlags));
+		} else
+#endif
 		if (specs.mapFlags == 0) {
 			managedBuffer.hostBuffer = std::make_unique<GLubyte[]>(specs.maxSize);
 			managedBuffer.mapBase = managedBuffer.hostBuffer.get();
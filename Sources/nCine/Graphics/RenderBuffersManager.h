@@ -44,7 +44,11 @@ namespace nCine
 			GLubyte* mapBase;
 		};
 
+		/// Number of frames that can be in flight when buffers are persistently mapped
+		static constexpr unsigned int FramesInFlight = 3;
+
 		RenderBuffersManager(bool useBufferMapping, unsigned long vboMaxSize, unsigned long iboMaxSize);
+		~RenderBuffersManager();
 
 		/// Returns the specifications for a buffer of the specified type
 		inline const BufferSpecifications& specs(BufferTypes type) const {
@@ -57,6 +61,11 @@ namespace nCine
 		/// Requests an amount of bytes from the specified buffer type with a custom alignment requirement
 		Parameters acquireMemory(BufferTypes type, unsigned long bytes, unsigned int alignment);
 
+		/// Returns `true` if the buffers are persistently mapped and streamed through a ring of frames
+		inline bool usesPersistentMapping() const {
+			return usePersistentMapping_;
+		}
+
 	private:
 		BufferSpecifications specs_[(int)BufferTypes::Count];
 
@@ -67,6 +76,7 @@ namespace nCine
 
 			BufferTypes type;
 			std::unique_ptr<GLBufferObject> object;
+			/// Size of the region that can be used in a single frame
 			unsigned long size;
 			unsigned long freeSpace;
 			GLubyte* mapBase;
@@ -75,9 +85,25 @@ namespace nCine
 
 		SmallVector<ManagedBuffer, 0> buffers_;
 
+		/// Whether buffers are allocated as immutable storage, mapped only once and written in a ring of `FramesInFlight` regions
+		bool usePersistentMapping_;
+		/// Index of the ring region that is being written in the current frame
+		unsigned int frameIndex_;
+		/// Fences signaled when the GPU finishes reading a ring region
+		GLsync fences_[FramesInFlight];
+#if defined(NCINE_PROFILING)
+		/// Time spent waiting for the GPU before the current frame could write into the buffers
+		float stallTime_;
+#endif
+
 		void flushUnmap();
 		void remap();
 		void createBuffer(const BufferSpecifications& specs);
+		/// Returns the offset of the current ring region inside a buffer
+		inline unsigned long regionOffset(const ManagedBuffer& buffer) const {
+			return (usePersistentMapping_ ? frameIndex_ * buffer.size : 0);
+		}
+		void waitForRegion(unsigned int index);
 
 		friend class ScreenViewport;
 #if defined(NCINE_PROFILING)
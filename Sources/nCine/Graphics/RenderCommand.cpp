@@ -45,9 +45,13 @@ namespace nCine
 		}
 
 		unsigned int offset = 0;
+		if (geometry_.instancedVbo_) {
+			// Per-instance attributes are offset directly as the first vertex doesn't apply to them
+			offset = geometry_.vboParams().offset;
+		}
 #if (defined(WITH_OPENGLES) && !GL_ES_VERSION_3_2) || defined(DEATH_TARGET_EMSCRIPTEN)
 		// Simulating missing `glDrawElementsBaseVertex()` on OpenGL ES 3.0
-		if (geometry_.numIndices_ > 0) {
+		else if (geometry_.numIndices_ > 0) {
 			offset = geometry_.vboParams().offset + (geometry_.firstVertex_ * geometry_.numElementsPerVertex_ * sizeof(GLfloat));
 		}
 #endif
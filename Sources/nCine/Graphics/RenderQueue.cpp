@@ -10,6 +10,8 @@
 #include "../Base/Algorithms.h"
 #include "../tracy_opengl.h"
 
+#include <cstring>
+
 namespace nCine
 {
 #if defined(DEATH_DEBUG)
@@ -22,6 +24,8 @@ namespace nCine
 
 	RenderQueue::RenderQueue()
 	{
+		opaqueEntries_.reserve(16);
+		transparentEntries_.reserve(16);
 		opaqueQueue_.reserve(16);
 		opaqueBatchedQueue_.reserve(16);
 		transparentQueue_.reserve(16);
@@ -30,7 +34,7 @@ namespace nCine
 
 	bool RenderQueue::empty() const
 	{
-		return (opaqueQueue_.empty() && transparentQueue_.empty());
+		return (opaqueEntries_.empty() && transparentEntries_.empty());
 	}
 
 	void RenderQueue::addCommand(RenderCommand* command)
@@ -38,27 +42,89 @@ namespace nCine
 		// Calculating the material sorting key before adding the command to the queue
 		command->calculateMaterialSortKey();
 
+		// Opaque commands are drawn in descending order, so their keys are inverted to share the ascending sort
 		if (!command->material().isBlendingEnabled()) {
-			opaqueQueue_.push_back(command);
+			opaqueEntries_.push_back({ ~command->materialSortKey(), ~command->idSortKey(), (uint32_t)opaqueEntries_.size(), command });
 		} else {
-			transparentQueue_.push_back(command);
+			transparentEntries_.push_back({ command->materialSortKey(), command->idSortKey(), (uint32_t)transparentEntries_.size(), command });
 		}
 	}
 
+	void RenderQueue::appendCommands(RenderQueue& other)
+	{
+		appendEntries(opaqueEntries_, other.opaqueEntries_);
+		appendEntries(transparentEntries_, other.transparentEntries_);
+	}
+
 	namespace
 	{
-		bool descendingOrder(const RenderCommand* a, const RenderCommand* b)
+		/// Maximum number of out of order entries that are still fixed with an insertion sort
+		constexpr uint32_t MaxDescentsForInsertionSort = 8;
+		/// Number of radix sort passes, four bytes of the id key followed by eight bytes of the material key
+		constexpr uint32_t RadixPassCount = 12;
+
+		template<class T>
+		inline bool isLess(const T& a, const T& b)
+		{
+			return (a.key != b.key ? a.key < b.key : a.id < b.id);
+		}
+
+		template<class T>
+		inline uint32_t radixByte(const T& entry, uint32_t pass)
+		{
+			return (pass < 4
+				? (entry.id >> (pass * 8)) & 0xFF
+				: (uint32_t)(entry.key >> ((pass - 4) * 8)) & 0xFF);
+		}
+
+		template<class T>
+		void insertionSort(T* entries, uint32_t count)
 		{
-			return (a->materialSortKey() != b->materialSortKey())
-				? a->materialSortKey() > b->materialSortKey()
-				: a->idSortKey() > b->idSortKey();
+			for (uint32_t i = 1; i < count; i++) {
+				const T entry = entries[i];
+				uint32_t j = i;
+				while (j > 0 && isLess(entry, entries[j - 1])) {
+					entries[j] = entries[j - 1];
+					j--;
+				}
+				entries[j] = entry;
+			}
 		}
 
-		bool ascendingOrder(const RenderCommand* a, const RenderCommand* b)
+		/// Stable LSD radix sort on the packed keys, passes whose byte is the same for all entries are skipped
+		template<class T>
+		void radixSort(T* entries, T* buffer, uint32_t count)
 		{
-			return (a->materialSortKey() != b->materialSortKey())
-				? a->materialSortKey() < b->materialSortKey()
-				: a->idSortKey() < b->idSortKey();
+			uint32_t histograms[RadixPassCount][256] = {};
+			for (uint32_t i = 0; i < count; i++) {
+				for (uint32_t pass = 0; pass < RadixPassCount; pass++) {
+					histograms[pass][radixByte(entries[i], pass)]++;
+				}
+			}
+
+			T* src = entries;
+			T* dst = buffer;
+			for (uint32_t pass = 0; pass < RadixPassCount; pass++) {
+				uint32_t* histogram = histograms[pass];
+				if (histogram[radixByte(src[0], pass)] == count) {
+					continue;
+				}
+
+				uint32_t offset = 0;
+				for (uint32_t i = 0; i < 256; i++) {
+					const uint32_t bucketSize = histogram[i];
+					histogram[i] = offset;
+					offset += bucketSize;
+				}
+				for (uint32_t i = 0; i < count; i++) {
+					dst[histogram[radixByte(src[i], pass)]++] = src[i];
+				}
+				std::swap(src, dst);
+			}
+
+			if (src != entries) {
+				std::memcpy(entries, src, count * sizeof(T));
+			}
 		}
 
 #if defined(DEATH_DEBUG) && defined(NCINE_PROFILING)
@@ -85,9 +151,14 @@ namespace nCine
 	{
 		const bool batchingEnabled = theApplication().GetRenderingSettings().batchingEnabled;
 
-		// Sorting the queues with the relevant orders
-		sort(opaqueQueue_.begin(), opaqueQueue_.end(), descendingOrder);
-		sort(transparentQueue_.begin(), transparentQueue_.end(), ascendingOrder);
+		const bool reuseSortOrder = theApplication().GetRenderingSettings().reuseSortOrder;
+
+		{
+			ZoneScopedNC("Sorting", 0x81A861);
+			// Sorting the queues with the relevant orders
+			sortEntries(opaqueEntries_, opaqueOrder_, opaqueQueue_, reuseSortOrder);
+			sortEntries(transparentEntries_, transparentOrder_, transparentQueue_, reuseSortOrder);
+		}
 
 		SmallVectorImpl<RenderCommand*>* opaques = batchingEnabled ? &opaqueBatchedQueue_ : &opaqueQueue_;
 		SmallVectorImpl<RenderCommand*>* transparents = batchingEnabled ? &transparentBatchedQueue_ : &transparentQueue_;
@@ -204,6 +275,8 @@ namespace nCine
 
 	void RenderQueue::clear()
 	{
+		opaqueEntries_.clear();
+		transparentEntries_.clear();
 		opaqueQueue_.clear();
 		opaqueBatchedQueue_.clear();
 		transparentQueue_.clear();
@@ -211,4 +284,55 @@ namespace nCine
 
 		RenderResources::renderBatcher().reset();
 	}
+
+	void RenderQueue::appendEntries(SmallVectorImpl<SortEntry>& dest, SmallVectorImpl<SortEntry>& src)
+	{
+		const uint32_t firstIndex = (uint32_t)dest.size();
+		dest.reserve(firstIndex + src.size());
+		for (const SortEntry& entry : src) {
+			dest.push_back({ entry.key, entry.id, firstIndex + entry.index, entry.command });
+		}
+		src.clear();
+	}
+
+	void RenderQueue::sortEntries(SmallVectorImpl<SortEntry>& entries, SmallVectorImpl<uint32_t>& lastOrder, SmallVectorImpl<RenderCommand*>& queue, bool reuseOrder)
+	{
+		const uint32_t count = (uint32_t)entries.size();
+		bool isSorted = (count <= 1);
+
+		// Commands are added in the scenegraph visit order, so the last permutation still sorts them if keys barely changed
+		if (!isSorted && reuseOrder && lastOrder.size() == count) {
+			sortBuffer_.resize_for_overwrite(count);
+			for (uint32_t i = 0; i < count; i++) {
+				sortBuffer_[i] = entries[lastOrder[i]];
+			}
+
+			uint32_t descents = 0;
+			for (uint32_t i = 1; i < count; i++) {
+				if (isLess(sortBuffer_[i], sortBuffer_[i - 1])) {
+					descents++;
+				}
+			}
+
+			if (descents <= MaxDescentsForInsertionSort) {
+				entries.swap(sortBuffer_);
+				if (descents > 0) {
+					insertionSort(entries.data(), count);
+				}
+				isSorted = true;
+			}
+		}
+
+		if (!isSorted) {
+			sortBuffer_.resize_for_overwrite(count);
+			radixSort(entries.data(), sortBuffer_.data(), count);
+		}
+
+		lastOrder.resize_for_overwrite(count);
+		queue.resize_for_overwrite(count);
+		for (uint32_t i = 0; i < count; i++) {
+			lastOrder[i] = entries[i].index;
+			queue[i] = entries[i].command;
+		}
+	}
 }
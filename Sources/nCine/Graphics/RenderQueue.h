@@ -20,6 +20,9 @@ namespace nCine
 
 		/// Adds a draw command to the queue
 		void addCommand(RenderCommand* command);
+		/// Moves all draw commands of another queue to the end of this one
+		/*! \note Sort keys are not calculated again, so the other queue can be filled on a worker thread */
+		void appendCommands(RenderQueue& other);
 
 		/// Sorts the queues, create batches and commits commands
 		void sortAndCommit();
@@ -30,6 +33,29 @@ namespace nCine
 		void clear();
 
 	private:
+		/// Sorting key of a queued command, copied next to the command pointer to avoid dereferencing it while sorting
+		struct SortEntry
+		{
+			/// Material sort key, inverted for queues sorted in descending order
+			uint64_t key;
+			/// Id sort key used when material keys are equal, inverted for queues sorted in descending order
+			uint32_t id;
+			/// Position of the command in the order of addition
+			uint32_t index;
+			RenderCommand* command;
+		};
+
+		/// Array of opaque sort entries in the order of addition
+		SmallVector<SortEntry, 0> opaqueEntries_;
+		/// Array of transparent sort entries in the order of addition
+		SmallVector<SortEntry, 0> transparentEntries_;
+		/// Temporary array used by the radix sort
+		SmallVector<SortEntry, 0> sortBuffer_;
+		/// Permutation that sorted the opaque entries in the last frame
+		SmallVector<uint32_t, 0> opaqueOrder_;
+		/// Permutation that sorted the transparent entries in the last frame
+		SmallVector<uint32_t, 0> transparentOrder_;
+
 		/// Array of opaque render command pointers
 		SmallVector<RenderCommand*, 0> opaqueQueue_;
 		/// Array of opaque batched render command pointers
@@ -38,6 +64,11 @@ namespace nCine
 		SmallVector<RenderCommand*, 0> transparentQueue_;
 		/// Array of transparent batched render command pointers
 		SmallVector<RenderCommand*, 0> transparentBatchedQueue_;
+
+		/// Moves the source entries to the end of the destination array
+		static void appendEntries(SmallVectorImpl<SortEntry>& dest, SmallVectorImpl<SortEntry>& src);
+		/// Sorts the entries, reusing the last frame permutation if allowed, and fills the queue with the sorted commands
+		void sortEntries(SmallVectorImpl<SortEntry>& entries, SmallVectorImpl<uint32_t>& lastOrder, SmallVectorImpl<RenderCommand*>& queue, bool reuseOrder);
 	};
 
 }
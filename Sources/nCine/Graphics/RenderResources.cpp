@@ -36,6 +36,15 @@ namespace nCine
 			GLShaderProgram::Introspection introspection;
 			const char* shaderName;
 		};
+
+		void setInstanceAttributeParameters(GLShaderProgram& shaderProgram, const char* name, std::size_t offset)
+		{
+			GLVertexFormat::Attribute* attribute = shaderProgram.attribute(name);
+			if (attribute != nullptr) {
+				attribute->setVboParameters(sizeof(RenderResources::VertexFormatSpriteInstance), reinterpret_cast<void*>(offset));
+				attribute->setDivisor(1);
+			}
+		}
 	}
 
 	std::unique_ptr<BinaryShaderCache> RenderResources::binaryShaderCache_;
@@ -80,6 +89,15 @@ namespace nCine
 		return (batchedShaders_.erase(shader) > 0);
 	}
 
+	GLShaderProgram* RenderResources::instancedShader(const GLShaderProgram* shader)
+	{
+		// Only sprites have an instance block with the same layout as the per-instance vertex format
+		if (shader != nullptr && shader == defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::Sprite)].get()) {
+			return defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::InstancedSprites)].get();
+		}
+		return nullptr;
+	}
+
 	RenderResources::CameraUniformData* RenderResources::findCameraUniformData(GLShaderProgram* shaderProgram)
 	{
 		auto it = cameraUniformDataMap_.find(shaderProgram);
@@ -107,6 +125,20 @@ namespace nCine
 			return;
 		}
 
+		// Per-instance attributes of instanced shaders advance once for every instance instead of every vertex
+		GLVertexFormat::Attribute* modelMatrixAttribute = shaderProgram.attribute(Material::ModelMatrixAttributeNames[0]);
+		if (modelMatrixAttribute != nullptr) {
+			if (modelMatrixAttribute->stride() == 0) {
+				for (unsigned int i = 0; i < 4; i++) {
+					setInstanceAttributeParameters(shaderProgram, Material::ModelMatrixAttributeNames[i], offsetof(VertexFormatSpriteInstance, modelMatrix) + i * 4 * sizeof(GLfloat));
+				}
+				setInstanceAttributeParameters(shaderProgram, Material::ColorAttributeName, offsetof(VertexFormatSpriteInstance, color));
+				setInstanceAttributeParameters(shaderProgram, Material::TexRectAttributeName, offsetof(VertexFormatSpriteInstance, texRect));
+				setInstanceAttributeParameters(shaderProgram, Material::SpriteSizeAttributeName, offsetof(VertexFormatSpriteInstance, spriteSize));
+			}
+			return;
+		}
+
 		GLVertexFormat::Attribute* positionAttribute = shaderProgram.attribute(Material::PositionAttributeName);
 		GLVertexFormat::Attribute* texCoordsAttribute = shaderProgram.attribute(Material::TexCoordsAttributeName);
 		GLVertexFormat::Attribute* meshIndexAttribute = shaderProgram.attribute(Material::MeshIndexAttributeName);
@@ -229,7 +261,8 @@ namespace nCine
 			//{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BatchedMeshSpritesGray)], ShaderStrings::batched_meshsprites_vs + 1, ShaderStrings::sprite_gray_fs + 1, GLShaderProgram::Introspection::NoUniformsInBlocks, "Batched_MeshSprites_Gray" },
 			{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BatchedMeshSpritesNoTexture)], ShaderStrings::batched_meshsprites_notexture_vs + 1, ShaderStrings::sprite_notexture_fs + 1, GLShaderProgram::Introspection::NoUniformsInBlocks, "Batched_MeshSprites_NoTexture" },
 			//{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BatchedTextNodesAlpha)], ShaderStrings::batched_textnodes_vs + 1, ShaderStrings::textnode_alpha_fs + 1, GLShaderProgram::Introspection::NoUniformsInBlocks, "Batched_TextNodes_Alpha" },
-			//{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BatchedTextNodesRed)], ShaderStrings::batched_textnodes_vs + 1, ShaderStrings::textnode_red_fs + 1, GLShaderProgram::Introspection::NoUniformsInBlocks, "Batched_TextNodes_Red" }
+			//{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BatchedTextNodesRed)], ShaderStrings::batched_textnodes_vs + 1, ShaderStrings::textnode_red_fs + 1, GLShaderProgram::Introspection::NoUniformsInBlocks, "Batched_TextNodes_Red" },
+			{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::InstancedSprites)], ShaderStrings::instanced_sprites_vs + 1, ShaderStrings::sprite_fs + 1, GLShaderProgram::Introspection::Enabled, "Instanced_Sprites" }
 #else
 			{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::Sprite)], "sprite_vs.glsl", "sprite_fs.glsl", GLShaderProgram::Introspection::Enabled, "Sprite" },
 			//{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::SpriteGray)], "sprite_vs.glsl", "sprite_gray_fs.glsl", GLShaderProgram::Introspection::Enabled, "Sprite_Gray" },
@@ -246,7 +279,8 @@ namespace nCine
 			//{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BatchedMeshSpritesGray)], "batched_meshsprites_vs.glsl", "sprite_gray_fs.glsl", GLShaderProgram::Introspection::NoUniformsInBlocks, "Batched_MeshSprites_Gray" },
 			{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BatchedMeshSpritesNoTexture)], "batched_meshsprites_notexture_vs.glsl", "sprite_notexture_fs.glsl", GLShaderProgram::Introspection::NoUniformsInBlocks, "Batched_MeshSprites_NoTexture" },
 			//{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BatchedTextNodesAlpha)], "batched_textnodes_vs.glsl", "textnode_alpha_fs.glsl", GLShaderProgram::Introspection::NoUniformsInBlocks, "Batched_TextNodes_Alpha" },
-			//{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BatchedTextNodesRed)], "batched_textnodes_vs.glsl", "textnode_red_fs.glsl", GLShaderProgram::Introspection::NoUniformsInBlocks, "Batched_TextNodes_Red" }
+			//{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BatchedTextNodesRed)], "batched_textnodes_vs.glsl", "textnode_red_fs.glsl", GLShaderProgram::Introspection::NoUniformsInBlocks, "Batched_TextNodes_Red" },
+			{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::InstancedSprites)], "instanced_sprites_vs.glsl", "sprite_fs.glsl", GLShaderProgram::Introspection::Enabled, "Instanced_Sprites" }
 #endif
 		};
 
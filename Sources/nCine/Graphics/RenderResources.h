@@ -63,6 +63,15 @@ namespace nCine
 			int drawindex;
 		};
 
+		/// A vertex format structure for per-instance attributes of sprites, it matches the std140 layout of their instance block
+		struct VertexFormatSpriteInstance
+		{
+			GLfloat modelMatrix[16];
+			GLfloat color[4];
+			GLfloat texRect[4];
+			GLfloat spriteSize[2];
+		};
+
 		struct CameraUniformData
 		{
 			CameraUniformData()
@@ -95,6 +104,8 @@ namespace nCine
 		static GLShaderProgram* batchedShader(const GLShaderProgram* shader);
 		static bool registerBatchedShader(const GLShaderProgram* shader, GLShaderProgram* batchedShader);
 		static bool unregisterBatchedShader(const GLShaderProgram* shader);
+		/// Returns the shader program that draws a batch of the specified shader with per-instance attributes, if any
+		static GLShaderProgram* instancedShader(const GLShaderProgram* shader);
 
 		static inline unsigned char* cameraUniformsBuffer() {
 			return cameraUniformsBuffer_;
@@ -8,6 +8,7 @@ namespace nCine
 	RenderStatistics::Commands RenderStatistics::allCommands_;
 	RenderStatistics::Commands RenderStatistics::typedCommands_[(int)RenderCommand::Type::Count];
 	RenderStatistics::Buffers RenderStatistics::typedBuffers_[(int)RenderBuffersManager::BufferTypes::Count];
+	RenderStatistics::Streaming RenderStatistics::streaming_;
 	RenderStatistics::Textures RenderStatistics::textures_;
 	RenderStatistics::CustomBuffers RenderStatistics::customVbos_;
 	RenderStatistics::CustomBuffers RenderStatistics::customIbos_;
@@ -20,6 +21,8 @@ namespace nCine
 	{
 		TracyPlot("Vertices", static_cast<int64_t>(allCommands_.vertices));
 		TracyPlot("Render Commands", static_cast<int64_t>(allCommands_.commands));
+		TracyPlot("Uploaded Bytes", static_cast<int64_t>(streaming_.uploadedBytes));
+		TracyPlot("Buffer Stall Time", streaming_.stallTime);
 
 		for (unsigned int i = 0; i < (unsigned int)RenderCommand::Type::Count; i++) {
 			typedCommands_[i].reset();
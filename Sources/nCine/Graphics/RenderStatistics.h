@@ -56,6 +56,18 @@ namespace nCine
 			friend RenderStatistics;
 		};
 
+		class Streaming
+		{
+		public:
+			/// Bytes written to the managed buffers in the last frame
+			unsigned long uploadedBytes;
+			/// Milliseconds spent waiting for the GPU before the managed buffers could be written
+			float stallTime;
+
+			Streaming()
+				: uploadedBytes(0), stallTime(0.0f) {}
+		};
+
 		class Textures
 		{
 		public:
@@ -152,6 +164,11 @@ namespace nCine
 			return typedBuffers_[(int)type];
 		}
 
+		/// Returns statistics about data streamed through the managed buffers
+		static inline const Streaming& streaming() {
+			return streaming_;
+		}
+
 		/// Returns aggregated texture statistics
 		static inline const Textures& textures() {
 			return textures_;
@@ -186,6 +203,7 @@ namespace nCine
 		static Commands allCommands_;
 		static Commands typedCommands_[(int)RenderCommand::Type::Count];
 		static Buffers typedBuffers_[(int)RenderBuffersManager::BufferTypes::Count];
+		static Streaming streaming_;
 		static Textures textures_;
 		static CustomBuffers customVbos_;
 		static CustomBuffers customIbos_;
@@ -197,6 +215,11 @@ namespace nCine
 		static void reset();
 		static void gatherStatistics(const RenderCommand& command);
 		static void gatherStatistics(const RenderBuffersManager::ManagedBuffer& buffer);
+		static inline void gatherStreamingStatistics(unsigned long uploadedBytes, float stallTime)
+		{
+			streaming_.uploadedBytes = uploadedBytes;
+			streaming_.stallTime = stallTime;
+		}
 		static inline void gatherVaoPoolStatistics(unsigned int poolSize, unsigned int poolCapacity)
 		{
 			vaoPool_.size = poolSize;
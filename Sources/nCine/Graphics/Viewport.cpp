@@ -312,6 +312,12 @@ namespace nCine
 		}
 	}
 
+	namespace
+	{
+		/// Minimum number of root subtrees processed by a single job when updating culling in parallel
+		constexpr std::int32_t CullingGrainSize = 32;
+	}
+
 	void Viewport::update()
 	{
 		RenderResources::setCurrentViewport(this);
@@ -322,8 +328,15 @@ namespace nCine
 			if (rootNode_->lastFrameUpdated() < theApplication().GetFrameCount()) {
 				rootNode_->OnUpdate(theApplication().GetTimeMult());
 			}
-			// AABBs should update after nodes have been transformed
-			updateCulling(rootNode_);
+			// AABBs should update after nodes have been transformed, subtrees of the root are independent
+			const SmallVectorImpl<SceneNode*>& children = rootNode_->children();
+			theServiceLocator().GetThreadPool().ParallelFor(0, (std::int32_t)children.size(), CullingGrainSize, [this, &children](std::int32_t begin, std::int32_t end) {
+				ZoneScopedNC("Culling", 0x81A861);
+				for (std::int32_t i = begin; i < end; i++) {
+					updateCulling(children[i]);
+				}
+			});
+			updateNodeCulling(rootNode_);
 		}
 
 		stateBits_.set(StateBitPositions::UpdatedBit);
@@ -469,6 +482,11 @@ namespace nCine
 			updateCulling(child);
 		}
 
+		updateNodeCulling(node);
+	}
+
+	void Viewport::updateNodeCulling(SceneNode* node)
+	{
 		if (node->type() != Object::ObjectType::SceneNode &&
 			node->type() != Object::ObjectType::ParticleSystem) {
 			DrawableNode* drawable = static_cast<DrawableNode*>(node);
@@ -262,6 +262,7 @@ namespace nCine
 		unsigned int numColorAttachments_;
 
 		void updateCulling(SceneNode* node);
+		static void updateNodeCulling(SceneNode* node);
 
 		friend class Application;
 		friend class ScreenViewport;
@@ -7,18 +7,15 @@ namespace nCine
 	{
 		switch (memModel) {
 			case MemoryModel::RELAXED:
-				__atomic_load_n(&value_, __ATOMIC_RELAXED);
-				return value_;
+				return __atomic_load_n(&value_, __ATOMIC_RELAXED);
 			case MemoryModel::ACQUIRE:
-				__atomic_load_n(&value_, __ATOMIC_ACQUIRE);
-				return value_;
+				return __atomic_load_n(&value_, __ATOMIC_ACQUIRE);
 			case MemoryModel::RELEASE:
 				FATAL_MSG("Incompatible memory model");
 				return 0;
 			case MemoryModel::SEQ_CST:
 			default:
-				__atomic_load_n(&value_, __ATOMIC_SEQ_CST);
-				return value_;
+				return __atomic_load_n(&value_, __ATOMIC_SEQ_CST);
 		}
 	}
 
@@ -90,18 +87,15 @@ namespace nCine
 	{
 		switch (memModel) {
 			case MemoryModel::RELAXED:
-				__atomic_load_n(&value_, __ATOMIC_RELAXED);
-				return value_;
+				return __atomic_load_n(&value_, __ATOMIC_RELAXED);
 			case MemoryModel::ACQUIRE:
-				__atomic_load_n(&value_, __ATOMIC_ACQUIRE);
-				return value_;
+				return __atomic_load_n(&value_, __ATOMIC_ACQUIRE);
 			case MemoryModel::RELEASE:
 				FATAL_MSG("Incompatible memory model");
 				return 0;
 			case MemoryModel::SEQ_CST:
 			default:
-				__atomic_load_n(&value_, __ATOMIC_SEQ_CST);
-				return value_;
+				return __atomic_load_n(&value_, __ATOMIC_SEQ_CST);
 		}
 	}
 
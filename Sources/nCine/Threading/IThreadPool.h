@@ -1,11 +1,39 @@
 #pragma once
 
 #include "IThreadCommand.h"
+#include "Atomic.h"
 
 #include <memory>
+#include <type_traits>
 
 namespace nCine
 {
+	/// Job entry point, it receives user data and a range of indices to process
+	using JobFunction = void (*)(void* userData, std::int32_t begin, std::int32_t end);
+
+	/// Job that can be scheduled on a thread pool
+	/*! Jobs are allocated from a fixed-size ring owned by the thread pool. A slot is reused only after it's released,
+	 *  which is done by `Wait()`, or as soon as the job finishes if it's detached (e.g., it has a parent), so only
+	 *  handles of jobs that are not detached can be waited for. Every job counts its unfinished children, so a parent
+	 *  job is finished only when all its children are finished too. */
+	struct alignas(64) Job
+	{
+		JobFunction Function;
+		void* UserData;
+		Job* Parent;
+		std::int32_t Begin;
+		std::int32_t End;
+		/// Number of unfinished jobs including the job itself and all its children
+		Atomic32 UnfinishedJobs;
+		/// Non-zero if the slot is not used by any job and can be claimed again
+		Atomic32 IsReleased;
+		/// Whether the slot is released as soon as the job finishes, because nobody waits for it
+		bool IsDetached;
+	};
+
+	/// Handle of a job created by a thread pool
+	using JobHandle = Job*;
+
 	/// Thread pool interface class
 	class IThreadPool
 	{
@@ -14,14 +42,114 @@ namespace nCine
 
 		/// Enqueues a command request for a worker thread
 		virtual void EnqueueCommand(std::unique_ptr<IThreadCommand>&& threadCommand) = 0;
+
+		/// Returns the number of worker threads
+		virtual std::int32_t GetWorkerCount() const = 0;
+		/// Creates a new job, it has to be scheduled with `Run()`
+		/*! If a parent is specified, it must not be finished yet and it won't finish until the new job finishes. */
+		virtual JobHandle CreateJob(JobFunction function, void* userData, std::int32_t begin = 0, std::int32_t end = 0, JobHandle parent = nullptr) = 0;
+		/// Schedules the job for execution
+		virtual void Run(JobHandle job) = 0;
+		/// Waits for the job and all its children to finish and releases it, the calling thread helps with execution in the meantime
+		virtual void Wait(JobHandle job) = 0;
+		/// Splits the range into jobs of at least `grainSize` indices, executes them in parallel and waits for them
+		virtual void ParallelFor(std::int32_t begin, std::int32_t end, std::int32_t grainSize, JobFunction function, void* userData) = 0;
+
+		/// Executes the callable for all subranges of the specified range in parallel, it's called as `func(begin, end)`
+		template<class Func>
+		void ParallelFor(std::int32_t begin, std::int32_t end, std::int32_t grainSize, Func&& func)
+		{
+			using FuncType = typename std::remove_reference<Func>::type;
+			ParallelFor(begin, end, grainSize, [](void* userData, std::int32_t from, std::int32_t to) {
+				(*static_cast<FuncType*>(userData))(from, to);
+			}, const_cast<void*>(static_cast<const void*>(&func)));
+		}
+
+		/// Initializes a job, it can be also used for jobs owned by the caller that have to outlive the job ring
+		static void InitializeJob(Job* job, JobFunction function, void* userData, std::int32_t begin, std::int32_t end, Job* parent)
+		{
+			job->Function = function;
+			job->UserData = userData;
+			job->Parent = parent;
+			job->Begin = begin;
+			job->End = end;
+			job->UnfinishedJobs.store(1);
+			job->IsReleased.store(0);
+			// Nobody waits for child jobs directly, their parent is waited for instead
+			job->IsDetached = (parent != nullptr);
+
+			if (parent != nullptr) {
+				parent->UnfinishedJobs.fetchAdd(1);
+			}
+		}
+
+	protected:
+		/// Executes the job and marks it as finished
+		static void ExecuteJob(Job* job)
+		{
+			if (job->Function != nullptr) {
+				job->Function(job->UserData, job->Begin, job->End);
+			}
+			FinishJob(job);
+		}
+
+		/// Marks the job as finished, the parent is finished too if it was the last unfinished child
+		static void FinishJob(Job* job)
+		{
+			while (job != nullptr) {
+				// Both fields must be read before the job is finished, because a finished job can be released immediately
+				Job* parent = job->Parent;
+				bool isDetached = job->IsDetached;
+				if (job->UnfinishedJobs.fetchSub(1) != 1) {
+					break;
+				}
+				if (isDetached) {
+					job->IsReleased.store(1, Atomic32::MemoryModel::RELEASE);
+				}
+				job = parent;
+			}
+		}
 	};
 
 	inline IThreadPool::~IThreadPool() { }
 
-	/// A fake thread pool which doesn't execute any commands
+	/// A fake thread pool which doesn't use any threads, jobs are executed immediately on the calling thread
 	class NullThreadPool : public IThreadPool
 	{
 	public:
+		NullThreadPool() : nextJob_(0) {}
+
+		using IThreadPool::ParallelFor;
+
 		void EnqueueCommand(std::unique_ptr<IThreadCommand>&& threadCommand) override { }
+
+		std::int32_t GetWorkerCount() const override {
+			return 0;
+		}
+
+		JobHandle CreateJob(JobFunction function, void* userData, std::int32_t begin = 0, std::int32_t end = 0, JobHandle parent = nullptr) override {
+			Job* job = &jobs_[nextJob_];
+			nextJob_ = (nextJob_ + 1) % MaxJobCount;
+			InitializeJob(job, function, userData, begin, end, parent);
+			return job;
+		}
+
+		void Run(JobHandle job) override {
+			ExecuteJob(job);
+		}
+
+		void Wait(JobHandle job) override { }
+
+		void ParallelFor(std::int32_t begin, std::int32_t end, std::int32_t grainSize, JobFunction function, void* userData) override {
+			if (begin < end) {
+				function(userData, begin, end);
+			}
+		}
+
+	private:
+		static constexpr std::int32_t MaxJobCount = 64;
+
+		Job jobs_[MaxJobCount];
+		std::int32_t nextJob_;
 	};
 }
\ No newline at end of file
@@ -5,74 +5,345 @@
 
 namespace nCine
 {
+	namespace
+	{
+		/// Pool that owns the current thread, or `nullptr` if it's not a worker thread
+		DEATH_THREAD_LOCAL ThreadPool* currentPool = nullptr;
+		/// Index of the current worker thread in its pool
+		DEATH_THREAD_LOCAL std::int32_t currentWorkerIndex = -1;
+
+		void ExecuteThreadCommand(void* userData, std::int32_t begin, std::int32_t end)
+		{
+			std::unique_ptr<IThreadCommand> threadCommand(static_cast<IThreadCommand*>(userData));
+			threadCommand->Execute();
+		}
+
+		/// Drops a job that wasn't executed before the pool was destroyed
+		void DeletePendingJob(Job* job)
+		{
+			if (job->Function == ExecuteThreadCommand) {
+				delete static_cast<IThreadCommand*>(job->UserData);
+			}
+		}
+
+		inline std::int64_t JobToValue(Job* job)
+		{
+			return (std::int64_t)reinterpret_cast<std::intptr_t>(job);
+		}
+
+		inline Job* ValueToJob(std::int64_t value)
+		{
+			return reinterpret_cast<Job*>((std::intptr_t)value);
+		}
+	}
+
+	ThreadPool::WorkStealingQueue::WorkStealingQueue()
+		: top_(0), bottom_(0)
+	{
+	}
+
+	bool ThreadPool::WorkStealingQueue::Push(Job* job)
+	{
+		std::int64_t b = bottom_.load(Atomic64::MemoryModel::RELAXED);
+		std::int64_t t = top_.load(Atomic64::MemoryModel::ACQUIRE);
+		if (b - t >= MaxJobCount) {
+			// Deque is full, a queued job would be overwritten
+			return false;
+		}
+
+		jobs_[b & (MaxJobCount - 1)].store(JobToValue(job), Atomic64::MemoryModel::RELAXED);
+		// The job must be visible before the new bottom
+		bottom_.store(b + 1, Atomic64::MemoryModel::RELEASE);
+		return true;
+	}
+
+	Job* ThreadPool::WorkStealingQueue::Pop()
+	{
+		std::int64_t b = bottom_.load(Atomic64::MemoryModel::RELAXED) - 1;
+		// Sequentially consistent store and load act as a full fence between bottom and top
+		bottom_.store(b, Atomic64::MemoryModel::SEQ_CST);
+		std::int64_t t = top_.load(Atomic64::MemoryModel::SEQ_CST);
+
+		if (t > b) {
+			// Deque is empty
+			bottom_.store(t, Atomic64::MemoryModel::RELAXED);
+			return nullptr;
+		}
+
+		Job* job = ValueToJob(jobs_[b & (MaxJobCount - 1)].load(Atomic64::MemoryModel::RELAXED));
+		if (t != b) {
+			// There's still more than one job left
+			return job;
+		}
+
+		// This is the last job, race against steal operations
+		if (!top_.cmpExchange(t + 1, t, Atomic64::MemoryModel::SEQ_CST)) {
+			job = nullptr;
+		}
+		bottom_.store(t + 1, Atomic64::MemoryModel::RELAXED);
+		return job;
+	}
+
+	Job* ThreadPool::WorkStealingQueue::Steal()
+	{
+		std::int64_t t = top_.load(Atomic64::MemoryModel::SEQ_CST);
+		std::int64_t b = bottom_.load(Atomic64::MemoryModel::SEQ_CST);
+		if (t >= b) {
+			return nullptr;
+		}
+
+		Job* job = ValueToJob(jobs_[t & (MaxJobCount - 1)].load(Atomic64::MemoryModel::RELAXED));
+		if (!top_.cmpExchange(t + 1, t, Atomic64::MemoryModel::SEQ_CST)) {
+			// Another thread stole or popped the job in the meantime
+			return nullptr;
+		}
+		return job;
+	}
+
 	ThreadPool::ThreadPool()
 		: ThreadPool(Thread::GetProcessorCount())
 	{
 	}
 
 	ThreadPool::ThreadPool(std::size_t numThreads)
-		: threads_(numThreads), numThreads_(numThreads)
+		: jobs_(std::make_unique<Job[]>(MaxJobCount)), workers_(std::make_unique<WorkerStruct[]>(numThreads)), numThreads_(numThreads),
+			sharedQueueHead_(0), sharedQueueCount_(0), shouldQuit_(false)
 	{
-		threadStruct_.queue = &queue_;
-		threadStruct_.queueMutex = &queueMutex_;
-		threadStruct_.queueCV = &queueCV_;
-		threadStruct_.shouldQuit = false;
+		for (std::int32_t i = 0; i < MaxJobCount; i++) {
+			jobs_[i].IsReleased.store(1, Atomic32::MemoryModel::RELAXED);
+		}
 
-		quitMutex_.Lock();
+		threads_.reserve(numThreads_);
 
 		for (std::size_t i = 0; i < numThreads_; i++) {
-			threads_.emplace_back(WorkerFunction, &threadStruct_);
+			workers_[i].pool = this;
+			workers_[i].index = (std::int32_t)i;
+			threads_.emplace_back(WorkerFunction, &workers_[i]);
 		}
 	}
 
 	ThreadPool::~ThreadPool()
 	{
-		threadStruct_.shouldQuit = true;
-		queueCV_.Broadcast();
+		sleepMutex_.Lock();
+		shouldQuit_ = true;
+		sleepCV_.Broadcast();
+		sleepMutex_.Unlock();
 
 		for (std::size_t i = 0; i < numThreads_; i++) {
 			threads_[i].Join();
 		}
+
+		// Jobs that weren't executed are dropped, but commands owned by them have to be deleted
+		Job* job;
+		while ((job = TryPopSharedQueue()) != nullptr) {
+			DeletePendingJob(job);
+		}
+		for (std::size_t i = 0; i < numThreads_; i++) {
+			while ((job = workers_[i].queue.Pop()) != nullptr) {
+				DeletePendingJob(job);
+			}
+		}
 	}
 
 	void ThreadPool::EnqueueCommand(std::unique_ptr<IThreadCommand>&& threadCommand)
 	{
 		ASSERT(threadCommand);
 
-		queueMutex_.Lock();
-		queue_.push_back(std::move(threadCommand));
-		queueCV_.Broadcast();
-		queueMutex_.Unlock();
+		JobHandle job = CreateJob(ExecuteThreadCommand, threadCommand.release());
+		// Nobody waits for commands, so the slot is released as soon as the command finishes
+		job->IsDetached = true;
+		Run(job);
+	}
+
+	std::int32_t ThreadPool::GetWorkerCount() const
+	{
+		return (std::int32_t)numThreads_;
+	}
+
+	JobHandle ThreadPool::CreateJob(JobFunction function, void* userData, std::int32_t begin, std::int32_t end, JobHandle parent)
+	{
+		std::int32_t workerIndex = (currentPool == this ? currentWorkerIndex : -1);
+		while (true) {
+			for (std::int32_t i = 0; i < MaxJobCount; i++) {
+				std::int32_t index = nextJob_.fetchAdd(1, Atomic32::MemoryModel::RELAXED);
+				Job* job = &jobs_[index & (MaxJobCount - 1)];
+				// A slot can be claimed only if it was released, a finished job can still be waited for
+				if (job->IsReleased.load(Atomic32::MemoryModel::RELAXED) != 0 && job->IsReleased.cmpExchange(0, 1, Atomic32::MemoryModel::ACQUIRE)) {
+					InitializeJob(job, function, userData, begin, end, parent);
+					return job;
+				}
+			}
+
+			// All slots are in use, help with execution until some job finishes
+			Job* nextJob = TryGetJob(workerIndex);
+			if (nextJob != nullptr) {
+				ExecuteJob(nextJob);
+			} else {
+				Thread::YieldExecution();
+			}
+		}
+	}
+
+	void ThreadPool::Run(JobHandle job)
+	{
+		ASSERT(job != nullptr);
+		PushJob(job);
+	}
+
+	void ThreadPool::Wait(JobHandle job)
+	{
+		ASSERT(job != nullptr);
+
+		std::int32_t workerIndex = (currentPool == this ? currentWorkerIndex : -1);
+		while (job->UnfinishedJobs.load(Atomic32::MemoryModel::ACQUIRE) > 0) {
+			// Help with execution of other jobs instead of blocking
+			Job* nextJob = TryGetJob(workerIndex);
+			if (nextJob != nullptr) {
+				ExecuteJob(nextJob);
+			} else {
+				Thread::YieldExecution();
+			}
+		}
+
+		// The job can't be accessed by anyone else now, so the slot can be reused
+		job->IsReleased.store(1, Atomic32::MemoryModel::RELEASE);
+	}
+
+	void ThreadPool::ParallelFor(std::int32_t begin, std::int32_t end, std::int32_t grainSize, JobFunction function, void* userData)
+	{
+		std::int32_t count = end - begin;
+		if (count <= 0) {
+			return;
+		}
+
+		// Create a few more jobs than workers to balance uneven workloads, but keep at least `grainSize` indices per job
+		std::int32_t maxJobs = std::max((std::int32_t)numThreads_ * 4, 1);
+		std::int32_t jobSize = std::max(std::max(grainSize, 1), (count + maxJobs - 1) / maxJobs);
+		if (jobSize >= count) {
+			function(userData, begin, end);
+			return;
+		}
+
+		Job* root = CreateJob(nullptr, nullptr);
+		for (std::int32_t i = begin + jobSize; i < end; i += jobSize) {
+			Run(CreateJob(function, userData, i, std::min(i + jobSize, end), root));
+		}
+
+		// The first range is executed directly on the calling thread
+		function(userData, begin, begin + jobSize);
+		FinishJob(root);
+		Wait(root);
+	}
+
+	void ThreadPool::PushJob(Job* job)
+	{
+		bool queued;
+		if (currentPool == this) {
+			queued = workers_[currentWorkerIndex].queue.Push(job);
+		} else {
+			sharedQueueMutex_.Lock();
+			queued = (sharedQueueCount_ < MaxJobCount);
+			if (queued) {
+				sharedQueue_[(sharedQueueHead_ + sharedQueueCount_) & (MaxJobCount - 1)] = job;
+				sharedQueueCount_++;
+			}
+			sharedQueueMutex_.Unlock();
+		}
+
+		if (!queued) {
+			// The queue is full, so the job is executed immediately on the calling thread
+			ExecuteJob(job);
+			return;
+		}
+
+		pendingJobs_.fetchAdd(1);
+		if (sleepingWorkers_.load() > 0) {
+			sleepMutex_.Lock();
+			sleepCV_.Signal();
+			sleepMutex_.Unlock();
+		}
+	}
+
+	Job* ThreadPool::TryGetJob(std::int32_t workerIndex)
+	{
+		Job* job = nullptr;
+		if (workerIndex >= 0) {
+			job = workers_[workerIndex].queue.Pop();
+		}
+
+		if (job == nullptr) {
+			job = TryPopSharedQueue();
+		}
+
+		if (job == nullptr) {
+			// Try to steal from other workers, start with the next one to spread contention
+			std::int32_t numWorkers = (std::int32_t)numThreads_;
+			for (std::int32_t i = 1; i <= numWorkers; i++) {
+				std::int32_t victim = (workerIndex + i) % numWorkers;
+				if (victim < 0) {
+					victim += numWorkers;
+				}
+				if (victim == workerIndex) {
+					continue;
+				}
+				job = workers_[victim].queue.Steal();
+				if (job != nullptr) {
+					break;
+				}
+			}
+		}
+
+		if (job != nullptr) {
+			pendingJobs_.fetchSub(1);
+		}
+		return job;
+	}
+
+	Job* ThreadPool::TryPopSharedQueue()
+	{
+		Job* job = nullptr;
+		sharedQueueMutex_.Lock();
+		if (sharedQueueCount_ > 0) {
+			job = sharedQueue_[sharedQueueHead_];
+			sharedQueueHead_ = (sharedQueueHead_ + 1) & (MaxJobCount - 1);
+			sharedQueueCount_--;
+		}
+		sharedQueueMutex_.Unlock();
+		return job;
 	}
 
 	void ThreadPool::WorkerFunction(void* arg)
 	{
-		ThreadStruct* threadStruct = static_cast<ThreadStruct*>(arg);
+		WorkerStruct* worker = static_cast<WorkerStruct*>(arg);
+		ThreadPool* pool = worker->pool;
+		currentPool = pool;
+		currentWorkerIndex = worker->index;
 
 		LOGD("Worker thread %llu is starting", Thread::GetCurrentId());
 
 		while (true) {
-			threadStruct->queueMutex->Lock();
-			while (threadStruct->queue->empty() && !threadStruct->shouldQuit) {
-				threadStruct->queueCV->Wait(*(threadStruct->queueMutex));
+			Job* job = pool->TryGetJob(worker->index);
+			if (job != nullptr) {
+				ExecuteJob(job);
+				continue;
 			}
 
-			if (threadStruct->shouldQuit) {
-				threadStruct->queueMutex->Unlock();
-				break;
+			pool->sleepMutex_.Lock();
+			pool->sleepingWorkers_.fetchAdd(1);
+			while (pool->pendingJobs_.load() <= 0 && !pool->shouldQuit_) {
+				pool->sleepCV_.Wait(pool->sleepMutex_);
 			}
+			pool->sleepingWorkers_.fetchSub(1);
+			bool shouldQuit = pool->shouldQuit_;
+			pool->sleepMutex_.Unlock();
 
-			std::unique_ptr<IThreadCommand> threadCommand = std::move(threadStruct->queue->front());
-			threadStruct->queue->pop_front();
-			threadStruct->queueMutex->Unlock();
-
-			LOGD("Worker thread %llu is executing its command", Thread::GetCurrentId());
-			threadCommand->Execute();
+			if (shouldQuit) {
+				break;
+			}
 		}
 
 		LOGD("Worker thread %llu is exiting", Thread::GetCurrentId());
 	}
-
 }
 
 #endif
\ No newline at end of file
@@ -4,8 +4,6 @@
 #include "ThreadSync.h"
 #include "Thread.h"
 
-#include <list>
-
 #include <Containers/SmallVector.h>
 
 using namespace Death::Containers;
@@ -13,6 +11,9 @@ using namespace Death::Containers;
 namespace nCine
 {
 	/// Thread pool class
+	/*! Every worker thread owns a lock-free work-stealing deque. Workers execute jobs from their own deque
+	 *  in LIFO order and steal from other workers in FIFO order when their deque is empty. Jobs scheduled
+	 *  from other threads are put into a shared queue. */
 	class ThreadPool : public IThreadPool
 	{
 	public:
@@ -22,26 +23,68 @@ namespace nCine
 		explicit ThreadPool(std::size_t numThreads);
 		~ThreadPool() override;
 
+		using IThreadPool::ParallelFor;
+
 		/// Enqueues a command request for a worker thread
 		void EnqueueCommand(std::unique_ptr<IThreadCommand>&& threadCommand) override;
 
+		std::int32_t GetWorkerCount() const override;
+		JobHandle CreateJob(JobFunction function, void* userData, std::int32_t begin = 0, std::int32_t end = 0, JobHandle parent = nullptr) override;
+		void Run(JobHandle job) override;
+		void Wait(JobHandle job) override;
+		void ParallelFor(std::int32_t begin, std::int32_t end, std::int32_t grainSize, JobFunction function, void* userData) override;
+
 	private:
-		struct ThreadStruct
+		/// Maximum number of jobs that can be alive at the same time, it must be a power of two
+		static constexpr std::int32_t MaxJobCount = 4096;
+
+		/// Fixed-size Chase-Lev deque, only the owner can push and pop, other threads can steal
+		class WorkStealingQueue
 		{
-			std::list<std::unique_ptr<IThreadCommand>>* queue;
-			Mutex* queueMutex;
-			CondVariable* queueCV;
-			bool shouldQuit;
+		public:
+			WorkStealingQueue();
+
+			/// Returns `false` if the deque is full
+			bool Push(Job* job);
+			Job* Pop();
+			Job* Steal();
+
+		private:
+			Atomic64 top_;
+			Atomic64 bottom_;
+			/// Slots are accessed concurrently by the owner and by stealing threads, so they hold job pointers atomically
+			Atomic64 jobs_[MaxJobCount];
 		};
 
-		std::list<std::unique_ptr<IThreadCommand>> queue_;
+		struct WorkerStruct
+		{
+			ThreadPool* pool;
+			std::int32_t index;
+			WorkStealingQueue queue;
+		};
+
+		std::unique_ptr<Job[]> jobs_;
+		Atomic32 nextJob_;
+		std::unique_ptr<WorkerStruct[]> workers_;
 		SmallVector<Thread, 0> threads_;
-		Mutex queueMutex_;
-		CondVariable queueCV_;
-		Mutex quitMutex_;
 		std::size_t numThreads_;
 
-		ThreadStruct threadStruct_;
+		/// Queue for jobs scheduled from threads that don't belong to the pool
+		Job* sharedQueue_[MaxJobCount];
+		std::int32_t sharedQueueHead_;
+		std::int32_t sharedQueueCount_;
+		Mutex sharedQueueMutex_;
+
+		/// Approximate number of scheduled jobs that weren't picked up yet
+		Atomic32 pendingJobs_;
+		Atomic32 sleepingWorkers_;
+		Mutex sleepMutex_;
+		CondVariable sleepCV_;
+		bool shouldQuit_;
+
+		void PushJob(Job* job);
+		Job* TryGetJob(std::int32_t workerIndex);
+		Job* TryPopSharedQueue();
 		static void WorkerFunction(void* arg);
 
 		/// Deleted copy constructor